@@ -116,14 +116,17 @@ for (my $j = 0; $j < $rangesTotal; ++$j) {
 
 	my $whatDmrg = Ci::readAnnotationFromKey(\@ciAnnotations, "dmrg");
 	my $extraCmdArgs = $sOptions."  ".findArguments($whatDmrg);
-	my $cmd = getCmd($n, $valgrind, $extraCmdArgs);
+	my $ranks = findRanks(Ci::readAnnotationFromKey(\@ciAnnotations, "mpi"));
+	my $cmd = getCmd($n, $valgrind, $extraCmdArgs, $ranks);
 
 	for (my $i = 0; $i < $totalAnnotations; ++$i) {
 		my ($ppLabel, $w) = Ci::readAnnotationFromIndex(\@ciAnnotations, $i);
 		my $x = defined($w) ? scalar(@$w) : 0;
 		next if ($x == 0);
 		print "|$n| has $x $ppLabel lines\n";
-		next if ($ppLabel eq "dmrg");
+		next if ($ppLabel eq "dmrg" or $ppLabel eq "mpi");
+		# compared by postCi.pl
+		next if ($ppLabel eq "sameEnergiesAs" or $ppLabel eq "sameObservablesAs");
 
 		if ($ppLabel eq "observe") {
 			$cmd .= runObserve($n, $w, $sOptions);
@@ -172,6 +175,16 @@ sub findArguments
 	return "";
 }
 
+# #ci mpi n runs dmrg with mpirun -np n, for builds with MPI
+sub findRanks
+{
+	my ($a) = @_;
+	return 0 unless defined($a);
+	my $n = scalar(@$a);
+	($n == 1 and $a->[0] =~ /^(\d+)$/) or die "$0: #ci mpi annotation: @$a not understood\n";
+	return $1;
+}
+
 sub runObserve
 {
 	my ($n, $what, $sOptions) = @_;
@@ -272,11 +285,12 @@ sub getDeepBatchIndex
 
 sub getCmd
 {
-	my ($n, $tool, $extraCmdArgs) = @_;
+	my ($n, $tool, $extraCmdArgs, $ranks) = @_;
 	my $valgrind = ($tool eq "") ? "" : "valgrind --tool=$tool ";
 	$valgrind .= " --callgrind-out-file=callgrind$n.out " if ($tool eq "callgrind");
+	my $mpirun = ($ranks > 0) ? "mpirun -np $ranks " : "";
 	my $inputfile = Ci::getInputFilename($n);
-	return "$valgrind./dmrg -f $inputfile $extraCmdArgs &> output$n.txt\n\n";
+	return "$mpirun$valgrind./dmrg -f $inputfile $extraCmdArgs &> output$n.txt\n\n";
 }
 
 sub createBatch
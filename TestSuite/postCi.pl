@@ -94,19 +94,22 @@ for (my $j = 0; $j < $rangesTotal; ++$j) {
 	my @ciAnnotations = Ci::getCiAnnotations($thisInput, $n);
 	my $totalAnnotations = scalar(@ciAnnotations);
 
-	my @postProcessLabels = qw(getTimeObservablesInSitu getEnergyAncilla CollectBrakets metts observe);
+	my @postProcessLabels = qw(getTimeObservablesInSitu getEnergyAncilla CollectBrakets metts observe sameEnergiesAs
+	                           sameObservablesAs);
 	my %actions = (getTimeObservablesInSitu => \&checkTimeInSituObs,
 	               getEnergyAncilla => \&checkEnergyAncillaInSitu,
 	               CollectBrakets => \&checkCollectBrakets,
 	               metts => \&checkMetts,
 	               observe => \&checkObserve,
-	               procOmegas => \&checkProcOmegas);
+	               procOmegas => \&checkProcOmegas,
+	               sameEnergiesAs => \&checkSameEnergiesAs,
+	               sameObservablesAs => \&checkSameObservablesAs);
 	for (my $i = 0; $i < $totalAnnotations; ++$i) {
 		my ($ppLabel, $w) = Ci::readAnnotationFromIndex(\@ciAnnotations, $i);
 		my $x = defined($w) ? scalar(@$w) : 0;
 		next if ($x == 0);
 		print "|$n| has $x $ppLabel lines\n";
-		if ($ppLabel eq "dmrg" || $ppLabel eq "nDollar") {
+		if ($ppLabel eq "dmrg" || $ppLabel eq "nDollar" || $ppLabel eq "mpi") {
 			print "|$n| ignoring $ppLabel label in postCi mode\n";
 			next;
 		}
@@ -203,6 +206,105 @@ sub maxEnergyDiff
 	return "$maxEdiff [out of $n]";
 }
 
+# #ci sameEnergiesAs m [tolerance [last]]
+# The energies of this run must match those of run m, in the same workdir,
+# up to tolerance (default 1e-6). With last, only the last energies of
+# both runs are compared
+sub checkSameEnergiesAs
+{
+	my ($n, $what, $workdir, $golddir) = @_;
+	my $whatN = scalar(@$what);
+	for (my $i = 0; $i < $whatN; ++$i) {
+		my @temp = split(/ +/, $what->[$i]);
+		my $m = $temp[0];
+		my $tolerance = (scalar(@temp) > 1) ? $temp[1] : 1e-6;
+		my $last = (scalar(@temp) > 2) ? $temp[2] : 0;
+		my %newValues;
+		my %otherValues;
+		procCout(\%newValues, $n, $workdir);
+		procCout(\%otherValues, $m, $workdir);
+		my $eNew = $newValues{"Energies"};
+		my $eOther = $otherValues{"Energies"};
+		if (!defined($eNew) or !defined($eOther)) {
+			print "|$n|: sameEnergiesAs $m: FAILED, energies missing\n";
+			next;
+		}
+
+		my $total = scalar(@$eNew);
+		if ($total == 0 or $total != scalar(@$eOther)) {
+			print "|$n|: sameEnergiesAs $m: FAILED, $total energies vs. ";
+			print scalar(@$eOther)."\n";
+			next;
+		}
+
+		my $first = ($last > 0 and $last < $total) ? $total - $last : 0;
+		my $maxEdiff = 0;
+		for (my $j = $first; $j < $total; ++$j) {
+			my $tmp = abs($eNew->[$j] - $eOther->[$j]);
+			$maxEdiff = $tmp if ($tmp > $maxEdiff);
+		}
+
+		my $compared = $total - $first;
+		my $result = ($maxEdiff <= $tolerance) ? "OK" : "FAILED";
+		print "|$n|: sameEnergiesAs $m: MaxEnergyDiff = $maxEdiff ";
+		print "[$compared out of $total] tolerance $tolerance $result\n";
+	}
+}
+
+# #ci sameObservablesAs m [tolerance]
+# The observe output of this run must match that of run m, in the same
+# workdir, up to tolerance (default 1e-6). The matrices are compared in the
+# order of the #ci observe lines of both runs, which may name different kets
+sub checkSameObservablesAs
+{
+	my ($n, $what, $workdir, $golddir) = @_;
+	my $whatN = scalar(@$what);
+	for (my $i = 0; $i < $whatN; ++$i) {
+		my @temp = split(/ +/, $what->[$i]);
+		my $m = $temp[0];
+		my $tolerance = (scalar(@temp) > 1) ? $temp[1] : 1e-6;
+		my @mNew = loadObserveData("$workdir/observe$n.txt");
+		my @mOther = loadObserveData("$workdir/observe$m.txt");
+		my $total = scalar(@mNew);
+		if ($total == 0 or $total != scalar(@mOther)) {
+			print "|$n|: sameObservablesAs $m: FAILED, $total matrices vs. ";
+			print scalar(@mOther)."\n";
+			next;
+		}
+
+		my $maxDiff = 0;
+		my $sameShape = 1;
+		for (my $j = 0; $j < $total; ++$j) {
+			my $dNew = $mNew[$j]->{"data"};
+			my $dOther = $mOther[$j]->{"data"};
+			if ($dNew->[0] != $dOther->[0] or $dNew->[1] != $dOther->[1]) {
+				$sameShape = 0;
+				last;
+			}
+
+			if ($mNew[$j]->{"label"} ne $mOther[$j]->{"label"}) {
+				print "|$n|: sameObservablesAs $m: ".$mNew[$j]->{"label"};
+				print " against ".$mOther[$j]->{"label"}."\n";
+			}
+
+			my $entries = $dNew->[0]*$dNew->[1];
+			for (my $k = 2; $k < 2 + $entries; ++$k) {
+				my $tmp = abs($dNew->[$k] - $dOther->[$k]);
+				$maxDiff = $tmp if ($tmp > $maxDiff);
+			}
+		}
+
+		if (!$sameShape) {
+			print "|$n|: sameObservablesAs $m: FAILED, sizes differ\n";
+			next;
+		}
+
+		my $result = ($maxDiff <= $tolerance) ? "OK" : "FAILED";
+		print "|$n|: sameObservablesAs $m: MaxDiff = $maxDiff ";
+		print "[out of $total matrices] tolerance $tolerance $result\n";
+	}
+}
+
 sub procMemcheck
 {
 	my ($n) = @_;
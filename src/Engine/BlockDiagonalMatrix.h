@@ -150,6 +150,50 @@ public:
 		io.write(data_, label1 + "/data_");
 	}
 
+	// As above, but the blocks go to records, see BlockRecords.h
+	template<typename IoOutputType, typename BlockRecordsOutType>
+	void write(PsimagLite::String label1,
+	           IoOutputType& io,
+	           BlockRecordsOutType& records) const
+	{
+		io.createGroup(label1);
+		io.write(isSquare_, label1 + "/isSquare_");
+		io.write(offsetsRows_, label1 + "/offsetRows_");
+		io.write(offsetsCols_, label1 + "/offsetCols_");
+		SizeType record = records.write(data_);
+		io.write(record, label1 + "/record");
+		io.write(records.filename(), label1 + "/records");
+	}
+
+	// Reads what write(label1, io, records) wrote; if allBlocks is false
+	// the blocks are left empty, to be read later with loadBlock
+	template<typename BlockRecordsInType>
+	void read(IoInType& io,
+	          PsimagLite::String label,
+	          const BlockRecordsInType& records,
+	          SizeType& record,
+	          bool allBlocks)
+	{
+		io.read(isSquare_, label + "/isSquare_");
+		io.read(offsetsRows_, label + "/offsetRows_");
+		io.read(offsetsCols_, label + "/offsetCols_");
+		io.read(record, label + "/record");
+		if (allBlocks) {
+			records.read(data_, record);
+			return;
+		}
+
+		data_.clear();
+		data_.resize(records.blocks(record));
+	}
+
+	template<typename BlockRecordsInType>
+	void loadBlock(SizeType i, const BlockRecordsInType& records, SizeType record)
+	{
+		assert(i < data_.size());
+		records.read(data_[i], record, i);
+	}
+
 	void setTo(ComplexOrRealType value)
 	{
 		SizeType n = data_.size();
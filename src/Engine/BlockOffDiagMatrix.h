@@ -107,6 +107,30 @@ public:
 		}
 	}
 
+	BlockOffDiagMatrix(const BlockOffDiagMatrix& other)
+	    : offsetRows_(other.offsetRows_),
+	      offsetCols_(other.offsetCols_),
+	      rows_(other.rows_),
+	      cols_(other.cols_),
+	      data_(other.data_.rows(), other.data_.cols())
+	{
+		copyBlocks(other);
+	}
+
+	BlockOffDiagMatrix& operator=(const BlockOffDiagMatrix& other)
+	{
+		if (this == &other) return *this;
+		deleteBlocks();
+		offsetRows_ = other.offsetRows_;
+		offsetCols_ = other.offsetCols_;
+		rows_ = other.rows_;
+		cols_ = other.cols_;
+		data_.clear();
+		data_.resize(other.data_.rows(), other.data_.cols());
+		copyBlocks(other);
+		return *this;
+	}
+
 	~BlockOffDiagMatrix()
 	{
 		assert(offsetRows_.size() > 0);
@@ -254,6 +278,13 @@ public:
 	}
 
 	void transform(const BlockDiagonalMatrixType& f)
+	{
+		MatrixBlockType tmp;
+		transform(f, tmp);
+	}
+
+	// tmp is scratch, and may be reused from one call to the next
+	void transform(const BlockDiagonalMatrixType& f, MatrixBlockType& tmp)
 	{
 		if (offsetCols_.size() != 0)
 			err("BlockOffDiagMatrix::transform() only for square matrix\n");
@@ -276,7 +307,8 @@ public:
 				assert(m.cols() == mRight.rows());
 				assert(m.rows() == mLeft.rows());
 
-				MatrixBlockType tmp(m.rows(), mRight.cols());
+				tmp.clear();
+				tmp.resize(m.rows(), mRight.cols());
 				// tmp = data_[ii] * mRight;
 				psimag::BLAS::GEMM('N',
 				                   'N',
@@ -332,6 +364,13 @@ public:
 		return (option) ? offsetRows_ : offsetCols_;
 	}
 
+	// block (ipatch, jpatch), or 0 if it is zero
+	const MatrixBlockType* block(SizeType ipatch, SizeType jpatch) const
+	{
+		assert(ipatch < data_.rows() && jpatch < data_.cols());
+		return data_(ipatch, jpatch);
+	}
+
 	const RealType norm2() const
 	{
 		SizeType n = data_.rows();
@@ -395,9 +434,25 @@ private:
 		err("BlockOffDiagMatrix::operator" + what + " failed\n");
 	}
 
-	BlockOffDiagMatrix(const BlockOffDiagMatrix&);
+	void copyBlocks(const BlockOffDiagMatrix& other)
+	{
+		for (SizeType i = 0; i < data_.rows(); ++i) {
+			for (SizeType j = 0; j < data_.cols(); ++j) {
+				const MatrixBlockType* m = other.data_(i, j);
+				data_(i, j) = (m) ? new MatrixBlockType(*m) : 0;
+			}
+		}
+	}
 
-	BlockOffDiagMatrix& operator=(const BlockOffDiagMatrix&);
+	void deleteBlocks()
+	{
+		for (SizeType i = 0; i < data_.rows(); ++i) {
+			for (SizeType j = 0; j < data_.cols(); ++j) {
+				delete data_(i, j);
+				data_(i, j) = 0;
+			}
+		}
+	}
 
 	VectorSizeType offsetRows_;
 	VectorSizeType offsetCols_;
@@ -0,0 +1,297 @@
+#ifndef BLOCK_RECORDS_H
+#define BLOCK_RECORDS_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "../KronUtil/MatrixDenseOrSparse.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Dmrg {
+
+// For SolverOptions=transformsBinary or transformsInFloat. Stores the blocks
+// of block diagonal matrices, like the DMRG transformations, as raw binary
+// records in a file of their own, instead of as IoNg groups. A record is
+// its index table, the number of blocks, the precision, and rows, columns
+// and offset of each block, followed by the blocks in column major order.
+// Records are identified by where they start in the file, which the IoNg
+// file keeps. BlockRecordsIn maps the file into memory, so that reading a
+// block reads that block only
+namespace BlockRecordsDetail {
+
+typedef unsigned long long int WordType;
+
+static const WordType magic = 0x31534b4c42474d44ULL; // "DMGBLKS1"
+
+// offsets are kept multiples of a word, so that blocks are aligned
+inline WordType roundUp(WordType x)
+{
+	return ((x + sizeof(WordType) - 1)/sizeof(WordType))*sizeof(WordType);
+}
+
+} // namespace BlockRecordsDetail
+
+template<typename ComplexOrRealType>
+class BlockRecordsOut {
+
+	typedef BlockRecordsDetail::WordType WordType;
+	typedef typename LowerPrecision<ComplexOrRealType>::Type LowComplexOrRealType;
+
+public:
+
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef typename PsimagLite::Vector<MatrixType>::Type VectorMatrixType;
+
+	// values are written in single precision if lowPrecision is true
+	BlockRecordsOut(PsimagLite::String filename, bool lowPrecision)
+	    : filename_(filename),
+	      fout_(filename.c_str(), std::ios::binary | std::ios::trunc),
+	      offset_(0),
+	      lowPrecision_(lowPrecision)
+	{
+		if (!fout_ || !fout_.good())
+			err("BlockRecordsOut: cannot open " + filename + "\n");
+
+		writeWord(BlockRecordsDetail::magic);
+	}
+
+	const PsimagLite::String& filename() const { return filename_; }
+
+	// returns the record, for BlockRecordsIn
+	SizeType write(const VectorMatrixType& blocks)
+	{
+		const SizeType record = offset_;
+		const SizeType n = blocks.size();
+		const SizeType scalarSize = (lowPrecision_) ? sizeof(LowComplexOrRealType)
+		                                            : sizeof(ComplexOrRealType);
+		writeWord(n);
+		writeWord((lowPrecision_) ? 1 : 0);
+		WordType dataOffset = offset_ + 3*n*sizeof(WordType);
+		for (SizeType i = 0; i < n; ++i) {
+			writeWord(blocks[i].rows());
+			writeWord(blocks[i].cols());
+			writeWord(dataOffset);
+			dataOffset += BlockRecordsDetail::roundUp(blocks[i].rows()*blocks[i].cols()*
+			                                          scalarSize);
+		}
+
+		for (SizeType i = 0; i < n; ++i) {
+			if (lowPrecision_)
+				writeLow(blocks[i]);
+			else
+				writeNative(blocks[i]);
+		}
+
+		assert(offset_ == dataOffset);
+		fout_.flush();
+		return record;
+	}
+
+private:
+
+	BlockRecordsOut(const BlockRecordsOut&);
+
+	BlockRecordsOut& operator=(const BlockRecordsOut&);
+
+	void writeWord(WordType x)
+	{
+		writeBytes(&x, sizeof(x));
+	}
+
+	void writeNative(const MatrixType& m)
+	{
+		const SizeType total = m.rows()*m.cols();
+		if (total > 0)
+			writeBytes(&(m(0, 0)), total*sizeof(ComplexOrRealType));
+		pad(total*sizeof(ComplexOrRealType));
+	}
+
+	void writeLow(const MatrixType& m)
+	{
+		typename PsimagLite::Vector<LowComplexOrRealType>::Type low(m.rows()*m.cols());
+		for (SizeType j = 0; j < m.cols(); ++j)
+			for (SizeType i = 0; i < m.rows(); ++i)
+				low[i + j*m.rows()] = LowComplexOrRealType(m(i, j));
+
+		if (low.size() > 0)
+			writeBytes(&(low[0]), low.size()*sizeof(LowComplexOrRealType));
+		pad(low.size()*sizeof(LowComplexOrRealType));
+	}
+
+	void pad(SizeType bytes)
+	{
+		const SizeType extra = BlockRecordsDetail::roundUp(bytes) - bytes;
+		if (extra == 0) return;
+		const char zeros[sizeof(WordType)] = {0};
+		writeBytes(zeros, extra);
+	}
+
+	void writeBytes(const void* ptr, SizeType bytes)
+	{
+		fout_.write(reinterpret_cast<const char*>(ptr), bytes);
+		if (!fout_)
+			err("BlockRecordsOut: cannot write to " + filename_ + "\n");
+		offset_ += bytes;
+	}
+
+	PsimagLite::String filename_;
+	std::ofstream fout_;
+	SizeType offset_;
+	bool lowPrecision_;
+}; // class BlockRecordsOut
+
+template<typename ComplexOrRealType>
+class BlockRecordsIn {
+
+	typedef BlockRecordsDetail::WordType WordType;
+	typedef typename LowerPrecision<ComplexOrRealType>::Type LowComplexOrRealType;
+	typedef std::map<PsimagLite::String, std::weak_ptr<BlockRecordsIn> > MapType;
+
+public:
+
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef typename PsimagLite::Vector<MatrixType>::Type VectorMatrixType;
+
+	explicit BlockRecordsIn(PsimagLite::String filename)
+	    : filename_(filename), fd_(-1), size_(0), data_(0)
+	{
+		fd_ = ::open(filename.c_str(), O_RDONLY);
+		if (fd_ < 0)
+			err("BlockRecordsIn: cannot open " + filename + "\n");
+
+		struct stat st;
+		if (fstat(fd_, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(WordType))) {
+			::close(fd_);
+			err("BlockRecordsIn: " + filename + " is not a records file\n");
+		}
+
+		size_ = st.st_size;
+		void* ptr = mmap(0, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+		if (ptr == MAP_FAILED) {
+			::close(fd_);
+			err("BlockRecordsIn: cannot map " + filename + "\n");
+		}
+
+		data_ = static_cast<const char*>(ptr);
+		if (word(0) != BlockRecordsDetail::magic)
+			err("BlockRecordsIn: " + filename + " is not a records file\n");
+	}
+
+	~BlockRecordsIn()
+	{
+		if (data_) munmap(const_cast<char*>(data_), size_);
+		if (fd_ >= 0) ::close(fd_);
+	}
+
+	// one mapping per file, shared by all that read it
+	static std::shared_ptr<BlockRecordsIn> open(PsimagLite::String filename)
+	{
+		static std::mutex mutex;
+		static MapType map;
+		std::lock_guard<std::mutex> guard(mutex);
+		std::shared_ptr<BlockRecordsIn> ptr = map[filename].lock();
+		if (ptr) return ptr;
+
+		ptr = std::make_shared<BlockRecordsIn>(filename);
+		map[filename] = ptr;
+		return ptr;
+	}
+
+	const PsimagLite::String& filename() const { return filename_; }
+
+	SizeType blocks(SizeType record) const { return word(record); }
+
+	SizeType rows(SizeType record, SizeType i) const
+	{
+		assert(i < blocks(record));
+		return word(record + (2 + 3*i)*sizeof(WordType));
+	}
+
+	SizeType cols(SizeType record, SizeType i) const
+	{
+		assert(i < blocks(record));
+		return word(record + (3 + 3*i)*sizeof(WordType));
+	}
+
+	// block i of record only
+	void read(MatrixType& m, SizeType record, SizeType i) const
+	{
+		const SizeType r = rows(record, i);
+		const SizeType c = cols(record, i);
+		const SizeType offset = word(record + (4 + 3*i)*sizeof(WordType));
+		const bool low = (word(record + sizeof(WordType)) != 0);
+		const SizeType scalarSize = (low) ? sizeof(LowComplexOrRealType)
+		                                  : sizeof(ComplexOrRealType);
+		if (offset + r*c*scalarSize > size_)
+			err("BlockRecordsIn: " + filename_ + " is truncated\n");
+
+		m.clear();
+		m.resize(r, c);
+		if (r*c == 0) return;
+
+		if (!low) {
+			memcpy(&(m(0, 0)), data_ + offset, r*c*scalarSize);
+			return;
+		}
+
+		const LowComplexOrRealType* ptr =
+		        reinterpret_cast<const LowComplexOrRealType*>(data_ + offset);
+		for (SizeType j = 0; j < c; ++j)
+			for (SizeType k = 0; k < r; ++k)
+				m(k, j) = ComplexOrRealType(ptr[k + j*r]);
+	}
+
+	void read(VectorMatrixType& v, SizeType record) const
+	{
+		const SizeType n = blocks(record);
+		v.resize(n);
+		for (SizeType i = 0; i < n; ++i)
+			read(v[i], record, i);
+	}
+
+private:
+
+	BlockRecordsIn(const BlockRecordsIn&);
+
+	BlockRecordsIn& operator=(const BlockRecordsIn&);
+
+	WordType word(SizeType offset) const
+	{
+		if (offset + sizeof(WordType) > size_)
+			err("BlockRecordsIn: " + filename_ + " is truncated\n");
+
+		WordType x = 0;
+		memcpy(&x, data_ + offset, sizeof(x));
+		return x;
+	}
+
+	PsimagLite::String filename_;
+	int fd_;
+	SizeType size_;
+	const char* data_;
+}; // class BlockRecordsIn
+
+// the records file of what was written at label with records, or "" if none
+template<typename IoInType>
+PsimagLite::String blockRecordsFilename(IoInType& io, PsimagLite::String label)
+{
+	PsimagLite::String filename;
+	try {
+		io.read(filename, label + "/records");
+	} catch (...) {
+		return "";
+	}
+
+	return filename;
+}
+
+} // namespace Dmrg
+
+#endif // BLOCK_RECORDS_H
@@ -3,6 +3,8 @@
 #include "BlockDiagonalMatrix.h"
 #include "BlockOffDiagMatrix.h"
 #include "ProgramGlobals.h"
+#include "Concurrency.h"
+#include <algorithm>
 
 namespace Dmrg {
 
@@ -15,6 +17,7 @@ public:
 	typedef BlockOffDiagMatrix<MatrixType> BlockOffDiagMatrixType;
 	typedef typename OperatorStorageType::value_type ComplexOrRealType;
 	typedef PsimagLite::CrsMatrix<ComplexOrRealType> SparseMatrixType;
+	typedef typename PsimagLite::Vector<MatrixType>::Type VectorMatrixType;
 
 	ChangeOfBasis()
 	{
@@ -26,6 +29,9 @@ public:
 	{
 		if (!ProgramGlobals::oldChangeOfBasis) {
 			transform_ = transform;
+			const SizeType threads = std::max(PsimagLite::Concurrency::codeSectionParams.npthreads,
+			                                  static_cast<SizeType>(1));
+			if (scratch_.size() < threads) scratch_.resize(threads);
 			return;
 		}
 
@@ -34,12 +40,14 @@ public:
 		transposeConjugate(oldTtranspose_, oldT_);
 	}
 
-	void operator()(OperatorStorageType& v) const
+	// v is left blocked; see OperatorStorage
+	// threadNum selects the scratch, so threads must use different ones
+	void operator()(OperatorStorageType& v, SizeType threadNum = 0) const
 	{
 		if (!ProgramGlobals::oldChangeOfBasis) {
-			BlockOffDiagMatrixType vBlocked(v.getCRS(), transform_.offsetsRows());
-			vBlocked.transform(transform_);
-			vBlocked.toSparse(v.getCRSNonConst());
+			assert(threadNum < scratch_.size());
+			v.toBlocked(transform_.offsetsRows());
+			v.getBlockedNonConst().transform(transform_, scratch_[threadNum]);
 			return;
 		}
 
@@ -50,13 +58,9 @@ public:
 	static void changeBasis(OperatorStorageType &v,
 	                        const BlockDiagonalMatrixType& ftransform1)
 	{
-		if (!v.justCRS())
-			err("changeBasis: operatorstorage not justCRS\n");
-
 		if (!ProgramGlobals::oldChangeOfBasis) {
-			BlockOffDiagMatrixType vBlocked(v.getCRS(), ftransform1.offsetsRows());
-			vBlocked.transform(ftransform1);
-			vBlocked.toSparse(v.getCRSNonConst());
+			v.toBlocked(ftransform1.offsetsRows());
+			v.getBlockedNonConst().transform(ftransform1);
 			return;
 		}
 
@@ -80,6 +84,9 @@ private:
 	BlockDiagonalMatrixType transform_;
 	SparseMatrixType oldT_;
 	SparseMatrixType oldTtranspose_;
+	// one matrix per thread, kept from one change of basis to the next so
+	// that its memory is reused; sized by update(...) before threads start
+	mutable VectorMatrixType scratch_;
 }; // class ChangeOfBasis
 } // namespace Dmrg
 #endif // DMRG_CHANGEOFBASIS_H
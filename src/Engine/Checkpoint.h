@@ -122,11 +122,15 @@ public:
 	    systemStack_(parameters_.options.find("shrinkStacksOnDisk") != PsimagLite::String::npos,
 	                 parameters_.filename,
 	                 "system",
-	                 isObserveCode),
+	                 isObserveCode,
+	                 parameters_.options.find("shrinkStacksAsyncIo") != PsimagLite::String::npos,
+	                 stackMemoryBudget(parameters_)),
 	    envStack_(systemStack_.onDisk(),
 	              parameters_.filename,
 	              "environ",
-	              isObserveCode),
+	              isObserveCode,
+	              parameters_.options.find("shrinkStacksAsyncIo") != PsimagLite::String::npos,
+	              stackMemoryBudget(parameters_)),
 	    progress_("Checkpoint"),
 	    energyFromFile_(0.0),
 	    dummyBwo_("dummy")
@@ -291,6 +295,12 @@ private:
 
 	Checkpoint& operator=(const Checkpoint&);
 
+	// in bytes, for each of the two stacks
+	static SizeType stackMemoryBudget(const ParametersType& parameters)
+	{
+		return parameters.shrinkStacksMemoryBudget*512*1024;
+	}
+
 	void checkFiniteLoops(SizeType totalSites,
 	                      SizeType hilbertOneSite,
 	                      InputValidatorType& ioIn) const
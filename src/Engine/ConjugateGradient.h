@@ -83,6 +83,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Matrix.h"
 #include "Vector.h"
 #include "ProgressIndicator.h"
+#include <algorithm>
+#include <cassert>
 
 namespace Dmrg {
 
@@ -90,6 +92,7 @@ template<typename MatrixType>
 class	ConjugateGradient {
 	typedef typename MatrixType::value_type FieldType;
 	typedef typename PsimagLite::Vector<FieldType>::Type VectorType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
 	typedef typename PsimagLite::Real<FieldType>::Type RealType;
 
 public:
@@ -141,6 +144,79 @@ public:
 		progress_.printline(msg2,std::cout);
 	}
 
+	// Several right hand sides with the same A, as independent recurrences
+	// in lockstep, so that each step applies A to all search directions
+	// with one A.matrixMatrixProduct. xs has the initial solutions
+	void operator()(VectorVectorType& xs,
+	                const MatrixType& A,
+	                const VectorVectorType& bs) const
+	{
+		const SizeType nrhs = bs.size();
+		assert(xs.size() == nrhs);
+		VectorVectorType ps(nrhs);
+		VectorVectorType rs(nrhs);
+		VectorVectorType tmps;
+		multiply(tmps, A, xs);
+		for (SizeType x = 0; x < nrhs; ++x) {
+			rs[x].resize(bs[x].size());
+			for (SizeType i = 0; i < rs[x].size(); ++i)
+				rs[x][i] = bs[x][i] - tmps[x][i];
+			ps[x] = rs[x];
+		}
+
+		typename PsimagLite::Vector<bool>::Type done(nrhs, false);
+		for (SizeType x = 0; x < nrhs; ++x) {
+			if (PsimagLite::norm(rs[x]) >= eps_) continue;
+			done[x] = true;
+			std::fill(ps[x].begin(), ps[x].end(), 0.0);
+		}
+
+		SizeType k = 0;
+		while (k < max_) {
+			multiply(tmps, A, ps);
+			bool allDone = true;
+			for (SizeType x = 0; x < nrhs; ++x) {
+				if (done[x]) continue;
+				FieldType scalarrprev = scalarProduct(rs[x], rs[x]);
+				FieldType val = scalarrprev/scalarProduct(ps[x], tmps[x]);
+				for (SizeType i = 0; i < xs[x].size(); ++i) {
+					xs[x][i] += val*ps[x][i];
+					rs[x][i] -= val*tmps[x][i];
+				}
+
+				if (PsimagLite::norm(rs[x]) < eps_) {
+					done[x] = true;
+					// nothing more to apply A to
+					std::fill(ps[x].begin(), ps[x].end(), 0.0);
+					continue;
+				}
+
+				allDone = false;
+				val = scalarProduct(rs[x], rs[x])/scalarrprev;
+				for (SizeType i = 0; i < ps[x].size(); ++i)
+					ps[x][i] = rs[x][i] + val*ps[x][i];
+			}
+
+			if (allDone) break;
+			k++;
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"Finished "<<nrhs<<" right hand sides after "<<k<<" steps out of "<<max_;
+		msg<<" requested eps= "<<eps_;
+		RealType finalEps = 0;
+		for (SizeType x = 0; x < nrhs; ++x)
+			finalEps = std::max(finalEps, PsimagLite::norm(rs[x]));
+		msg<<" actual eps= "<<finalEps;
+		progress_.printline(msg,std::cout);
+
+		if (finalEps <= eps_) return;
+
+		PsimagLite::OstringStream msg2;
+		msg2<<"WARNING: actual eps "<<finalEps<<" greater than requested eps= "<<eps_;
+		progress_.printline(msg2,std::cout);
+	}
+
 private:
 
 	FieldType scalarProduct(const VectorType& v1,const VectorType& v2) const
@@ -157,6 +233,17 @@ private:
 		return y;
 	}
 
+	void multiply(VectorVectorType& ys, const MatrixType& A, const VectorVectorType& vs) const
+	{
+		ys.resize(vs.size());
+		for (SizeType x = 0; x < vs.size(); ++x) {
+			ys[x].resize(A.rows());
+			std::fill(ys[x].begin(), ys[x].end(), 0.0);
+		}
+
+		A.matrixMatrixProduct(ys, vs);
+	}
+
 	PsimagLite::ProgressIndicator progress_;
 	SizeType max_;
 	RealType eps_;
@@ -87,6 +87,7 @@ class	CorrectionVectorFunction {
 
 	typedef typename MatrixType::value_type FieldType;
 	typedef typename PsimagLite::Vector<FieldType>::Type VectorType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
 	typedef typename PsimagLite::Real<FieldType>::Type RealType;
 
 	class InternalMatrix {
@@ -123,6 +124,26 @@ class	CorrectionVectorFunction {
 			x /= (-eta);
 		}
 
+		// the same for several vectors, with H applied to all at once
+		void matrixMatrixProduct(VectorVectorType& xs, const VectorVectorType& ys) const
+		{
+			RealType eta = info_.eta();
+			RealType omegaMinusE0 = info_.omega().second + E0_;
+			const SizeType n = ys.size();
+			VectorVectorType xTmp(n, VectorType(m_.rows(), 0.0));
+			m_.matrixMatrixProduct(xTmp, ys); // xTmp = Hy
+			VectorVectorType x2(n, VectorType(m_.rows(), 0.0));
+			m_.matrixMatrixProduct(x2, xTmp); // x2 = H^2 y
+			const RealType f1 = (-2.0);
+			for (SizeType v = 0; v < n; ++v) {
+				for (SizeType i = 0; i < xs[v].size(); ++i)
+					xs[v][i] = x2[v][i] + f1*omegaMinusE0*xTmp[v][i] +
+					        (omegaMinusE0*omegaMinusE0 + eta*eta)*ys[v][i];
+
+				xs[v] /= (-eta);
+			}
+		}
+
 	private:
 
 		const MatrixType& m_;
@@ -146,6 +167,18 @@ public:
 		cg_(result,im_,sv);
 	}
 
+	// one solution per right hand side
+	void getXi(VectorVectorType& results, const VectorVectorType& svs) const
+	{
+		results.resize(svs.size());
+		for (SizeType x = 0; x < svs.size(); ++x) {
+			results[x].resize(svs[x].size());
+			std::fill(results[x].begin(), results[x].end(), 0.0);
+		}
+
+		cg_(results, im_, svs);
+	}
+
 private:
 
 	InternalMatrix im_;
@@ -138,9 +138,11 @@ public:
 	TridiagRixsStaticType;
 	typedef typename ParallelTriDiagType::MatrixComplexOrRealType MatrixComplexOrRealType;
 	typedef typename ParallelTriDiagType::VectorMatrixFieldType VectorMatrixFieldType;
+	typedef typename ParallelTriDiagType::VectorVectorType VectorVectorType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename PsimagLite::Vector<VectorRealType>::Type VectorVectorRealType;
 	typedef typename ModelType::InputValidatorType InputValidatorType;
+	typedef typename PsimagLite::Vector<VectorWithOffsetType>::Type VectorVectorWithOffsetType;
 
 	class CalcR {
 
@@ -159,8 +161,9 @@ public:
 
 			Action(const TargetParamsType& tstStruct,
 			       RealType E0,
-			       const VectorRealType& eigs)
-			    : tstStruct_(tstStruct),E0_(E0),eigs_(eigs)
+			       const VectorRealType& eigs,
+			       RealType omega)
+			    : tstStruct_(tstStruct),E0_(E0),eigs_(eigs),omega_(omega)
 			{}
 
 			RealType operator()(SizeType k) const
@@ -186,7 +189,7 @@ public:
 			RealType actionWhenReal(SizeType k) const
 			{
 				RealType sign = (tstStruct_.type() == 0) ? -1.0 : 1.0;
-				RealType part1 =  (eigs_[k] - E0_)*sign + tstStruct_.omega().second;
+				RealType part1 =  (eigs_[k] - E0_)*sign + omega_;
 				RealType denom = part1*part1 + tstStruct_.eta()*tstStruct_.eta();
 				return (action_ == ACTION_IMAG) ? tstStruct_.eta()/denom :
 				                                  -part1/denom;
@@ -195,7 +198,7 @@ public:
 			RealType actionWhenMatsubara(SizeType k) const
 			{
 				RealType sign = (tstStruct_.type() == 0) ? -1.0 : 1.0;
-				RealType wn = tstStruct_.omega().second;
+				RealType wn = omega_;
 				RealType part1 =  (eigs_[k] - E0_)*sign;
 				RealType denom = part1*part1 + wn*wn;
 				return (action_ == ACTION_IMAG) ? wn/denom : -part1 / denom;
@@ -204,6 +207,7 @@ public:
 			const TargetParamsType& tstStruct_;
 			RealType E0_;
 			const VectorRealType& eigs_;
+			RealType omega_;
 			mutable ActionEnum action_;
 		};
 
@@ -214,7 +218,14 @@ public:
 		CalcR(const TargetParamsType& tstStruct,
 		      RealType E0,
 		      const VectorRealType& eigs)
-		    : action_(tstStruct,E0,eigs)
+		    : action_(tstStruct,E0,eigs,tstStruct.omega().second)
+		{}
+
+		CalcR(const TargetParamsType& tstStruct,
+		      RealType E0,
+		      const VectorRealType& eigs,
+		      RealType omega)
+		    : action_(tstStruct,E0,eigs,omega)
 		{}
 
 		const Action& imag() const
@@ -264,6 +275,11 @@ public:
 
 		triDiag(phi,T,V,steps);
 
+		// tridiagonal matrices of sectors whose Lanczos vectors were not stored
+		VectorMatrixFieldType ab(phi.sectors());
+		for (SizeType ii = 0; ii < phi.sectors(); ++ii)
+			if (V[ii].cols() == 0) ab[ii] = T[ii];
+
 		VectorVectorRealType eigs(phi.sectors());
 
 		for (SizeType ii = 0;ii < phi.sectors(); ++ii)
@@ -281,7 +297,7 @@ public:
 			VectorType xi(sv.size(),0),xr(sv.size(),0);
 
 			if (tstStruct_.algorithm() == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) {
-				computeXiAndXrKrylov(xi,xr,phi,i0,V[i],T[i],eigs[i],steps[i]);
+				computeXiAndXrKrylov(xi,xr,phi,i0,V[i],T[i],ab[i],eigs[i],steps[i]);
 			} else {
 				computeXiAndXrIndirect(xi,xr,sv,p);
 			}
@@ -294,11 +310,64 @@ public:
 		weightForContinuedFraction_ = PsimagLite::real(phi*phi);
 	}
 
+	// Several frequencies from one tridiagonalization of tv0, Krylov only.
+	// On output tvs[2*j] is xi and tvs[2*j + 1] is xr for omegas[j]
+	void calcDynVectors(const VectorWithOffsetType& tv0,
+	                    const VectorRealType& omegas,
+	                    VectorVectorWithOffsetType& tvs)
+	{
+		if (tstStruct_.algorithm() != TargetParamsType::BaseType::AlgorithmEnum::KRYLOV)
+			err("CorrectionVectorSkeleton: many omegas at once only with Krylov\n");
+
+		const VectorWithOffsetType& phi = tv0;
+		const SizeType n = omegas.size();
+		tvs.resize(2*n);
+		for (SizeType x = 0; x < 2*n; ++x)
+			tvs[x] = phi;
+
+		VectorMatrixFieldType V(phi.sectors());
+		VectorMatrixFieldType T(phi.sectors());
+
+		VectorSizeType steps(phi.sectors());
+
+		triDiag(phi,T,V,steps);
+
+		// tridiagonal matrices of sectors whose Lanczos vectors were not stored
+		VectorMatrixFieldType ab(phi.sectors());
+		for (SizeType ii = 0; ii < phi.sectors(); ++ii)
+			if (V[ii].cols() == 0) ab[ii] = T[ii];
+
+		VectorVectorRealType eigs(phi.sectors());
+
+		for (SizeType ii = 0;ii < phi.sectors(); ++ii)
+			PsimagLite::diag(T[ii],eigs[ii],'V');
+
+		for (SizeType i = 0; i < phi.sectors(); ++i) {
+			SizeType i0 = phi.sector(i);
+			VectorVectorType ys;
+			computeXiAndXrKrylovMulti(ys,phi,i0,V[i],T[i],ab[i],eigs[i],steps[i],omegas);
+			for (SizeType x = 0; x < 2*n; ++x)
+				tvs[x].setDataInSector(ys[x],i0);
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"Correction vectors for "<<n<<" omegas from one Krylov space";
+		progress_.printline(msg, std::cout);
+
+		weightForContinuedFraction_ = PsimagLite::real(phi*phi);
+	}
+
 	void calcDynVectors(const VectorWithOffsetType& tv0,
 	                    const VectorWithOffsetType& tv1,
 	                    VectorWithOffsetType& tv2,
 	                    VectorWithOffsetType& tv3)
 	{
+		if (tstStruct_.algorithm() == TargetParamsType::BaseType::AlgorithmEnum::CONJUGATE_GRADIENT &&
+		        sameSectors(tv0, tv1)) {
+			calcDynVectorsIndirect(tv0, tv1, tv2, tv3);
+			return;
+		}
+
 		VectorWithOffsetType tv4;
 		calcDynVectors(tv0,tv4,tv2);
 		VectorWithOffsetType tv5;
@@ -309,6 +378,70 @@ public:
 
 private:
 
+	static bool sameSectors(const VectorWithOffsetType& tv0, const VectorWithOffsetType& tv1)
+	{
+		if (tv0.sectors() != tv1.sectors()) return false;
+		for (SizeType i = 0; i < tv0.sectors(); ++i)
+			if (tv0.sector(i) != tv1.sector(i)) return false;
+		return true;
+	}
+
+	// As the two calls to calcDynVectors above, but each sector solves
+	// for both right hand sides together, so that every product with H
+	// is a matrixMatrixProduct with two vectors
+	void calcDynVectorsIndirect(const VectorWithOffsetType& tv0,
+	                            const VectorWithOffsetType& tv1,
+	                            VectorWithOffsetType& tv2,
+	                            VectorWithOffsetType& tv3)
+	{
+		if (tstStruct_.omega().first != PsimagLite::FREQ_REAL)
+			throw PsimagLite::RuntimeError("Matsubara only with KRYLOV\n");
+
+		tv2 = tv3 = tv0;
+		for (SizeType i = 0; i < tv0.sectors(); ++i) {
+			SizeType i0 = tv0.sector(i);
+			VectorVectorType svs(2);
+			tv0.extract(svs[0], i0);
+			tv1.extract(svs[1], i0);
+
+			SizeType p = lrs_.super().findPartitionNumber(tv0.offset(i0));
+			RealType fakeTime = 0;
+			typename ModelType::HamiltonianConnectionType hc(p,
+			                                                 lrs_,
+			                                                 model_.geometry(),
+			                                                 ModelType::modelLinks(),
+			                                                 fakeTime,
+			                                                 0);
+			LanczosMatrixType h(model_, hc);
+			RealType E0 = energy_;
+			CorrectionVectorFunctionType cvft(h,tstStruct_,E0);
+
+			VectorVectorType xis;
+			cvft.getXi(xis, svs);
+
+			VectorVectorType xrs(2, VectorType(svs[0].size(), 0.0));
+			h.matrixMatrixProduct(xrs, xis);
+			const RealType omegaPlusE0 = tstStruct_.omega().second + E0;
+			for (SizeType x = 0; x < 2; ++x) {
+				xrs[x] -= omegaPlusE0*xis[x];
+				xrs[x] /= tstStruct_.eta();
+			}
+
+			// xr0 + xi1 and xr1 - xi0
+			VectorType v2 = xrs[0];
+			VectorType v3 = xrs[1];
+			for (SizeType j = 0; j < v2.size(); ++j) {
+				v2[j] += xis[1][j];
+				v3[j] -= xis[0][j];
+			}
+
+			tv2.setDataInSector(v2, i0);
+			tv3.setDataInSector(v3, i0);
+		}
+
+		weightForContinuedFraction_ = PsimagLite::real(tv1*tv1);
+	}
+
 	void computeXiAndXrIndirect(VectorType& xi,
 	                            VectorType& xr,
 	                            const VectorType& sv,
@@ -342,13 +475,25 @@ private:
 	                          SizeType i0,
 	                          const MatrixComplexOrRealType& V,
 	                          const MatrixComplexOrRealType& T,
+	                          const MatrixComplexOrRealType& ab,
 	                          const VectorRealType& eigs,
 	                          SizeType steps)
 	{
 		SizeType n2 = steps;
 		SizeType n = V.n_row();
+		const bool twoPass = (V.n_col() == 0);
 		if (T.n_col()!=T.n_row()) throw PsimagLite::RuntimeError("T is not square\n");
-		if (V.n_col()!=T.n_col()) throw PsimagLite::RuntimeError("V is not nxn2\n");
+		if (!twoPass && V.n_col()!=T.n_col())
+			throw PsimagLite::RuntimeError("V is not nxn2\n");
+
+		if (twoPass) {
+			VectorVectorType ys;
+			VectorRealType omegas(1, tstStruct_.omega().second);
+			computeXiAndXrKrylovMulti(ys, phi, i0, V, T, ab, eigs, steps, omegas);
+			xi = ys[0];
+			xr = ys[1];
+			return;
+		}
 
 		ComplexOrRealType zone = 1.0;
 		ComplexOrRealType zzero = 0.0;
@@ -372,15 +517,86 @@ private:
 		psimag::BLAS::GEMV('N',n,n2,zone,&(V(0,0)),n,&(tmp[0]),1,zzero,&(xr[0]),1);
 	}
 
+	// ys[2*j] is xi and ys[2*j + 1] is xr for omegas[j]. The Lanczos vectors
+	// are used once for all omegas, or regenerated once if they were not stored
+	// (see ParallelTriDiag::lanczosVectorsTimes)
+	void computeXiAndXrKrylovMulti(VectorVectorType& ys,
+	                               const VectorWithOffsetType& phi,
+	                               SizeType i0,
+	                               const MatrixComplexOrRealType& V,
+	                               const MatrixComplexOrRealType& T,
+	                               const MatrixComplexOrRealType& ab,
+	                               const VectorRealType& eigs,
+	                               SizeType steps,
+	                               const VectorRealType& omegas)
+	{
+		SizeType n2 = steps;
+		RealType fakeTime = 0;
+		ComplexOrRealType zone = 1.0;
+		ComplexOrRealType zzero = 0.0;
+		const bool twoPass = (V.n_col() == 0);
+
+		VectorType vTimesPhi(krylovHelper_.vTimesPhiSize(n2));
+		if (twoPass) {
+			VectorVectorType none;
+			VectorVectorType noneOut;
+			ParallelTriDiagType::lanczosVectorsTimes(noneOut,
+			                                         none,
+			                                         vTimesPhi,
+			                                         ab,
+			                                         phi,
+			                                         i0,
+			                                         lrs_,
+			                                         fakeTime,
+			                                         model_);
+		} else {
+			for (SizeType kprime = 0; kprime < vTimesPhi.size(); ++kprime)
+				vTimesPhi[kprime] = KrylovHelperType::calcVTimesPhi(kprime, V, phi, i0);
+		}
+
+		const SizeType n = omegas.size();
+		VectorVectorType xs(2*n);
+		VectorType r(n2);
+		for (SizeType j = 0; j < n; ++j) {
+			CalcR what(tstStruct_, energy_, eigs, omegas[j]);
+
+			krylovHelper_.calcR(r, what.imag(), T, vTimesPhi, n2);
+			xs[2*j].resize(n2);
+			psimag::BLAS::GEMV('N',n2,n2,zone,&(T(0,0)),n2,&(r[0]),1,zzero,&(xs[2*j][0]),1);
+
+			krylovHelper_.calcR(r, what.real(), T, vTimesPhi, n2);
+			xs[2*j + 1].resize(n2);
+			psimag::BLAS::GEMV('N',n2,n2,zone,&(T(0,0)),n2,&(r[0]),1,zzero,&(xs[2*j + 1][0]),1);
+		}
+
+		if (twoPass) {
+			VectorType noVtimesPhi;
+			ParallelTriDiagType::lanczosVectorsTimes(ys,
+			                                         xs,
+			                                         noVtimesPhi,
+			                                         ab,
+			                                         phi,
+			                                         i0,
+			                                         lrs_,
+			                                         fakeTime,
+			                                         model_);
+			return;
+		}
+
+		SizeType nrows = V.n_row();
+		ys.resize(2*n);
+		for (SizeType x = 0; x < 2*n; ++x) {
+			ys[x].resize(nrows);
+			psimag::BLAS::GEMV('N',nrows,n2,zone,&(V(0,0)),nrows,&(xs[x][0]),1,zzero,&(ys[x][0]),1);
+		}
+	}
+
 	void triDiag(const VectorWithOffsetType& phi,
 	             VectorMatrixFieldType& T,
 	             VectorMatrixFieldType& V,
 	             VectorSizeType& steps)
 	{
 		RealType fakeTime = 0;
-		typedef PsimagLite::NoPthreadsNg<ParallelTriDiagType> ParallelizerType;
-		ParallelizerType threadedTriDiag(PsimagLite::CodeSectionParams(1));
-
 		ParallelTriDiagType helperTriDiag(phi,
 		                                  T,
 		                                  V,
@@ -390,7 +606,7 @@ private:
 		                                  model_,
 		                                  ioIn_);
 
-		threadedTriDiag.loopCreate(helperTriDiag);
+		helperTriDiag.loopCreate();
 	}
 
 	RealType dynWeightOf(VectorType& v,const VectorType& w) const
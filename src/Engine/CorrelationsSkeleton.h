@@ -146,6 +146,28 @@ public:
 		}
 	}
 
+	// Continues growDirectly(O, ..., nsFrom, true) up to ns, so that
+	// the result is the same as that of growDirectly(O, ..., ns, true)
+	// Use this to reuse the growth of an operator at site i for several ns
+	void growDirectlyFrom(SparseMatrixType& O,
+	                      SizeType i,
+	                      ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	                      SizeType nsFrom,
+	                      SizeType ns) const
+	{
+		int nt=i-1;
+		if (nt<0) nt=0;
+
+		SizeType start = (nsFrom > SizeType(nt)) ? nsFrom : nt;
+		for (SizeType s = start; s < ns; ++s) {
+			const GrowDirection growOption = growthDirection(s, nt, i, s);
+			SparseMatrixType Onew(helper_.cols(s),helper_.cols(s));
+
+			fluffUp(Onew, O, fermionicSign, growOption, false, s);
+			helper_.transform(O, Onew, s);
+		}
+	}
+
 	GrowDirection growthDirection(SizeType s,
 	                              int nt,
 	                              SizeType i,
@@ -102,13 +102,22 @@ public:
 	struct Params {
 
 		Params(bool u, ProgramGlobals::DirectionEnum d, bool de, bool enablePersistentSvd_)
-		    : useSvd(u), direction(d), debug(de), enablePersistentSvd(enablePersistentSvd_)
+		    : useSvd(u),
+		      direction(d),
+		      debug(de),
+		      enablePersistentSvd(enablePersistentSvd_),
+		      partialSvd(false),
+		      keptStates(0),
+		      tolerance(-1)
 		{}
 
 		bool useSvd;
 		ProgramGlobals::DirectionEnum direction;
 		bool debug;
 		bool enablePersistentSvd;
+		bool partialSvd; // only leading singular vectors, see PartialSvd.h
+		SizeType keptStates;
+		RealType tolerance;
 	};
 
 	typedef typename BlockDiagonalMatrixType::BuildingBlockType BuildingBlockType;
@@ -120,6 +129,9 @@ public:
 
 	virtual void diag(typename PsimagLite::Vector<RealType>::Type&, char) = 0;
 
+	// discarded weight not in the eigenvalues given by diag
+	virtual RealType uncomputedWeight() const { return 0; }
+
 	virtual const typename PsimagLite::Vector<MatrixType>::Type& vts() const
 	{
 		return vtsEmpty_;
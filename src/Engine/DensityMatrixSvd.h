@@ -77,7 +77,11 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Concurrency.h"
 #include "MatrixVectorKron/GenIjPatch.h"
 #include "PersistentSvd.h"
+#include "PartialSvd.h"
 #include "Svd.h"
+#include "ProgressIndicator.h"
+#include <algorithm>
+#include <functional>
 
 namespace Dmrg {
 
@@ -360,22 +364,73 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 		ParallelSvd(BlockDiagonalMatrixType& blockDiagonalMatrix,
 		            GroupsStructType& allTargets,
 		            VectorRealType& eigs,
-		            PersistentSvdType& additionalStorage)
+		            VectorRealType& residuals,
+		            PersistentSvdType& additionalStorage,
+		            const ParamsType& params)
 		    : blockDiagonalMatrix_(blockDiagonalMatrix),
 		      allTargets_(allTargets),
 		      eigs_(eigs),
-		      persistentSvd_(additionalStorage)
+		      residuals_(residuals),
+		      persistentSvd_(additionalStorage),
+		      params_(params)
 		{
 			SizeType oneSide = allTargets.basis().size();
 			eigs_.resize(oneSide);
 			std::fill(eigs_.begin(), eigs_.end(), 0.0);
+			residuals_.resize(blockDiagonalMatrix.blocks());
+			std::fill(residuals_.begin(), residuals_.end(), -1.0);
 		}
 
 		void doTask(SizeType ipatch, SizeType)
 		{
 			SizeType igroup = allTargets_.groupFromIndex(ipatch);
+			if (params_.partialSvd && !params_.enablePersistentSvd && partialSvd(igroup))
+				return;
+
+			fullSvd(igroup);
+		}
+
+		// the uncomputed columns get zero eigenvalues, and their weight
+		// goes to residuals_[igroup]; m is left as it was, in case
+		// fullSvd is needed later
+		bool partialSvd(SizeType igroup)
+		{
+			const MatrixType& m = allTargets_.matrix(igroup);
+			const BasisType& basis = allTargets_.basis();
+			SizeType offset = basis.partition(igroup);
+			SizeType partSize = basis.partition(igroup + 1) - offset;
+
+			PartialSvd<ComplexOrRealType> partialSvd(params_.keptStates,
+			                                         params_.tolerance,
+			                                         seed_ + igroup);
+			MatrixType u;
+			VectorRealType eigsPartial;
+			RealType residual = 0;
+			if (!partialSvd(u, eigsPartial, residual, m)) return false;
+
+			assert(u.rows() == partSize && u.rows() == u.cols());
+			blockDiagonalMatrix_.setBlock(igroup, offset, u);
+			assert(eigsPartial.size() <= partSize);
+			assert(partSize + offset <= eigs_.size());
+			for (SizeType i = 0; i < eigsPartial.size(); ++i)
+				eigs_[i + offset] = eigsPartial[i];
+			for (SizeType i = eigsPartial.size(); i < partSize; ++i)
+				eigs_[i + offset] = 0.0;
+
+			residuals_[igroup] = residual;
+			return true;
+		}
+
+		void fullSvd(SizeType igroup)
+		{
 			MatrixType& m = allTargets_.matrix(igroup);
 
+			const BasisType& basis = allTargets_.basis();
+			SizeType offset = basis.partition(igroup);
+			SizeType partSize = basis.partition(igroup + 1) - offset;
+
+			residuals_[igroup] = -1.0;
+
 			MatrixType& vt = persistentSvd_.vts(igroup);
 			VectorRealType& eigsOnePatch = persistentSvd_.s(igroup);
 
@@ -383,9 +438,6 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 			svd('A', m, eigsOnePatch, vt);
 
 			persistentSvd_.qns(igroup) = allTargets_.basis().qnEx(igroup);
-			const BasisType& basis = allTargets_.basis();
-			SizeType offset = basis.partition(igroup);
-			SizeType partSize = basis.partition(igroup + 1) - offset;
 			assert(m.rows() == partSize);
 			assert(m.rows() == m.cols());
 			blockDiagonalMatrix_.setBlock(igroup, offset, m);
@@ -409,7 +461,10 @@ class DensityMatrixSvd : public DensityMatrixBase<TargetingType> {
 		BlockDiagonalMatrixType& blockDiagonalMatrix_;
 		GroupsStructType& allTargets_;
 		VectorRealType& eigs_;
+		VectorRealType& residuals_;
 		PersistentSvdType persistentSvd_;
+		const ParamsType& params_;
+		static const SizeType seed_ = 1234567;
 	};
 
 public:
@@ -421,7 +476,8 @@ public:
 	      params_(p),
 	      allTargets_(lrs, p.direction),
 	      data_(allTargets_.basis()),
-	      persistentSvd_(data_.blocks())
+	      persistentSvd_(data_.blocks()),
+	      progress_("DensityMatrixSvd")
 	{
 		PsimagLite::Profiling profiling("DensityMatrixSvdCtor", std::cout);
 		SizeType oneOrZero = (target.includeGroundStage()) ? 1 : 0;
@@ -477,8 +533,11 @@ public:
 		ParallelSvd parallelSvd(data_,
 		                        allTargets_,
 		                        eigs,
-		                        persistentSvd_);
+		                        residuals_,
+		                        persistentSvd_,
+		                        params_);
 		threaded.loopCreate(parallelSvd);
+		redoPartialSvds(parallelSvd, eigs);
 		for (SizeType i = 0; i < data_.blocks(); ++i) {
 			SizeType n = data_(i).rows();
 			if (n > 0) continue;
@@ -496,6 +555,15 @@ public:
 			persistentSvd_.clear();
 	}
 
+	// weight of the states that the partial SVDs did not compute
+	RealType uncomputedWeight() const
+	{
+		RealType sum = 0;
+		for (SizeType i = 0; i < residuals_.size(); ++i)
+			if (residuals_[i] > 0) sum += residuals_[i];
+		return sum;
+	}
+
 	// needed for WFT
 	const typename PsimagLite::Vector<MatrixType>::Type& vts() const
 	{
@@ -528,6 +596,39 @@ public:
 
 private:
 
+	// A group whose uncomputed states could weigh as much as the
+	// smallest state that will be kept gets a full SVD instead
+	void redoPartialSvds(ParallelSvd& parallelSvd, VectorRealType& eigs)
+	{
+		SizeType n = residuals_.size();
+		bool anyPartial = false;
+		for (SizeType i = 0; i < n; ++i)
+			if (residuals_[i] >= 0) anyPartial = true;
+
+		if (!anyPartial) return;
+
+		VectorRealType sorted = eigs;
+		std::sort(sorted.begin(), sorted.end(), std::greater<RealType>());
+		SizeType kept = params_.keptStates;
+		RealType smallestKept = (kept > 0 && kept <= sorted.size()) ? sorted[kept - 1]
+		                                                            : 0;
+
+		SizeType redone = 0;
+		for (SizeType i = 0; i < n; ++i) {
+			if (residuals_[i] < 0) continue;
+			if (residuals_[i] == 0 || residuals_[i] < smallestKept) continue;
+			parallelSvd.fullSvd(i);
+			++redone;
+		}
+
+		if (redone == 0) return;
+
+		PsimagLite::OstringStream msg;
+		msg<<"PartialSvd: "<<redone<<" groups had too much weight left out, ";
+		msg<<"did full SVD for them";
+		progress_.printline(msg, std::cout);
+	}
+
 	void addThisTarget(SizeType x,
 	                   const TargetingType& target)
 
@@ -570,6 +671,8 @@ private:
 	GroupsStructType allTargets_;
 	BlockDiagonalMatrixType data_;
 	typename ParallelSvd::PersistentSvdType persistentSvd_;
+	VectorRealType residuals_;
+	ProgressIndicatorType progress_;
 }; // class DensityMatrixSvd
 
 } // namespace Dmrg
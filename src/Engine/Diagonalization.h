@@ -83,9 +83,13 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgramGlobals.h"
 #include "LanczosSolver.h"
 #include "DavidsonSolver.h"
+#include "PreconditionedDavidson.h"
 #include "ParametersForSolver.h"
 #include "Concurrency.h"
 #include "Profiling.h"
+#include "Parallelizer.h"
+#include "SplitThreads.h"
+#include <algorithm>
 
 namespace Dmrg {
 
@@ -126,6 +130,10 @@ public:
 	typedef PsimagLite::LanczosSolver<ParametersForSolverType,
 	MatrixVectorType,
 	TargetVectorType> LanczosSolverType;
+	typedef PreconditionedDavidson<ParametersForSolverType,
+	MatrixVectorType,
+	TargetVectorType> PreconditionedDavidsonType;
+	typedef typename PsimagLite::Vector<TargetVectorType>::Type VectorTargetVectorType;
 
 	Diagonalization(const ParametersType& parameters,
 	                const ModelType& model,
@@ -154,6 +162,7 @@ public:
 	{
 		PsimagLite::Profiling profiling("Diagonalization", std::cout);
 		assert(direction == ProgramGlobals::DirectionEnum::INFINITE);
+		typename MatrixVectorType::Step step(model_);
 		SizeType loopIndex = 0;
 		VectorSizeType sectors;
 		targetedSymmetrySectors(sectors,target.lrs());
@@ -172,6 +181,7 @@ public:
 	{
 		PsimagLite::Profiling profiling("Diagonalization", std::cout);
 		assert(direction != ProgramGlobals::DirectionEnum::INFINITE);
+		typename MatrixVectorType::Step step(model_);
 
 		RealType gsEnergy = internalMain_(target,direction,loopIndex,block);
 		//  targeting:
@@ -182,6 +192,64 @@ public:
 
 private:
 
+	// Diagonalizes independent symmetry sectors at the same time,
+	// one sector per task; see internalMain_ for how threads are split
+	class ParallelSectors {
+
+	public:
+
+		ParallelSectors(Diagonalization& diag,
+		                VectorTargetVectorType& vecSaved,
+		                VectorRealType& energySaved,
+		                const VectorTargetVectorType& initialVector,
+		                const VectorSizeType& sectors,
+		                const SplitThreads& split,
+		                const LeftRightSuperType& lrs,
+		                RealType targetTime,
+		                const ParametersForSolverType& paramsForSolver,
+		                SizeType loopIndex)
+		    : diag_(diag),
+		      vecSaved_(vecSaved),
+		      energySaved_(energySaved),
+		      initialVector_(initialVector),
+		      sectors_(sectors),
+		      split_(split),
+		      lrs_(lrs),
+		      targetTime_(targetTime),
+		      paramsForSolver_(paramsForSolver),
+		      loopIndex_(loopIndex)
+		{}
+
+		SizeType tasks() const { return sectors_.size(); }
+
+		void doTask(SizeType j, SizeType)
+		{
+			vecSaved_[j].resize(initialVector_[j].size());
+			diag_.diagonaliseOneBlock(sectors_[j],
+			                          vecSaved_[j],
+			                          energySaved_[j],
+			                          lrs_,
+			                          targetTime_,
+			                          initialVector_[j],
+			                          paramsForSolver_,
+			                          loopIndex_,
+			                          split_.inner(j));
+		}
+
+	private:
+
+		Diagonalization& diag_;
+		VectorTargetVectorType& vecSaved_;
+		VectorRealType& energySaved_;
+		const VectorTargetVectorType& initialVector_;
+		const VectorSizeType& sectors_;
+		const SplitThreads& split_;
+		const LeftRightSuperType& lrs_;
+		RealType targetTime_;
+		const ParametersForSolverType& paramsForSolver_;
+		SizeType loopIndex_;
+	}; // class ParallelSectors
+
 	void targetedSymmetrySectors(VectorSizeType& mVector,
 	                             const LeftRightSuperType& lrs) const
 	{
@@ -263,19 +331,14 @@ private:
 		}
 
 		SizeType totalSectors = sectors.size();
-		typename PsimagLite::Vector<TargetVectorType>::Type initialVector;
+		VectorTargetVectorType initialVector;
 
 		target.initialGuess(initialVector, block, noguess, weights, lrs.super());
 
-		typename PsimagLite::Vector<RealType>::Type energySaved(totalSectors);
-		typename PsimagLite::Vector<TargetVectorType>::Type vecSaved(totalSectors);
+		VectorRealType energySaved(totalSectors);
+		VectorTargetVectorType vecSaved(totalSectors);
 
 		for (SizeType j = 0; j < totalSectors; ++j) {
-			SizeType i = sectors[j];
-			PsimagLite::OstringStream msg;
-			msg<<"About to diag. sector with";
-			msg<<" quantumSector="<<lrs.super().qnEx(i);
-			progress_.printline(msg, std::cout);
 			TargetVectorType& initialVectorBySector = initialVector[j];
 			RealType norma = PsimagLite::norm(initialVectorBySector);
 
@@ -285,26 +348,42 @@ private:
 			} else {
 				initialVectorBySector /= norma;
 			}
+		}
 
-			if (onlyWft) {
-				vecSaved[j] = initialVectorBySector;
-				gsEnergy = oldEnergy_;
-				PsimagLite::OstringStream msg;
-				msg<<"Early exit due to user requesting (fast) WFT only, ";
-				msg<<"(non updated) energy= "<<gsEnergy;
-				progress_.printline(msg,std::cout);
-			} else {
-				vecSaved[j].resize(initialVectorBySector.size());
-				diagonaliseOneBlock(i,
-				                    vecSaved[j],
-				                    gsEnergy,
-				                    lrs,
-				                    target.time(),
-				                    initialVectorBySector,
-				                    loopIndex);
+		if (onlyWft) {
+			for (SizeType j = 0; j < totalSectors; ++j) {
+				vecSaved[j] = initialVector[j];
+				energySaved[j] = oldEnergy_;
 			}
 
-			energySaved[j] = gsEnergy;
+			PsimagLite::OstringStream msg;
+			msg<<"Early exit due to user requesting (fast) WFT only, ";
+			msg<<"(non updated) energy= "<<oldEnergy_;
+			progress_.printline(msg,std::cout);
+		} else {
+			ParametersForSolverType paramsForSolver(io_, "Lanczos", loopIndex);
+			if (canDiagSectorsInParallel(totalSectors, saveOption))
+				diagSectorsInParallel(vecSaved,
+				                      energySaved,
+				                      initialVector,
+				                      sectors,
+				                      weights,
+				                      lrs,
+				                      target.time(),
+				                      paramsForSolver,
+				                      loopIndex);
+			else
+				for (SizeType j = 0; j < totalSectors; ++j) {
+					vecSaved[j].resize(initialVector[j].size());
+					diagonaliseOneBlock(sectors[j],
+					                    vecSaved[j],
+					                    energySaved[j],
+					                    lrs,
+					                    target.time(),
+					                    initialVector[j],
+					                    paramsForSolver,
+					                    loopIndex);
+				}
 		}
 
 		// calc gs energy
@@ -356,6 +435,68 @@ private:
 		return gsEnergy;
 	}
 
+	// Sectors can be done concurrently only if they don't share
+	// the Kronecker dumper, the debug matrix, or the slow WFT path,
+	// and there are threads to spare
+	bool canDiagSectorsInParallel(SizeType totalSectors, SizeType saveOption) const
+	{
+		if (totalSectors < 2) return false;
+		if (PsimagLite::Concurrency::codeSectionParams.npthreads < 2) return false;
+
+		PsimagLite::String options = parameters_.options;
+		if (options.find("parallelSectors") == PsimagLite::String::npos) return false;
+		if (options.find("KroneckerDumper") != PsimagLite::String::npos) return false;
+		if (options.find("debugmatrix") != PsimagLite::String::npos) return false;
+		if (saveOption & 4) return false;
+
+		return PsimagLite::Concurrency::isMpiDisabled("Diagonalization");
+	}
+
+	// Each sector is a task, and tasks are assigned to the outer threads
+	// in proportion to their sizes, using weights. Each sector's matrix
+	// vector product gets threads in proportion to its size as well
+	void diagSectorsInParallel(VectorTargetVectorType& vecSaved,
+	                           VectorRealType& energySaved,
+	                           const VectorTargetVectorType& initialVector,
+	                           const VectorSizeType& sectors,
+	                           const VectorSizeType& weights,
+	                           const LeftRightSuperType& lrs,
+	                           RealType targetTime,
+	                           const ParametersForSolverType& paramsForSolver,
+	                           SizeType loopIndex)
+	{
+		typedef PsimagLite::Parallelizer<ParallelSectors> ParallelizerType;
+
+		SizeType totalSectors = sectors.size();
+		VectorSizeType weightsBySector(totalSectors);
+		for (SizeType j = 0; j < totalSectors; ++j)
+			weightsBySector[j] = weights[sectors[j]];
+
+		SplitThreads split(PsimagLite::Concurrency::codeSectionParams.npthreads,
+		                   weightsBySector);
+
+		PsimagLite::OstringStream msg;
+		msg<<"Diagonalizing "<<totalSectors<<" sectors with "<<split.outer();
+		msg<<" threads, and up to "<<split.maxInner();
+		msg<<" threads for each matrix vector product";
+		progress_.printline(msg, std::cout);
+
+		ParallelSectors helper(*this,
+		                       vecSaved,
+		                       energySaved,
+		                       initialVector,
+		                       sectors,
+		                       split,
+		                       lrs,
+		                       targetTime,
+		                       paramsForSolver,
+		                       loopIndex);
+
+		PsimagLite::CodeSectionParams codeSectionParams(split.outer());
+		ParallelizerType threadedSectors(codeSectionParams);
+		threadedSectors.loopCreate(helper, weightsBySector);
+	}
+
 	/** Diagonalise the i-th block of the matrix, return its eigenvectors
 			in tmpVec and its eigenvalues in energyTmp
 		!PTEX_LABEL{diagonaliseOneBlock} */
@@ -365,8 +506,15 @@ private:
 	                         const LeftRightSuperType& lrs,
 	                         RealType targetTime,
 	                         const TargetVectorType& initialVector,
-	                         SizeType loopIndex)
+	                         const ParametersForSolverType& paramsForSolver,
+	                         SizeType loopIndex,
+	                         SizeType threads = 0)
 	{
+		PsimagLite::OstringStream msg0;
+		msg0<<"About to diag. sector with";
+		msg0<<" quantumSector="<<lrs.super().qnEx(partitionIndex);
+		progress_.printline(msg0, std::cout);
+
 		PsimagLite::String options = parameters_.options;
 		bool dumperEnabled = (options.find("KroneckerDumper") != PsimagLite::String::npos);
 		ParamsForKroneckerDumperType paramsKrDumper(dumperEnabled,
@@ -382,7 +530,8 @@ private:
 		                             model_.geometry(),
 		                             ModelType::modelLinks(),
 		                             targetTime,
-		                             paramsKrDumperPtr);
+		                             paramsKrDumperPtr,
+		                             threads);
 
 		const SizeType saveOption = parameters_.finiteLoop[loopIndex].saveOption;
 		if (options.find("debugmatrix")!=PsimagLite::String::npos && !(saveOption & 4) ) {
@@ -425,6 +574,7 @@ private:
 		                    energyTmp,
 		                    hc,
 		                    initialVector,
+		                    paramsForSolver,
 		                    loopIndex);
 	}
 
@@ -432,6 +582,7 @@ private:
 	                         RealType &energyTmp,
 	                         HamiltonianConnectionType& hc,
 	                         const TargetVectorType& initialVector,
+	                         const ParametersForSolverType& paramsForSolver,
 	                         SizeType loopIndex)
 	{
 		ReflectionSymmetryType *rs = 0;
@@ -451,12 +602,20 @@ private:
 			return;
 		}
 
-		ParametersForSolverType params(io_, "Lanczos", loopIndex);
+		ParametersForSolverType params(paramsForSolver);
 		LanczosOrDavidsonBaseType* lanczosOrDavidson = 0;
+		PreconditionedDavidsonType* preconditioned = 0;
 
 		bool useDavidson = (parameters_.options.find("useDavidson") !=
 		        PsimagLite::String::npos);
-		if (useDavidson) {
+		bool usePreconditioned = (parameters_.options.find("preconditionedDavidson") !=
+		        PsimagLite::String::npos);
+		if (usePreconditioned) {
+			preconditioned = new PreconditionedDavidsonType(lanczosHelper,
+			                                                params,
+			                                                parameters_.davidsonMaxSubspace,
+			                                                parameters_.davidsonMinDenominator);
+		} else if (useDavidson) {
 			lanczosOrDavidson = new DavidsonSolverType(lanczosHelper, params);
 		} else {
 			lanczosOrDavidson = new LanczosSolverType(lanczosHelper, params);
@@ -469,6 +628,7 @@ private:
 			msg<<" BOGUS energy= "<<energyTmp;
 			progress_.printline(msg,std::cout);
 			if (lanczosOrDavidson) delete lanczosOrDavidson;
+			if (preconditioned) delete preconditioned;
 			return;
 		}
 
@@ -476,8 +636,77 @@ private:
 			err("ReflectionOperator enabled is not longer supported\n");
 
 
+		// single precision operators, except in the last finite loop, which
+		// then refines energy and vectors to full precision
+		const bool lastLoop = (loopIndex + 1 >= parameters_.finiteLoop.size());
+		lanczosHelper.lowPrecision(parameters_.options.find("KronSinglePrecision") !=
+		        PsimagLite::String::npos && !lastLoop);
+
+		// vectors stay in patch order for the whole solver, see MatrixVectorKron;
+		// with KronMpi, those of the preconditioned Davidson are this rank's rows
+		lanczosHelper.distributed(preconditioned != 0);
+		lanczosHelper.patchOrder(parameters_.options.find("KronPatchOrder") !=
+		        PsimagLite::String::npos || lanczosHelper.distributed());
+
 		try {
-			energyTmp = computeLevel(*lanczosOrDavidson,tmpVec,initialVector);
+			const bool patchOrder = lanczosHelper.patchOrder();
+			bool distributed = lanczosHelper.distributed();
+			TargetVectorType initialPatched;
+			TargetVectorType tmpPatched;
+			if (patchOrder) {
+				lanczosHelper.toPatchOrder(initialPatched, initialVector);
+				tmpPatched.resize(tmpVec.size());
+			}
+
+			// the norm of the guess is that of the whole vector
+			if (distributed) {
+				if (PsimagLite::norm(initialPatched) < 1e-12) {
+					PsimagLite::OstringStream msg;
+					msg<<"WARNING: diagonaliseOneBlock: Norm of guess vector is zero, ";
+					msg<<"ignoring guess\n";
+					progress_.printline(msg, std::cout);
+					PsimagLite::fillRandom(initialPatched);
+				}
+
+				TargetVectorType tmp;
+				lanczosHelper.toLocal(tmp, initialPatched);
+				initialPatched.swap(tmp);
+				tmpPatched.resize(initialPatched.size());
+			}
+
+			const TargetVectorType& init = (patchOrder) ? initialPatched : initialVector;
+			TargetVectorType& gs = (patchOrder) ? tmpPatched : tmpVec;
+			if (preconditioned) {
+				try {
+					energyTmp = computeLevel(*preconditioned, gs, init, !distributed);
+				} catch (std::exception& e) {
+					PsimagLite::OstringStream msg;
+					msg<<e.what()<<"Preconditioned Davidson failed, trying with Lanczos...";
+					progress_.printline(msg,std::cout);
+
+					// Lanczos needs whole vectors
+					if (distributed) {
+						lanczosHelper.distributed(false);
+						lanczosHelper.toPatchOrder(initialPatched, initialVector);
+						tmpPatched.resize(tmpVec.size());
+						distributed = false;
+					}
+
+					lanczosOrDavidson = new LanczosSolverType(lanczosHelper, params);
+					energyTmp = computeLevel(*lanczosOrDavidson, gs, init);
+				}
+			} else {
+				energyTmp = computeLevel(*lanczosOrDavidson, gs, init);
+			}
+
+			if (distributed) {
+				TargetVectorType tmp;
+				lanczosHelper.fromLocal(tmp, tmpPatched);
+				tmpPatched.swap(tmp);
+			}
+
+			if (patchOrder)
+				lanczosHelper.fromPatchOrder(tmpVec, tmpPatched);
 		} catch (std::exception& e) {
 			PsimagLite::OstringStream msg0;
 			msg0<<e.what()<<"\n";
@@ -499,16 +728,21 @@ private:
 		}
 
 		if (lanczosOrDavidson) delete lanczosOrDavidson;
+		if (preconditioned) delete preconditioned;
 	}
 
-	RealType computeLevel(LanczosOrDavidsonBaseType& object,
+	// checkNorm is false if initialVector is this rank's rows only, whose
+	// norm the caller has checked
+	template<typename SolverType>
+	RealType computeLevel(SolverType& object,
 	                      TargetVectorType& gsVector,
-	                      const TargetVectorType& initialVector) const
+	                      const TargetVectorType& initialVector,
+	                      bool checkNorm = true) const
 	{
 		SizeType excited = parameters_.excited;
 		RealType norma = PsimagLite::norm(initialVector);
 		RealType gsEnergy = 0;
-		if (fabs(norma) < 1e-12) {
+		if (checkNorm && fabs(norma) < 1e-12) {
 			PsimagLite::OstringStream msg;
 			msg<<"WARNING: diagonaliseOneBlock: Norm of guess vector is zero, ";
 			msg<<"ignoring guess\n";
@@ -2,10 +2,17 @@
 #define DISKORMEMORYSTACK_H
 #include "Stack.h"
 #include "DiskStackNg.h"
+#include "DiskStackAsync.h"
 #include "Io/IoNg.h"
+#include <deque>
 
 namespace Dmrg {
 
+// With onDisk and a non-zero memoryBudget (in bytes) the stack is hybrid:
+// the most recently pushed entries stay in recent_, and the oldest ones
+// spill to disk when the budget is exceeded. The disk then holds the
+// bottom of the stack, and recent_ its top.
+// On disk, each stack has a file of its own; see DiskStackAsync
 template<typename BasisWithOperatorsType>
 class DiskOrMemoryStack {
 
@@ -13,42 +20,41 @@ public:
 
 	typedef typename PsimagLite::Stack<BasisWithOperatorsType>::Type MemoryStackType;
 	typedef DiskStack<BasisWithOperatorsType> DiskStackType;
+	typedef DiskStackAsync<BasisWithOperatorsType> DiskStackAsyncType;
 
 	DiskOrMemoryStack(bool onDisk,
 	                  const PsimagLite::String filename,
 	                  PsimagLite::String label,
-	                  bool isObserveCode)
-	    : diskW_(0), diskR_(0)
+	                  bool isObserveCode,
+	                  bool asyncIo = false,
+	                  SizeType memoryBudget = 0)
+	    : disk_(0),
+	      memoryBudget_((onDisk) ? memoryBudget : 0),
+	      recentBytes_(0)
 	{
 		if (!onDisk) return;
 
 		size_t lastindex = filename.find_last_of(".");
-		PsimagLite::String file = filename.substr(0, lastindex) + "Stacks.hd5";
-
-		if (createFile_) {
-			PsimagLite::IoNg::Out out(file, PsimagLite::IoNg::ACC_TRUNC);
-			out.close();
-			createFile_ = false;
-		}
-
-		diskW_ = new DiskStackType(file, false, label, isObserveCode);
-		diskR_ = new DiskStackType(file, true, label, isObserveCode);
+		PsimagLite::String file = filename.substr(0, lastindex) + "Stack" + label + ".hd5";
+		disk_ = new DiskStackAsyncType(file, label, isObserveCode, asyncIo);
 	}
 
 	~DiskOrMemoryStack()
 	{
-		delete diskR_;
-		diskR_ = 0;
-		delete diskW_;
-		diskW_ = 0;
+		delete disk_;
+		disk_ = 0;
 	}
 
 	void push(const BasisWithOperatorsType& b)
 	{
-		if (diskW_) {
-			diskW_->push(b);
-			diskW_->flush();
-			diskR_->restore(diskW_->size());
+		if (memoryBudget_ > 0) {
+			recent_.push_back(b);
+			recentSizes_.push_back(bytesOf(b));
+			recentBytes_ += recentSizes_.back();
+			while (recentBytes_ > memoryBudget_ && recent_.size() > 0)
+				spillOldest();
+		} else if (disk_) {
+			disk_->push(b);
 		} else {
 			memory_.push(b);
 		}
@@ -56,35 +62,44 @@ public:
 
 	void pop()
 	{
-		if (diskW_) {
-			diskW_->pop();
-			diskW_->flush();
-			diskR_->restore(diskW_->size());
+		if (recent_.size() > 0) {
+			recentBytes_ -= recentSizes_.back();
+			recent_.pop_back();
+			recentSizes_.pop_back();
+		} else if (disk_) {
+			disk_->pop();
 		} else {
 			memory_.pop();
 		}
 	}
 
-	bool onDisk() const { return (diskR_); }
+	bool onDisk() const { return (disk_); }
 
 	SizeType size() const
 	{
-		return (diskR_) ? diskR_->size() : memory_.size();
+		return (disk_) ? disk_->size() + recent_.size() : memory_.size();
 	}
 
 	const BasisWithOperatorsType& top() const
 	{
-		return (diskR_) ? diskR_->top() : memory_.top();
+		if (recent_.size() > 0) return recent_.back();
+
+		return (disk_) ? disk_->top() : memory_.top();
 	}
 
 	void toDisk(DiskStackType& disk) const
 	{
-		if (diskR_) {
-			SizeType total = diskR_->size();
-			DiskStackType& diskNonConst = const_cast<DiskStackType&>(*diskR_);
-			loadStack(disk, diskNonConst);
-			assert(diskW_);
-			diskW_->restore(total);
+		if (recent_.size() > 0) {
+			MemoryStackType memory;
+			for (SizeType i = 0; i < recent_.size(); ++i)
+				memory.push(recent_[i]);
+			loadStack(disk, memory);
+		}
+
+		if (disk_) {
+			const SizeType total = disk_->size();
+			loadStack(disk, *disk_);
+			disk_->restore(total);
 		} else {
 			MemoryStackType memory = memory_;
 			loadStack(disk, memory);
@@ -103,17 +118,37 @@ public:
 
 private:
 
+	// the oldest entry in memory goes on top of the ones on disk
+	void spillOldest()
+	{
+		disk_->push(recent_.front());
+		recentBytes_ -= recentSizes_.front();
+		recent_.pop_front();
+		recentSizes_.pop_front();
+	}
+
+	// rough: the Hamiltonian and all operators as they are stored, in CRS
+	// or in blocks; see OperatorStorage::bytes()
+	static SizeType bytesOf(const BasisWithOperatorsType& b)
+	{
+		SizeType bytes = b.hamiltonian().bytes();
+		const SizeType n = b.numberOfOperators();
+		for (SizeType i = 0; i < n; ++i)
+			bytes += b.getOperatorByIndex(i).getStorage().bytes();
+
+		return bytes;
+	}
+
 	DiskOrMemoryStack(const DiskOrMemoryStack&);
 
 	DiskOrMemoryStack& operator=(const DiskOrMemoryStack&);
 
-	static bool createFile_;
 	MemoryStackType memory_;
-	DiskStackType *diskW_;
-	DiskStackType *diskR_;
+	DiskStackAsyncType* disk_;
+	SizeType memoryBudget_;
+	SizeType recentBytes_;
+	std::deque<BasisWithOperatorsType> recent_;
+	std::deque<SizeType> recentSizes_;
 };
-
-template<typename BasisWithOperatorsType>
-bool DiskOrMemoryStack<BasisWithOperatorsType>::createFile_ = true;
 }
 #endif // DISKORMEMORYSTACK_H
@@ -0,0 +1,288 @@
+#ifndef DISKSTACK_ASYNC_H
+#define DISKSTACK_ASYNC_H
+#include "DiskStackNg.h"
+#include "Io/IoNg.h"
+#include "ProgressIndicator.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Dmrg {
+
+// A DiskStack on a file of its own, for one shrink stack.
+// With async, one I/O thread makes every HDF5 call on that file. push()
+// hands the thread a copy of the entry and returns, and after each top()
+// the thread reads the entry below it, which is what the next shrink of a
+// finite sweep needs. The caller waits for the thread in top(), when it
+// needs an entry, and in push(), if the previous entry is not written yet.
+// So at most one pushed copy and two read entries are in memory.
+// The rest of the program keeps using HDF5 on other files meanwhile, so
+// async needs an HDF5 built thread safe. Otherwise, and without async,
+// every call is made by the caller, as with DiskStack
+template<typename DataType>
+class DiskStackAsync {
+
+	typedef DiskStack<DataType> DiskStackType;
+	typedef std::function<void()> JobType;
+	typedef std::map<SizeType, DataType*> CacheType;
+
+public:
+
+	DiskStackAsync(PsimagLite::String filename,
+	               PsimagLite::String label,
+	               bool isObserveCode,
+	               bool async)
+	    : filename_(filename),
+	      label_(label),
+	      isObserveCode_(isObserveCode),
+	      async_(async && threadSafeHdf5()),
+	      progress_("DiskStackAsync"),
+	      diskW_(0),
+	      diskR_(0),
+	      total_(0),
+	      busy_(false),
+	      stop_(false)
+	{
+		if (async && !async_) {
+			PsimagLite::OstringStream msg;
+			msg<<"WARNING: HDF5 is not thread safe; I/O of the "<<label;
+			msg<<" stack will be synchronous";
+			progress_.printline(msg, std::cout);
+		}
+
+		if (async_) thread_ = std::thread(&DiskStackAsync::loop, this);
+
+		run([this]() { open(); });
+	}
+
+	~DiskStackAsync()
+	{
+		run([this]() { close(); });
+		if (!async_) return;
+
+		{
+			std::lock_guard<std::mutex> guard(mutex_);
+			stop_ = true;
+		}
+
+		cv_.notify_all();
+		thread_.join();
+	}
+
+	SizeType size() const { return total_; }
+
+	void push(const DataType& d)
+	{
+		const SizeType index = total_;
+		if (!async_) {
+			write(d, index);
+			++total_;
+			return;
+		}
+
+		wait();
+		std::shared_ptr<DataType> copy(new DataType(d));
+		run([this, copy, index]() { write(*copy, index); });
+		++total_;
+	}
+
+	void pop()
+	{
+		if (total_ == 0)
+			err("Can't pop; the stack is empty!\n");
+
+		const SizeType total = --total_;
+		run([this, total]() { resize(total); });
+	}
+
+	void restore(SizeType total)
+	{
+		total_ = total;
+		run([this, total]() { resize(total); });
+	}
+
+	// valid until the next push, pop or restore
+	const DataType& top()
+	{
+		assert(total_ > 0);
+		const SizeType index = total_ - 1;
+		run([this, index]() { load(index); });
+		wait();
+
+		typename CacheType::const_iterator it = cache_.find(index);
+		assert(it != cache_.end());
+		const DataType* d = it->second;
+
+		// read ahead what the next shrink needs
+		if (async_ && index > 0) run([this, index]() { load(index - 1); });
+
+		return *d;
+	}
+
+private:
+
+	static bool threadSafeHdf5()
+	{
+#ifdef H5_HAVE_THREADSAFE
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// all functions from here to loop() are called by the I/O thread only
+
+	void open()
+	{
+		PsimagLite::IoNg::Out out(filename_, PsimagLite::IoNg::ACC_TRUNC);
+		out.close();
+
+		diskW_ = new DiskStackType(filename_, false, label_, isObserveCode_);
+		diskR_ = new DiskStackType(filename_, true, label_, isObserveCode_);
+	}
+
+	void close()
+	{
+		drop(0);
+		delete diskR_;
+		diskR_ = 0;
+		delete diskW_;
+		diskW_ = 0;
+	}
+
+	void write(const DataType& d, SizeType index)
+	{
+		assert(diskW_->size() == index);
+		drop(index);
+		diskW_->push(d);
+		diskW_->flush();
+		diskR_->restore(diskW_->size());
+	}
+
+	void resize(SizeType total)
+	{
+		drop(total);
+		diskW_->restore(total);
+		diskW_->flush();
+		diskR_->restore(total);
+	}
+
+	// keeps index and the one above it, which top() may have returned
+	void load(SizeType index)
+	{
+		typename CacheType::iterator it = cache_.begin();
+		while (it != cache_.end()) {
+			if (it->first == index || it->first == index + 1) {
+				++it;
+				continue;
+			}
+
+			delete it->second;
+			cache_.erase(it++);
+		}
+
+		if (cache_.count(index) > 0) return;
+
+		DataType* d = diskR_->read(index);
+		cache_[index] = d;
+	}
+
+	// entries first and up
+	void drop(SizeType first)
+	{
+		typename CacheType::iterator it = cache_.lower_bound(first);
+		while (it != cache_.end()) {
+			delete it->second;
+			cache_.erase(it++);
+		}
+	}
+
+	void loop()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		while (true) {
+			cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+			if (jobs_.empty()) return;
+
+			JobType job = jobs_.front();
+			jobs_.pop_front();
+			busy_ = true;
+			lock.unlock();
+
+			std::exception_ptr error;
+			try {
+				job();
+			} catch (...) {
+				error = std::current_exception();
+			}
+
+			// frees the copy of a pushed entry
+			job = JobType();
+
+			lock.lock();
+			if (error && !error_) error_ = error;
+			busy_ = false;
+			cv_.notify_all();
+		}
+	}
+
+	void run(const JobType& job)
+	{
+		if (!async_) {
+			job();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(mutex_);
+			jobs_.push_back(job);
+		}
+
+		cv_.notify_all();
+	}
+
+	// rethrows what the I/O thread threw
+	void wait()
+	{
+		if (!async_) return;
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		cv_.wait(lock, [this]() { return jobs_.empty() && !busy_; });
+		if (!error_) return;
+
+		std::exception_ptr error = error_;
+		error_ = std::exception_ptr();
+		lock.unlock();
+		std::rethrow_exception(error);
+	}
+
+	DiskStackAsync(const DiskStackAsync&);
+
+	DiskStackAsync& operator=(const DiskStackAsync&);
+
+	PsimagLite::String filename_;
+	PsimagLite::String label_;
+	bool isObserveCode_;
+	bool async_;
+	PsimagLite::ProgressIndicator progress_;
+	DiskStackType* diskW_;
+	DiskStackType* diskR_;
+	CacheType cache_;
+	SizeType total_;
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::deque<JobType> jobs_;
+	bool busy_;
+	bool stop_;
+	std::exception_ptr error_;
+	std::thread thread_;
+}; // class DiskStackAsync
+
+} // namespace Dmrg
+
+#endif // DISKSTACK_ASYNC_H
@@ -192,6 +192,18 @@ public:
 		return *dt_;
 	}
 
+	// entry index, which need not be the top; the caller owns the result
+	DataType* read(SizeType index) const
+	{
+		if (!ioIn_)
+			err("DiskStack::read() called with ioIn_ as nullptr\n");
+
+		assert(index < static_cast<SizeType>(total_));
+		return new DataType(*ioIn_,
+		                    label_ + "/" + ttos(index),
+		                    isObserveCode_);
+	}
+
 	SizeType size() const { return total_; }
 
 private:
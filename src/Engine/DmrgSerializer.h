@@ -84,6 +84,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgramGlobals.h"
 #include "BlockDiagonalMatrix.h"
 #include "BlockOffDiagMatrix.h"
+#include "BlockRecords.h"
+#include <mutex>
 
 namespace Dmrg {
 // Move also checkpointing from DmrgSolver to here (FIXME)
@@ -94,6 +96,8 @@ class DmrgSerializer {
 	typedef typename LeftRightSuperType::SparseMatrixType SparseMatrixType;
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef BlockRecordsIn<ComplexOrRealType> BlockRecordsInType;
+	typedef PsimagLite::Vector<bool>::Type VectorBoolType;
 
 public:
 
@@ -105,6 +109,7 @@ public:
 	typedef typename BasisType::RealType RealType;
 	typedef BlockDiagonalMatrix<MatrixType> BlockDiagonalMatrixType;
 	typedef BlockOffDiagMatrix<MatrixType> BlockOffDiagMatrixType;
+	typedef BlockRecordsOut<ComplexOrRealType> BlockRecordsOutType;
 
 	DmrgSerializer(const FermionSignType& fS,
 	               const FermionSignType& fE,
@@ -117,7 +122,8 @@ public:
 	      lrs_(lrs),
 	      wavefunction_(wf),
 	      transform_(transform),
-	      direction_(direction)
+	      direction_(direction),
+	      record_(0)
 	{}
 
 	// used only by IoNg:
@@ -131,8 +137,10 @@ public:
 	    : fS_(io, prefix + "/fS", bogus),
 	      fE_(io, prefix + "/fE", bogus),
 	      lrs_(io, prefix, isObserveCode),
-	      transform_(io, prefix + "/transform")
+	      record_(0)
 	{
+		readTransform(io, prefix + "/transform");
+
 		if (bogus) return;
 
 		wavefunction_.read(io, prefix + "/WaveFunction");
@@ -145,6 +153,7 @@ public:
 	           typename BasisWithOperatorsType::SaveEnum option,
 	           SizeType numberOfSites,
 	           SizeType counter,
+	           BlockRecordsOutType* records = 0,
 	           typename PsimagLite::EnableIf<
 	           PsimagLite::IsOutputLike<SomeIoOutType>::True, int>::Type = 0) const
 	{
@@ -166,7 +175,11 @@ public:
 
 		wavefunction_.write(io, prefix + "/WaveFunction");
 
-		transform_.write(prefix + "/transform", io);
+		if (records)
+			transform_.write(prefix + "/transform", io, *records);
+		else
+			transform_.write(prefix + "/transform", io);
+
 		io.write(direction_, prefix + "/direction");
 	}
 
@@ -208,6 +221,7 @@ public:
 	void transform(SparseMatrixType& ret, const SparseMatrixType& O) const
 	{
 		BlockOffDiagMatrixType m(O, transform_.offsetsRows());
+		if (records_) loadBlocks(m);
 		m.transform(transform_);
 		m.toSparse(ret);
 	}
@@ -222,6 +236,42 @@ public:
 
 private:
 
+	// If the transform was written to records only its structure is read
+	// here; its blocks are read as transform(...) needs them
+	template<typename IoInputType>
+	void readTransform(IoInputType& io, PsimagLite::String label)
+	{
+		PsimagLite::String filename = blockRecordsFilename(io, label);
+		if (filename == "") {
+			transform_ = BlockDiagonalMatrixType(io, label);
+			return;
+		}
+
+		records_ = BlockRecordsInType::open(filename);
+		transform_.read(io, label, *records_, record_, false);
+		loaded_.resize(transform_.blocks(), false);
+	}
+
+	void loadBlocks(const BlockOffDiagMatrixType& m) const
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		const SizeType n = loaded_.size();
+		for (SizeType i = 0; i < n; ++i) {
+			for (SizeType j = 0; j < n; ++j) {
+				if (m.block(i, j) == 0) continue;
+				loadBlock(i);
+				loadBlock(j);
+			}
+		}
+	}
+
+	void loadBlock(SizeType i) const
+	{
+		if (loaded_[i]) return;
+		transform_.loadBlock(i, *records_, record_);
+		loaded_[i] = true;
+	}
+
 	void fillOffsets(VectorSizeType& v, const BasisType& basis) const
 	{
 		SizeType n = basis.partition();
@@ -240,8 +290,12 @@ private:
 	FermionSignType fE_;
 	LeftRightSuperType lrs_;
 	VectorType wavefunction_;
-	BlockDiagonalMatrixType transform_;
+	mutable BlockDiagonalMatrixType transform_;
 	ProgramGlobals::DirectionEnum direction_;
+	std::shared_ptr<BlockRecordsInType> records_;
+	SizeType record_;
+	mutable VectorBoolType loaded_;
+	mutable std::mutex mutex_;
 }; // class DmrgSerializer
 } // namespace Dmrg 
 
@@ -126,6 +126,7 @@ public:
 	typedef typename TargetingType::WaveFunctionTransfType WaveFunctionTransfType;
 	typedef Truncation<ParametersType,TargetingType> TruncationType;
 	typedef DmrgSerializer<LeftRightSuperType,VectorWithOffsetType> DmrgSerializerType;
+	typedef typename DmrgSerializerType::BlockRecordsOutType BlockRecordsOutType;
 	typedef typename ModelType::GeometryType GeometryType;
 	typedef Checkpoint<ModelType, WaveFunctionTransfType> CheckpointType;
 	typedef Recovery<CheckpointType, TargetingType> RecoveryType;
@@ -171,7 +172,8 @@ public:
 	                model.geometry(),
 	                ioOut_),
 	      energy_(0.0),
-	      saveData_(parameters_.options.find("noSaveData") == PsimagLite::String::npos)
+	      saveData_(parameters_.options.find("noSaveData") == PsimagLite::String::npos),
+	      transformRecords_(0)
 	{
 		std::cout<<appInfo_;
 		PsimagLite::OstringStream msg;
@@ -191,6 +193,12 @@ public:
 		for (SizeType i = 0; i < n; ++i)
 			quantumSector_.push_back(model_.targetQuantum().qn(i));
 
+		const bool inFloat = (parameters_.options.find("transformsInFloat") !=
+		        PsimagLite::String::npos);
+		if (inFloat ||
+		        parameters_.options.find("transformsBinary") != PsimagLite::String::npos)
+			transformRecords_ = new BlockRecordsOutType(parameters_.filename + ".transforms",
+			                                            inFloat);
 	}
 
 	~DmrgSolver()
@@ -203,6 +211,8 @@ public:
 		appInfo_.finalize();
 		ioOut_.write(appInfo_, "ApplicationInfo");
 		ioOut_.close();
+		delete transformRecords_;
+		transformRecords_ = 0;
 
 		PsimagLite::OstringStream msg2;
 		msg2<<"Turning off the engine.";
@@ -624,7 +634,7 @@ obtain ordered
 		        : BasisWithOperatorsType::SaveEnum::PARTIAL;
 		SizeType numberOfSites = model_.geometry().numberOfSites();
 		PsimagLite::String prefix("Serializer");
-		ds->write(ioOut_, prefix, saveOption2, numberOfSites, counter);
+		ds->write(ioOut_, prefix, saveOption2, numberOfSites, counter, transformRecords_);
 		PsimagLite::String prefixForTarget = TargetingType::buildPrefix(ioOut_, counter);
 		target.write(sitesIndices_[stepCurrent_], ioOut_, prefixForTarget);
 		++counter;
@@ -696,6 +706,7 @@ obtain ordered
 	ObservablesInSituType inSitu_;
 	RealType energy_;
 	bool saveData_;
+	BlockRecordsOutType* transformRecords_;
 }; //class DmrgSolver
 } // namespace Dmrg
 
@@ -124,12 +124,13 @@ public:
 	                      const GeometryType& geometry,
 	                      const ModelLinksType& lpb,
 	                      RealType targetTime,
-	                      const ParamsForKroneckerDumperType* pKroneckerDumper)
+	                      const ParamsForKroneckerDumperType* pKroneckerDumper,
+	                      SizeType threads = 0)
 	    : modelHelper_(m, lrs),
 	      superGeometry_(geometry),
 	      lpb_(lpb),
 	      targetTime_(targetTime),
-	      kroneckerDumper_(pKroneckerDumper,lrs,m),
+	      kroneckerDumper_(pKroneckerDumper,lrs,m,targetTime),
 	      progress_("HamiltonianConnection"),
 	      systemBlock_(modelHelper_.leftRightSuper().left().block()),
 	      envBlock_(modelHelper_.leftRightSuper().right().block()),
@@ -139,8 +140,12 @@ public:
 	                   smax_,
 	                   emin_,
 	                   modelHelper_.leftRightSuper().super().block()),
-	      totalOnes_(hamAbstract_.items())
+	      totalOnes_(hamAbstract_.items()),
+	      codeSectionParams_(ConcurrencyType::codeSectionParams)
 	{
+		// threads for H*y; 0 means all of them
+		if (threads > 0) codeSectionParams_.npthreads = threads;
+
 		lps_.reserve(ProgramGlobals::MAX_LPS);
 		SizeType nitems = hamAbstract_.items();
 		for (SizeType x = 0; x < nitems; ++x)
@@ -261,6 +266,21 @@ public:
 		return link2;
 	}
 
+	// Diagonal of this block of the superblock Hamiltonian
+	void diagonal(VectorType& d) const
+	{
+		d.resize(modelHelper_.size());
+		std::fill(d.begin(), d.end(), 0.0);
+		modelHelper_.hamiltonianDiagonal(d);
+		const SizeType total = lps_.size();
+		for (SizeType x = 0; x < total; ++x) {
+			OperatorStorageType const* A = 0;
+			OperatorStorageType const* B = 0;
+			const LinkType& link2 = getKron(&A, &B, x);
+			modelHelper_.diagonalInter(d, A->getCRS(), B->getCRS(), link2);
+		}
+	}
+
 	KroneckerDumperType& kroneckerDumper() const
 	{
 		return kroneckerDumper_;
@@ -268,8 +288,15 @@ public:
 
 	const ModelHelperType& modelHelper() const { return modelHelper_; }
 
+	RealType targetTime() const { return targetTime_; }
+
 	SizeType tasks() const {return lps_.size(); }
 
+	const PsimagLite::CodeSectionParams& codeSectionParams() const
+	{
+		return codeSectionParams_;
+	}
+
 private:
 
 	SizeType cacheConnections(SizeType x)
@@ -391,6 +418,7 @@ private:
 	SizeType emin_;
 	HamiltonianAbstractType hamAbstract_;
 	VectorSizeType totalOnes_;
+	PsimagLite::CodeSectionParams codeSectionParams_;
 }; // class HamiltonianConnection
 } // namespace Dmrg
 
@@ -177,6 +177,7 @@ public:
 		knownLabels_.push_back("DynamicDmrgEps");
 		knownLabels_.push_back("DynamicDmrgAdvanceEach");
 		knownLabels_.push_back("CorrectionVectorOmega");
+		knownLabels_.push_back("CorrectionVectorOmegas");
 		knownLabels_.push_back("CorrectionVectorEta");
 		knownLabels_.push_back("CorrectionVectorAlgorithm");
 		knownLabels_.push_back("CorrelationsType");
@@ -200,6 +201,10 @@ public:
 		knownLabels_.push_back("GeometryMaxConnections");
 		knownLabels_.push_back("LanczosNoSaveLanczosVectors");
 		knownLabels_.push_back("DenseSparseThreshold");
+		knownLabels_.push_back("TridiagMemoryBudget");
+		knownLabels_.push_back("ShrinkStacksMemoryBudget");
+		knownLabels_.push_back("DavidsonMaxSubspace");
+		knownLabels_.push_back("DavidsonMinDenominator");
 		knownLabels_.push_back("TridiagonalEps");
 		knownLabels_.push_back("HoneycombLy");
 		knownLabels_.push_back("GeometryValueModifier");
@@ -335,7 +340,9 @@ public:
 			\item [advanceUnrestricted] Don't restrict advance time to borders
 			\item [findSymmetrySector] Find symmetry sector with lowest energy, and
 			ignore value set in TargetElectronsUp or TargetSzPlusConst
-			\item [KroneckerDumper] TBW
+			\item [KroneckerDumper] Writes the superblock connections of the
+			first matrix vector product to kroneckerDumperN.txt, and also to
+			kroneckerDumperN.hd5, which kronReplay reads
 			\item [extendedPrint] TBW
 			\item [truncationNoSvd] Do not use SVD for truncation;
 									   use density matrix instead
@@ -345,7 +352,9 @@ public:
 			\item [wftAccelPatches] Force WFT acceleration with patches, even
 			in twositedmrg
 			\item [BatchedGemm] Only meaningful with MatrixVectorKron. Enables
-								batched gemm and might need plugin sc
+								batched gemm, threaded over left groups and patches.
+								Uses plugin sc if compiled with -DPLUGIN_SC, or else
+								only BLAS
 			\item [KrylovNoAbridge] TBW
 			\item [fixLegacyBugs] TBW
 			\item [saveDensityMatrixEigenvalues] Save DensityMatrixEigenvalues
@@ -358,6 +367,80 @@ public:
 			to target expressions.
 			\item [calcAndPrintEntropies] Calculate entropies and print to cout file
 			\item [noPrintHamiltonianAverage] Don't print <...|H|...> in NGSTs.
+			\item [OnTheFlyRowPartition] Only meaningful with MatrixVectorOnTheFly.
+			Each thread owns a contiguous slice of rows of the target vector and
+			loops over all connections for it, instead of keeping one full-size
+			accumulator per thread. Ignored if MPI is enabled.
+			\item [parallelSectors] Diagonalize several targeted symmetry sectors
+			at the same time, splitting the threads between sectors and their
+			matrix vector products, in proportion to the sector sizes. Useful
+			with findSymmetrySector. Also
+			tridiagonalizes the sectors of Krylov time vectors and correction
+			vectors at the same time.
+			\item [twoPointIncremental] For the observer. Compute each row i of
+			two-point correlations by growing the operator at site i once, and
+			reusing the growth for all sites j>i. Threads are over rows.
+			\item [truncationPartialSvd] Only meaningful with SVD truncation.
+			For large symmetry blocks compute only as many singular vectors as
+			states could be kept, by randomized range finding, and fall back to the
+			full SVD if the result cannot be trusted. States not computed are always
+			discarded, and their weight is added to the truncation error; a block
+			where they could weigh as much as a kept state gets the full SVD.
+			Ignored with EnablePersistentSvd.
+			\item [shrinkStacksAsyncIo] Only meaningful with shrinkStacksOnDisk.
+			One thread per shrink stack does all disk I/O of that stack: bases
+			pushed are written in the background, and the basis the next shrink
+			needs is read ahead. Needs HDF5 built thread safe, and is
+			synchronous otherwise.
+			\item [KronWorkStealing] Only meaningful with MatrixVectorKron. Split the
+			Kron matrix vector product into tasks of similar estimated cost, and
+			let idle threads steal tasks from busy ones. Ignored with BatchedGemm.
+			\item [KronPatchOrder] Only meaningful with MatrixVectorKron. Keep the
+			Lanczos or Davidson vectors of the ground state solver in Kron patch
+			order, so that each matrix vector product needs no permutation.
+			\item [preconditionedDavidson] Use Davidson with the diagonal of the
+			Hamiltonian as preconditioner for the ground state. Not available for
+			SU(2); there, the correction is the residual. Overrides useDavidson.
+			See DavidsonMaxSubspace= and DavidsonMinDenominator=. If it does not
+			converge, the step falls back to Lanczos.
+			\item [KronSinglePrecision] Only meaningful with MatrixVectorKron. Store
+			and multiply the Kron operators in single precision, except in the last
+			finite loop; vectors and energies stay in full precision, and the last
+			finite loop refines them. Ignored with BatchedGemm; disables KronWorkStealing.
+			\item [KronSetupCache] Only meaningful with MatrixVectorKron. Build the
+			Kron operators of a symmetry sector once per DMRG step, and share them
+			between the ground state solver and the targets (time evolution,
+			correction vectors) that need the Hamiltonian of the same sector and time.
+			At most two unused sets of operators are kept, and only for the current
+			step and sector.
+			\item [KronCalibrate] Only meaningful with MatrixVectorKron. Time the
+			products of each pair of Kron blocks, and keep for each pair the dense
+			or sparse storage and the order of multiplication that are fastest on
+			this host, instead of those that DenseSparseThreshold and the flop
+			count give. Choices are kept by block shape and density, and saved to
+			KronCalibration\_host.txt, which later runs on the same host read.
+			The choices depend on timings, so that runs with KronCalibrate are
+			reproducible to rounding only, not bit for bit. Ignored with BatchedGemm.
+			\item [KronMpi] Only meaningful with MatrixVectorKron and MPI. Give each
+			MPI rank a contiguous range of output patches of the Kron product, of
+			about the same weight. Each rank builds only the Kron blocks its patches
+			use, and receives from the other ranks only the input patches those
+			blocks need. Only preconditionedDavidson is distributed: each rank
+			keeps only its rows of the vectors of the solver. Lanczos and Davidson
+			keep whole vectors on every rank, and gather the rows of the other
+			ranks after each product. Ignored with BatchedGemm; disables
+			KronWorkStealing.
+			\item [transformsBinary] Write the blocks of the DMRG transformations
+			that observe reads to filename.transforms, and those of the WFT stacks
+			to filename.wft, as raw binary records with an index of their blocks,
+			instead of to the HDF5 output. Observe maps the file and reads only the
+			blocks each operator needs.
+			\item [transformsInFloat] As transformsBinary, but the blocks are stored
+			in single precision.
+			\item [KronCheckMatrixMatrix] Only meaningful with MatrixVectorKron. For
+			testing: check each product of the Hamiltonian with several vectors at
+			once against one matrix vector product per vector, and stop with an
+			error if they differ.
 		\end{itemize}
 		*/
 	void check(const PsimagLite::String& label,
@@ -425,6 +508,21 @@ public:
 		registerOpts.push_back("OperatorsChangeAll");
 		registerOpts.push_back("calcAndPrintEntropies");
 		registerOpts.push_back("noPrintHamiltonianAverage");
+		registerOpts.push_back("OnTheFlyRowPartition");
+		registerOpts.push_back("parallelSectors");
+		registerOpts.push_back("twoPointIncremental");
+		registerOpts.push_back("truncationPartialSvd");
+		registerOpts.push_back("shrinkStacksAsyncIo");
+		registerOpts.push_back("KronWorkStealing");
+		registerOpts.push_back("KronPatchOrder");
+		registerOpts.push_back("preconditionedDavidson");
+		registerOpts.push_back("KronSinglePrecision");
+		registerOpts.push_back("KronSetupCache");
+		registerOpts.push_back("KronCalibrate");
+		registerOpts.push_back("KronMpi");
+		registerOpts.push_back("transformsBinary");
+		registerOpts.push_back("transformsInFloat");
+		registerOpts.push_back("KronCheckMatrixMatrix");
 
 		PsimagLite::Options::Writeable optWriteable(registerOpts,
 		                                            PsimagLite::Options::Writeable::PERMISSIVE);
@@ -436,9 +534,6 @@ public:
 		if (val.find("BatchedGemm") != PsimagLite::String::npos) {
 			if (notMvk)
 				err("FATAL: BatchedGemm only with MatrixVectorKron\n");
-#ifndef PLUGIN_SC
-			err("BatchedGemm needs -DPLUGIN_SC in Config.make\n");
-#endif
 		}
 	}
 
@@ -6,6 +6,7 @@
 #include "../Version.h"
 #include "Concurrency.h"
 #include "ProgramGlobals.h"
+#include "Io/IoNg.h"
 
 namespace Dmrg {
 
@@ -44,8 +45,9 @@ public:
 
 	KroneckerDumper(const ParamsForKroneckerDumper* p,
 	                const LeftRightSuperType& lrs,
-	                SizeType m)
-	    : enabled_(p && p->enabled),pairCount_(0),disable_(false)
+	                SizeType m,
+	                RealType targetTime)
+	    : enabled_(p && p->enabled),pairCount_(0),disable_(false),ioOut_(0)
 	{
 		if (!enabled_) return;
 
@@ -79,6 +81,8 @@ public:
 		fout_<<qtarget<<"\n";
 
 		signs_ = lrs.left().signs();
+
+		writeBinary(lrs, m, targetTime);
 		counter_++;
 	}
 
@@ -89,6 +93,10 @@ public:
 		fout_<<"EOF\n";
 		fout_.close();
 
+		ioOut_->write(y_, "KroneckerDumper/Vector");
+		delete ioOut_;
+		ioOut_ = 0;
+
 		ConcurrencyType::mutexDestroy(&mutex_);
 	}
 
@@ -136,11 +144,13 @@ public:
 			return;
 		}
 
+		ConcurrencyType::mutexLock(&mutex_);
 		if (option)
 			fout_<<"LeftHamiltonian\n";
 		else
 			fout_<<"RightHamiltonian\n";
 		printMatrix(hamiltonian);
+		ConcurrencyType::mutexUnlock(&mutex_);
 	}
 
 private:
@@ -176,6 +186,23 @@ private:
 		fout_<<basis.signs();
 	}
 
+	// The same superblock in kroneckerDumperN.hd5, for kronReplay, which
+	// builds the Hamiltonian connection of sector m from it
+	void writeBinary(const LeftRightSuperType& lrs, SizeType m, RealType targetTime)
+	{
+		PsimagLite::String filename = "kroneckerDumper" + ttos(counter_) + ".hd5";
+		ioOut_ = new PsimagLite::IoNg::Out(filename, PsimagLite::IoNg::ACC_TRUNC);
+
+		const SizeType isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		const PsimagLite::String prefix = "KroneckerDumper";
+		ioOut_->createGroup(prefix);
+		ioOut_->write(counter_, prefix + "/Instance");
+		ioOut_->write(isComplex, prefix + "/IsComplex");
+		ioOut_->write(m, prefix + "/Partition");
+		ioOut_->write(targetTime, prefix + "/TargetTime");
+		lrs.write(*ioOut_, prefix, BasisWithOperatorsType::SaveEnum::ALL, false);
+	}
+
 	PairSizeType getNupNdown(QnType q) const
 	{
 		assert(q.other.size() >= 1);
@@ -216,6 +243,7 @@ private:
 	std::ofstream fout_;
 	VectorBoolType signs_;
 	ConcurrencyType::MutexType mutex_;
+	PsimagLite::IoNg::Out* ioOut_;
 }; // class KroneckerDumpter
 
 template<typename SparseMatrixType>
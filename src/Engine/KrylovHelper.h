@@ -29,9 +29,7 @@ public:
 	           SizeType n2,
 	           SizeType i0)
 	{
-		bool krylovAbridge = (params_.options.find("KrylovNoAbridge") ==
-		                      PsimagLite::String::npos);
-		SizeType n3 = (krylovAbridge) ? 1 : n2;
+		SizeType n3 = vTimesPhiSize(n2);
 		// ---------------------------------------------------
 		// precompute values of calcVTimesPhi(kprime,v,phi,i0)
 		// ---------------------------------------------------
@@ -39,6 +37,22 @@ public:
 		for(SizeType kprime = 0; kprime < n3; ++kprime)
 			calcVTimesPhiArray[kprime] = calcVTimesPhi(kprime, V, phi, i0);
 
+		calcR(r, whatRorI, T, calcVTimesPhiArray, n2);
+	}
+
+	// same as above, but with <V(:,kprime)|phi> already computed
+	// for kprime < vTimesPhiSize(n2)
+	template<typename SomeActionType>
+	void calcR(VectorType& r,
+	           const SomeActionType& whatRorI,
+	           const MatrixComplexOrRealType& T,
+	           const VectorType& calcVTimesPhiArray,
+	           SizeType n2)
+	{
+		bool krylovAbridge = (params_.options.find("KrylovNoAbridge") ==
+		                      PsimagLite::String::npos);
+		SizeType n3 = calcVTimesPhiArray.size();
+		assert(n3 == vTimesPhiSize(n2));
 		ComplexOrRealType sum2 = 0.0;
 		for (SizeType k = 0; k < n2; ++k) {
 			ComplexOrRealType sum = 0.0;
@@ -58,6 +72,13 @@ public:
 		progress_.printline(msg, std::cout);
 	}
 
+	SizeType vTimesPhiSize(SizeType n2) const
+	{
+		bool krylovAbridge = (params_.options.find("KrylovNoAbridge") ==
+		                      PsimagLite::String::npos);
+		return (krylovAbridge) ? 1 : n2;
+	}
+
 	static ComplexOrRealType calcVTimesPhi(SizeType kprime,
 	                                       const MatrixComplexOrRealType& V,
 	                                       const VectorWithOffsetType& phi,
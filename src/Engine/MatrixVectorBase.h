@@ -97,10 +97,54 @@ public:
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> FullMatrixType;
 
+	// One DMRG step; only MatrixVectorKron keeps something per step
+	class Step {
+
+	public:
+
+		Step(const ModelType&) {}
+	};
+
 	SizeType reflectionSector() const { return 0; }
 
 	void reflectionSector(SizeType) {  }
 
+	// Only MatrixVectorKron has a patch order, a lower precision and
+	// vectors distributed over MPI ranks, see there
+	void patchOrder(bool) {  }
+
+	bool patchOrder() const { return false; }
+
+	void lowPrecision(bool) {  }
+
+	void toPatchOrder(VectorType& dest, const VectorType& src) const { dest = src; }
+
+	void fromPatchOrder(VectorType& dest, const VectorType& src) const { dest = src; }
+
+	void distributed(bool) {  }
+
+	bool distributed() const { return false; }
+
+	void toLocal(VectorType& dest, const VectorType& src) const { dest = src; }
+
+	void fromLocal(VectorType& dest, const VectorType& src) const { dest = src; }
+
+	void sumOverRanks(VectorType&) const {  }
+
+	static void diagonal(VectorType& d, const SparseMatrixType& matrixStored)
+	{
+		const SizeType n = matrixStored.rows();
+		d.resize(n);
+		for (SizeType i = 0; i < n; ++i) {
+			d[i] = 0.0;
+			for (int k = matrixStored.getRowPtr(i); k < matrixStored.getRowPtr(i + 1); ++k) {
+				if (static_cast<SizeType>(matrixStored.getCol(k)) != i) continue;
+				d[i] = matrixStored.getValue(k);
+				break;
+			}
+		}
+	}
+
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const;
 
 	static void fullDiag(VectorRealType& eigs,
@@ -103,13 +103,20 @@ public:
 	typedef typename MatrixDenseOrSparseType::value_type ComplexOrRealType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
 
+	// Only the blocks that products for the output patches [patchBegin,
+	// patchEnd) use are built; the others are null. See KronDistribution
 	ArrayOfMatStruct(const OperatorStorageType& sparse1,
 	                 const GenIjPatchType& patchOld,
 	                 const GenIjPatchType& patchNew,
 	                 typename GenIjPatchType::LeftOrRightEnumType leftOrRight,
 	                 RealType threshold,
-	                 bool useLowerPart)
-	    : data_(patchNew(leftOrRight).size(), patchOld(leftOrRight).size())
+	                 bool useLowerPart,
+	                 SizeType patchBegin,
+	                 SizeType patchEnd)
+	    : data_(patchNew(leftOrRight).size(), patchOld(leftOrRight).size()),
+	      useLowerPart_(useLowerPart),
+	      patchBegin_(patchBegin),
+	      patchEnd_(patchEnd)
 	{
 		const SparseMatrixType& sparse = sparse1.getCRS();
 		const BasisType& basisOld = (leftOrRight == GenIjPatchType::LEFT) ?
@@ -241,6 +248,12 @@ public:
 
 		for(SizeType ipatch=0; ipatch < ipatchSize; ipatch++) {
 
+			if (!isNeededRow(ipatch)) {
+				for(SizeType jpatch=0; jpatch < jpatchSize; jpatch++)
+					data_(ipatch,jpatch) = 0;
+				continue;
+			}
+
 			// ------------------------------------------------------
 			// initialize  data structure to count number of nonzeros
 			// per row in sparse matrix of  data_(ipatch,jpatch)
@@ -280,7 +293,7 @@ public:
 					if (!is_valid_jpatch) continue;
 
 
-					if (useLowerPart && (ipatch < jpatch))  continue;
+					if (!isNeeded(ipatch, jpatch))  continue;
 
 					const SizeType indx = jpatch;
 
@@ -309,7 +322,7 @@ public:
 			for(SizeType jpatch=0; jpatch < jpatchSize; ++jpatch) {
 
 				data_(ipatch,jpatch) = 0;
-				if (useLowerPart && (ipatch < jpatch))  continue;
+				if (!isNeeded(ipatch, jpatch))  continue;
 
 				const SizeType lnrows = ipatch_Size[ipatch];
 				const SizeType lncols = jpatch_Size[jpatch];
@@ -392,7 +405,7 @@ public:
 					if (!is_valid_jpatch) continue;
 
 
-					if (useLowerPart && (ipatch < jpatch))  continue;
+					if (!isNeeded(ipatch, jpatch))  continue;
 
 					const SizeType indx = jpatch;
 
@@ -428,7 +441,7 @@ public:
 			if (idebug >= 1) {
 				for(SizeType jpatch=0; jpatch < jpatchSize; ++jpatch) {
 
-					if (useLowerPart && (ipatch < jpatch))  continue;
+					if (!isNeeded(ipatch, jpatch))  continue;
 
 					SizeType indx = jpatch;
 
@@ -451,6 +464,29 @@ public:
 		return *data_(i,j);
 	}
 
+	// for KronCalibration, which may change the storage of a block
+	MatrixDenseOrSparseType& operator()(SizeType i,SizeType j)
+	{
+		assert(i<data_.n_row() && j<data_.n_col());
+		assert(data_(i,j));
+		return *data_(i,j);
+	}
+
+	// false for the blocks that were not built
+	bool has(SizeType i, SizeType j) const
+	{
+		assert(i<data_.n_row() && j<data_.n_col());
+		return (data_(i,j) != 0);
+	}
+
+	// see MatrixDenseOrSparse::toLowPrecision()
+	void toLowPrecision()
+	{
+		for (SizeType i = 0; i < data_.n_row(); ++i)
+			for (SizeType j = 0; j < data_.n_col(); ++j)
+				if (data_(i,j)) data_(i,j)->toLowPrecision();
+	}
+
 	~ArrayOfMatStruct()
 	{
 		for (SizeType i = 0; i < data_.n_row(); ++i)
@@ -460,12 +496,30 @@ public:
 
 private:
 
+	// block (ipatch, jpatch) is used for output patch ipatch, and, with
+	// useLowerPart, transposed for output patch jpatch
+	bool isNeeded(SizeType ipatch, SizeType jpatch) const
+	{
+		if (useLowerPart_ && ipatch < jpatch) return false;
+		if (ipatch >= patchBegin_ && ipatch < patchEnd_) return true;
+		return (useLowerPart_ && jpatch >= patchBegin_ && jpatch < patchEnd_);
+	}
+
+	bool isNeededRow(SizeType ipatch) const
+	{
+		for (SizeType jpatch = 0; jpatch < data_.n_col(); ++jpatch)
+			if (isNeeded(ipatch, jpatch)) return true;
+		return false;
+	}
 
 	ArrayOfMatStruct(const ArrayOfMatStruct&);
 
 	ArrayOfMatStruct& operator=(const ArrayOfMatStruct&);
 
 	PsimagLite::Matrix<MatrixDenseOrSparseType*> data_;
+	bool useLowerPart_;
+	SizeType patchBegin_;
+	SizeType patchEnd_;
 }; //class ArrayOfMatStruct
 } // namespace Dmrg
 
@@ -4,14 +4,23 @@
 #include <numeric>
 #include "BLAS.h"
 #include "ProgressIndicator.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
 
 namespace Dmrg {
 
+// Native backend for BatchedGemm, needs only BLAS.
+// The A (left) and B (right) matrices of all connections are stacked into
+// Abatch_ and Bbatch_, so that H*X is computed in two BLAS-3 phases,
+// BX = Bbatch*X and Y = BX*transpose(Abatch). The BX phase is threaded over
+// left groups, because patches with the same left group add to the same
+// columns of BX; the Y phase is threaded over patches
 template<typename InitKronType>
 class BatchedGemm2 {
 
 	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
 	typedef typename InitKronType::GenIjPatchType GenIjPatchType;
+	typedef typename InitKronType::SparseMatrixType SparseMatrixType;
 	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
 	typedef typename MatrixDenseOrSparseType::VectorType VectorType;
 	typedef typename VectorType::value_type ComplexOrRealType;
@@ -24,7 +33,43 @@ class BatchedGemm2 {
 	typedef typename PsimagLite::Vector<const ComplexOrRealType*>::Type VectorConstStarType;
 
 	static const int ialign_ = 32;
-	static const int idebug_ = 0; // set to 0 until it gives correct results
+
+	// BX phase writes the columns of BX_ of each left group, Y phase
+	// writes the part of vout of each patch; neither overlaps
+	class ParallelPatches {
+
+	public:
+
+		enum PhaseEnum {PHASE_BX, PHASE_Y};
+
+		ParallelPatches(const BatchedGemm2& batchedGemm,
+		                PhaseEnum phase,
+		                VectorType& vout,
+		                const VectorType& vin)
+		    : batchedGemm_(batchedGemm), phase_(phase), vout_(vout), vin_(vin)
+		{}
+
+		SizeType tasks() const
+		{
+			return (phase_ == PHASE_BX) ? batchedGemm_.patchesOfLeft_.size() :
+			                              batchedGemm_.initKron_.numberOfPatches(InitKronType::OLD);
+		}
+
+		void doTask(SizeType task, SizeType)
+		{
+			if (phase_ == PHASE_BX)
+				batchedGemm_.bxOneLeftGroup(task, vin_);
+			else
+				batchedGemm_.yOnePatch(task, vout_);
+		}
+
+	private:
+
+		const BatchedGemm2& batchedGemm_;
+		PhaseEnum phase_;
+		VectorType& vout_;
+		const VectorType& vin_;
+	};
 
 public:
 
@@ -66,12 +111,14 @@ public:
 		assert(ldAbatch * leftMaxState * noperator >= 1);
 		assert(ldBbatch * rightMaxState * noperator >= 1);
 
+		Abatch_.setTo(0.0);
+		Bbatch_.setTo(0.0);
 		for (SizeType ioperator = 0; ioperator < noperator; ++ioperator) {
 			const ArrayOfMatStructType& xiStruct = initKron_.xc(ioperator);
 			for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
 				for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
 
-					const MatrixType& Asrc =  xiStruct(ipatch,jpatch).dense();
+					const MatrixDenseOrSparseType& Asrc =  xiStruct(ipatch,jpatch);
 					SizeType igroup = initKron_.patch(InitKronType::NEW,
 					                                  GenIjPatchType::LEFT)[ipatch];
 					SizeType jgroup = initKron_.patch(InitKronType::NEW,
@@ -89,7 +136,7 @@ public:
 			for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
 				for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
 
-					const MatrixType& Bsrc =  yiStruct(ipatch,jpatch).dense();
+					const MatrixDenseOrSparseType& Bsrc =  yiStruct(ipatch,jpatch);
 					SizeType igroup = initKron_.patch(InitKronType::NEW,
 					                                  GenIjPatchType::RIGHT)[ipatch];
 					SizeType jgroup = initKron_.patch(InitKronType::NEW,
@@ -123,6 +170,24 @@ public:
 			rightPatchSize_[ipatch] = R2 - R1;
 		}
 
+		// patches by left group, and their weights summed, for the BX phase
+		const VectorSizeType& weights = initKron_.weightsOfPatchesNew();
+		VectorSizeType taskOfGroup(initKron_.lrs(InitKronType::NEW).left().partition(), npatches);
+		for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+			SizeType igroup = initKron_.patch(InitKronType::NEW,
+			                                  GenIjPatchType::LEFT)[ipatch];
+			assert(igroup < taskOfGroup.size());
+			if (taskOfGroup[igroup] == npatches) {
+				taskOfGroup[igroup] = patchesOfLeft_.size();
+				patchesOfLeft_.push_back(VectorSizeType());
+				weightsOfLeft_.push_back(0);
+			}
+
+			const SizeType task = taskOfGroup[igroup];
+			patchesOfLeft_[task].push_back(ipatch);
+			if (ipatch < weights.size()) weightsOfLeft_[task] += weights[ipatch];
+		}
+
 		int leftMaxStates  = initKron_.lrs(InitKronType::NEW).left().size();
 		int rightMaxStates = initKron_.lrs(InitKronType::NEW).right().size();
 		int nrowA = leftMaxStates;
@@ -134,7 +199,8 @@ public:
 
 		{
 			PsimagLite::OstringStream msg;
-			msg<<"Construction done.";
+			msg<<"Construction done, native backend, npatches="<<npatches;
+			msg<<" connections="<<noperator;
 			progress_.printline(msg,std::cout);
 		}
 	}
@@ -151,147 +217,183 @@ public:
  compute  Y = H * X
  ------------------
 */
+		BX_.setTo(0.0);
+
+		typedef PsimagLite::Parallelizer<ParallelPatches> ParallelizerType;
+
+		ParallelPatches bx(*this, ParallelPatches::PHASE_BX, vout, vin);
+		ParallelizerType parallelBx(initKron_.codeSectionParams());
+		loopCreate(parallelBx, bx, weightsOfLeft_);
+
+		ParallelPatches y(*this, ParallelPatches::PHASE_Y, vout, vin);
+		ParallelizerType parallelY(initKron_.codeSectionParams());
+		loopCreate(parallelY, y, initKron_.weightsOfPatchesNew());
+	}
+
+private:
+
+	template<typename ParallelizerType>
+	void loopCreate(ParallelizerType& parallelizer,
+	                ParallelPatches& helper,
+	                const VectorSizeType& weights) const
+	{
+		if (initKron_.loadBalance() && weights.size() == helper.tasks())
+			parallelizer.loopCreate(helper, weights);
+		else
+			parallelizer.loopCreate(helper);
+	}
+
+	void bxOneLeftGroup(SizeType task, const VectorType& vin) const
+	{
+		assert(task < patchesOfLeft_.size());
+		const VectorSizeType& patches = patchesOfLeft_[task];
+		for (SizeType i = 0; i < patches.size(); ++i)
+			bxOnePatch(patches[i], vin);
+	}
+
+	// BX(:, k*ncolA + (L1:L2)) += Bbatch(:, k*ncolB + (R1:R2))*XJ for all k;
+	// other patches with the same left group add to the same columns
+	void bxOnePatch(SizeType jpatch, const VectorType& vin) const
+	{
 		int leftMaxStates  = initKron_.lrs(InitKronType::NEW).left().size();
 		int rightMaxStates = initKron_.lrs(InitKronType::NEW).right().size();
-		SizeType npatches = initKron_.numberOfPatches(InitKronType::OLD);
 		SizeType noperator = initKron_.connections();
-		int nrowA = leftMaxStates;
-		int ncolA = nrowA;
-		int nrowB = rightMaxStates;
-		int ncolB = nrowB;
-		int nrowBX = nrowB;
-		int ncolBX = ncolA * noperator;
-		int ldBX = ialign_ * iceil(nrowBX, ialign_);
-		BX_.setTo(0.0);
+		int ncolA = leftMaxStates;
+		int ncolB = rightMaxStates;
+		int nrowBX = rightMaxStates;
+		int ldBX = BX_.rows();
 
-		for (SizeType jpatch = 0; jpatch < npatches; ++jpatch) {
-			long j1 = initKron_.offsetForPatches(InitKronType::NEW, jpatch);
-			int nrowX = rightPatchSize_[jpatch];
-			assert(initKron_.offsetForPatches(InitKronType::NEW, jpatch + 1) - j1 ==
-			       nrowX * leftPatchSize_[jpatch]);
+		long j1 = initKron_.offsetForPatches(InitKronType::NEW, jpatch);
+		int nrowX = rightPatchSize_[jpatch];
+		assert(initKron_.offsetForPatches(InitKronType::NEW, jpatch + 1) - j1 ==
+		       nrowX * leftPatchSize_[jpatch]);
 
-			/*
+		/*
 	 --------------------------------------
 	 XJ = reshape( X(j1:j2), nrowX, ncolX )
 	 --------------------------------------
 	 */
-			assert(static_cast<SizeType>(j1) < vin.size());
-			int ldXJ = nrowX;
+		assert(static_cast<SizeType>(j1) < vin.size());
+		int ldXJ = nrowX;
 
-			SizeType jgroup = initKron_.patch(InitKronType::NEW,
-			                                  GenIjPatchType::RIGHT)[jpatch];
-			int R1 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup);
-			int R2 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup + 1);
+		SizeType jgroup = initKron_.patch(InitKronType::NEW,
+		                                  GenIjPatchType::RIGHT)[jpatch];
+		int R1 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup);
+		int R2 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup + 1);
 
-			SizeType igroup = initKron_.patch(InitKronType::NEW,
-			                                  GenIjPatchType::LEFT)[jpatch];
-			int L1 = initKron_.lrs(InitKronType::NEW).left().partition(igroup);
-			int L2 = initKron_.lrs(InitKronType::NEW).left().partition(igroup + 1);
+		SizeType igroup = initKron_.patch(InitKronType::NEW,
+		                                  GenIjPatchType::LEFT)[jpatch];
+		int L1 = initKron_.lrs(InitKronType::NEW).left().partition(igroup);
+		int L2 = initKron_.lrs(InitKronType::NEW).left().partition(igroup + 1);
 
-			assert(static_cast<SizeType>(j1 + R2 - R1 - 1 + (L2 - L1 - 1)*nrowX) <
-			       vin.size());
-			/*
-	 -------------------------------
-	 independent DGEMM in same group
-	 -------------------------------
-	 */
-			for (SizeType k = 0; k < noperator; ++k) {
-				int offsetB = k*ncolB;
-				int offsetBX = k*ncolA;
-				/*
-		------------------------------------------------------------------------
-		BX(1:nrowBX, offsetBX + (L1:L2)) = Bbatch(1:nrowBX, offsetB + (R1:R2) ) *
-											 XJ( 1:(R2-R1+1), 1:(L2-L1+1));
-		------------------------------------------------------------------------
-		*/
-				psimag::BLAS::GEMM('N',
-				                   'N',
-				                   nrowBX,
-				                   L2 - L1,
-				                   R2 - R1,
-				                   1.0,
-				                   &(Bbatch_(0, offsetB + R1)),
-				                   Bbatch_.rows(),
-				                   &(vin[j1]),
-				                   ldXJ,
-				                   0.0,
-				                   &(BX_(0, offsetBX + L1)),
-				                   ldBX);
-			}
-		}
+		if (R2 == R1 || L2 == L1) return;
 
-		/*
- -------------------------------------------------
- perform computations with  Y += (BX)*transpose(A)
- -------------------------------------------------
-*/
-		for(SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+		assert(static_cast<SizeType>(j1 + R2 - R1 - 1 + (L2 - L1 - 1)*nrowX) <
+		       vin.size());
 
-			long i1 = initKron_.offsetForPatches(InitKronType::NEW, ipatch);
-
-
-			SizeType jgroup = initKron_.patch(InitKronType::NEW,
-			                                  GenIjPatchType::RIGHT)[ipatch];
-			SizeType R1 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup);
-			SizeType R2 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup + 1);
-
-			SizeType igroup = initKron_.patch(InitKronType::NEW,
-			                                  GenIjPatchType::LEFT)[ipatch];
-			SizeType L1 = initKron_.lrs(InitKronType::NEW).left().partition(igroup);
-			SizeType L2 = initKron_.lrs(InitKronType::NEW).left().partition(igroup + 1);
-
-			assert(R2 - R1 == rightPatchSize_[ipatch] &&
-			       L2 - L1 == leftPatchSize_[ipatch]);
-
-			assert(static_cast<SizeType>(i1) < vout.size());
-			ComplexOrRealType *YI = &(vout[i1]);
-			int nrowYI = R2 - R1;
-			int ldYI = nrowYI;
-			int ncolYI = L2 - L1;
-			assert(static_cast<int>(initKron_.offsetForPatches(InitKronType::NEW, ipatch + 1) - i1) ==
-			       nrowYI * ncolYI);
-
-			/*
-		--------------------------------------------------------------------
-		YI(1:(R2-R1+1),1:(L2-L1+1)) = BX( R1:R2,1:ncolBX) *
-										 transpose( Abatch( L1:L2,1:ncolBX) );
-		--------------------------------------------------------------------
-	  */
+		for (SizeType k = 0; k < noperator; ++k) {
+			int offsetB = k*ncolB;
+			int offsetBX = k*ncolA;
 			psimag::BLAS::GEMM('N',
-			                   'T',
-			                   nrowYI,
-			                   ncolYI,
-			                   ncolBX,
+			                   'N',
+			                   nrowBX,
+			                   L2 - L1,
+			                   R2 - R1,
 			                   1.0,
-			                   &(BX_(R1, 0)),
-			                   BX_.rows(),
-			                   &(Abatch_(L1, 0)),
-			                   Abatch_.rows(),
-			                   0.0,
-			                   YI,
-			                   ldYI);
+			                   &(Bbatch_(0, offsetB + R1)),
+			                   Bbatch_.rows(),
+			                   &(vin[j1]),
+			                   ldXJ,
+			                   1.0,
+			                   &(BX_(0, offsetBX + L1)),
+			                   ldBX);
 		}
 	}
 
-private:
+	/*
+	--------------------------------------------------------------------
+	YI(1:(R2-R1+1),1:(L2-L1+1)) = BX( R1:R2,1:ncolBX) *
+									 transpose( Abatch( L1:L2,1:ncolBX) );
+	--------------------------------------------------------------------
+	*/
+	void yOnePatch(SizeType ipatch, VectorType& vout) const
+	{
+		int leftMaxStates  = initKron_.lrs(InitKronType::NEW).left().size();
+		SizeType noperator = initKron_.connections();
+		int ncolBX = leftMaxStates * noperator;
+
+		long i1 = initKron_.offsetForPatches(InitKronType::NEW, ipatch);
+
+		SizeType jgroup = initKron_.patch(InitKronType::NEW,
+		                                  GenIjPatchType::RIGHT)[ipatch];
+		SizeType R1 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup);
+		SizeType R2 = initKron_.lrs(InitKronType::NEW).right().partition(jgroup + 1);
+
+		SizeType igroup = initKron_.patch(InitKronType::NEW,
+		                                  GenIjPatchType::LEFT)[ipatch];
+		SizeType L1 = initKron_.lrs(InitKronType::NEW).left().partition(igroup);
+		SizeType L2 = initKron_.lrs(InitKronType::NEW).left().partition(igroup + 1);
+
+		assert(R2 - R1 == rightPatchSize_[ipatch] &&
+		       L2 - L1 == leftPatchSize_[ipatch]);
+
+		int nrowYI = R2 - R1;
+		int ldYI = nrowYI;
+		int ncolYI = L2 - L1;
+		if (nrowYI == 0 || ncolYI == 0) return;
+
+		assert(static_cast<SizeType>(i1) < vout.size());
+		ComplexOrRealType *YI = &(vout[i1]);
+		assert(static_cast<int>(initKron_.offsetForPatches(InitKronType::NEW, ipatch + 1) - i1) ==
+		       nrowYI * ncolYI);
+
+		psimag::BLAS::GEMM('N',
+		                   'T',
+		                   nrowYI,
+		                   ncolYI,
+		                   ncolBX,
+		                   1.0,
+		                   &(BX_(R1, 0)),
+		                   BX_.rows(),
+		                   &(Abatch_(L1, 0)),
+		                   Abatch_.rows(),
+		                   0.0,
+		                   YI,
+		                   ldYI);
+	}
 
 	static int iceil(int x, int n)
 	{
 		return (x + n - 1)/n;
 	}
 
-	static void mylacpy(const MatrixType& a,
+	// patches below the dense threshold are scattered from their CRS
+	static void mylacpy(const MatrixDenseOrSparseType& a,
 	                    MatrixType& b,
 	                    SizeType xstart,
 	                    SizeType ystart)
 	{
-		int m = a.rows();
-		int n = a.cols();
-		for (int j = 0; j < n; ++j)
-			for (int i = 0; i < m; ++i)
-				b(i + xstart, j + ystart) = a(i, j);
+		if (a.isDense()) {
+			const MatrixType& ad = a.dense();
+			int m = ad.rows();
+			int n = ad.cols();
+			for (int j = 0; j < n; ++j)
+				for (int i = 0; i < m; ++i)
+					b(i + xstart, j + ystart) = ad(i, j);
+			return;
+		}
+
+		const SparseMatrixType& as = a.sparse();
+		const SizeType m = as.rows();
+		for (SizeType i = 0; i < m; ++i)
+			for (int k = as.getRowPtr(i); k < as.getRowPtr(i + 1); ++k)
+				b(i + xstart, as.getCol(k) + ystart) = as.getValue(k);
 	}
 
+	BatchedGemm2(const BatchedGemm2&);
+
+	BatchedGemm2& operator=(const BatchedGemm2&);
+
 	const InitKronType& initKron_;
 	PsimagLite::ProgressIndicator progress_;
 	MatrixType Abatch_;
@@ -299,6 +401,8 @@ private:
 	mutable MatrixType BX_;
 	VectorSizeType leftPatchSize_;
 	VectorSizeType rightPatchSize_;
+	typename PsimagLite::Vector<VectorSizeType>::Type patchesOfLeft_;
+	VectorSizeType weightsOfLeft_;
 };
 }
 #endif // BATCHEDGEMM_H
@@ -79,9 +79,11 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #define INITKRON_BASE_H
 #include "ProgramGlobals.h"
 #include "ArrayOfMatStruct.h"
+#include "KronCalibration.h"
 #include "Vector.h"
 #include "Link.h"
 #include "ProgressIndicator.h"
+#include "Concurrency.h"
 
 namespace Dmrg {
 
@@ -106,6 +108,7 @@ public:
 	typedef typename PsimagLite::Vector<ArrayOfMatStructType*>::Type VectorArrayOfMatStructType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
 	typedef typename ArrayOfMatStructType::VectorSizeType VectorSizeType;
+	typedef KronCalibration<MatrixDenseOrSparseType> KronCalibrationType;
 
 	enum WhatBasisEnum {OLD,  NEW};
 
@@ -113,7 +116,8 @@ public:
 	             SizeType m,
 	             const QnType& qn,
 	             RealType denseSparseThreshold,
-	             bool useLowerPart)
+	             bool useLowerPart,
+	             const PsimagLite::CodeSectionParams& codeSectionParams)
 	    : progress_("InitKronBase"),
 	      mOld_(m),
 	      mNew_(m),
@@ -121,7 +125,11 @@ public:
 	      useLowerPart_(useLowerPart),
 	      ijpatchesOld_(lrs, qn),
 	      ijpatchesNew_(&ijpatchesOld_),
-	      wftMode_(false)
+	      patchBegin_(0),
+	      patchEnd_(ijpatchesOld_(GenIjPatchType::LEFT).size()),
+	      wftMode_(false),
+	      lowPrecision_(false),
+	      codeSectionParams_(codeSectionParams)
 	{
 		PsimagLite::OstringStream msg;
 		msg<<"::ctor (for H), ";
@@ -146,6 +154,12 @@ public:
 
 	bool useLowerPart() const { return useLowerPart_; }
 
+	// threads for the products with these operators
+	const PsimagLite::CodeSectionParams& codeSectionParams() const
+	{
+		return codeSectionParams_;
+	}
+
 	const LeftRightSuperType& lrs(WhatBasisEnum what) const
 	{
 		return (what == OLD) ? ijpatchesOld_.lrs() : ijpatchesNew_->lrs();
@@ -180,6 +194,31 @@ public:
 
 	SizeType connections() const { return xc_.size(); }
 
+	// Method of estimate_kron_cost for the product of connection ic from
+	// inPatch to outPatch, or 0 to let kronMult pick it. See calibrate()
+	int kronMethod(SizeType ic, SizeType outPatch, SizeType inPatch) const
+	{
+		if (kronMethods_.size() == 0) return 0;
+		assert(ic < kronMethods_.size());
+		return kronMethods_[ic](outPatch, inPatch);
+	}
+
+	// Operators in LowComplexOrRealType from now on; the vectors are unchanged.
+	// See MatrixDenseOrSparse::toLowPrecision()
+	void toLowPrecision()
+	{
+		if (lowPrecision_) return;
+
+		for (SizeType ic = 0; ic < xc_.size(); ++ic) {
+			xc_[ic]->toLowPrecision();
+			yc_[ic]->toLowPrecision();
+		}
+
+		lowPrecision_ = true;
+	}
+
+	bool lowPrecision() const { return lowPrecision_; }
+
 	SizeType size(WhatBasisEnum what) const
 	{
 		return (what == OLD) ? sizeInternal(ijpatchesOld_, mOld_) :
@@ -192,6 +231,15 @@ public:
 		return weightsOfPatches_;
 	}
 
+	// The output patches whose blocks are built, all unless distribute()
+	SizeType patchBegin() const { return patchBegin_; }
+
+	SizeType patchEnd() const { return patchEnd_; }
+
+	// where the patches of each rank begin, or empty unless distribute()
+	const VectorSizeType& patchRanges() const { return rangeBegin_; }
+
+	bool distributed() const { return (rangeBegin_.size() > 0); }
 
 	void computeOffsets(VectorSizeType& offsetForPatches,
 	                    WhatBasisEnum what)
@@ -260,7 +308,9 @@ protected:
 		                                                    *ijpatchesNew_,
 		                                                    GenIjPatchType::LEFT,
 		                                                    denseSparseThreshold_,
-		                                                    useLowerPart_);
+		                                                    useLowerPart_,
+		                                                    patchBegin_,
+		                                                    patchEnd_);
 
 		xc_.push_back(x1);
 
@@ -269,10 +319,78 @@ protected:
 		                                                    *ijpatchesNew_,
 		                                                    GenIjPatchType::RIGHT,
 		                                                    denseSparseThreshold_,
-		                                                    useLowerPart_);
+		                                                    useLowerPart_,
+		                                                    patchBegin_,
+		                                                    patchEnd_);
 		yc_.push_back(y1);
 	}
 
+	// For SolverOptions=KronMpi. Gives each of ranks ranks a range of output
+	// patches, contiguous and of about the same weight, and builds from now on
+	// only the blocks of this rank's range. A rank may have none. Must be
+	// called after setUpVstart(NEW) and before addOneConnection()
+	void distribute(SizeType ranks, SizeType rank)
+	{
+		assert(xc_.size() == 0);
+		const SizeType npatch = weightsOfPatches_.size();
+		assert(npatch == numberOfPatches(NEW));
+		long double total = 0;
+		for (SizeType p = 0; p < npatch; ++p)
+			total += weightsOfPatches_[p] + 1;
+
+		rangeBegin_.resize(ranks + 1, 0);
+		long double sum = 0;
+		SizeType r = 1;
+		for (SizeType p = 0; p < npatch; ++p) {
+			sum += weightsOfPatches_[p] + 1;
+			while (r < ranks && sum >= total*r/ranks)
+				rangeBegin_[r++] = p + 1;
+		}
+
+		for (; r <= ranks; ++r)
+			rangeBegin_[r] = npatch;
+
+		patchBegin_ = rangeBegin_[rank];
+		patchEnd_ = rangeBegin_[rank + 1];
+	}
+
+	// For SolverOptions=KronCalibrate; see KronCalibration. Must be called
+	// before toLowPrecision()
+	void calibrate()
+	{
+		assert(!lowPrecision_);
+		PsimagLite::MemoryUsage::TimeHandle time1 = PsimagLite::ProgressIndicator::time();
+		KronCalibrationType& calibration = KronCalibrationType::instance();
+		const SizeType npatch = numberOfPatches(NEW);
+		assert(npatch == numberOfPatches(OLD));
+		const SizeType nC = xc_.size();
+		kronMethods_.resize(nC);
+		for (SizeType ic = 0; ic < nC; ++ic) {
+			kronMethods_[ic].resize(npatch, npatch);
+			for (SizeType outPatch = 0; outPatch < npatch; ++outPatch) {
+				for (SizeType inPatch = 0; inPatch < npatch; ++inPatch) {
+					if (useLowerPart_ && outPatch < inPatch) continue;
+					if (!xc_[ic]->has(outPatch, inPatch)) continue;
+
+					const bool transposed = (useLowerPart_ && outPatch != inPatch);
+					typename KronCalibrationType::Choice choice =
+					        calibration((*xc_[ic])(outPatch, inPatch),
+					                    (*yc_[ic])(outPatch, inPatch),
+					                    transposed);
+					kronMethods_[ic](outPatch, inPatch) = choice.methodN;
+					if (transposed)
+						kronMethods_[ic](inPatch, outPatch) = choice.methodT;
+				}
+			}
+		}
+
+		calibration.report(progress_);
+		PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
+		PsimagLite::OstringStream msg;
+		msg<<"::calibrate() took "<<(time2 - time1).millis()<<" ms";
+		progress_.printline(msg, std::cout);
+	}
+
 	// -------------------------------------------
 	// setup vstart(:) for beginning of each patch
 	// -------------------------------------------
@@ -442,10 +560,16 @@ private:
 	GenIjPatchType ijpatchesOld_;
 	GenIjPatchType* ijpatchesNew_;
 	VectorSizeType weightsOfPatches_;
+	SizeType patchBegin_;
+	SizeType patchEnd_;
+	VectorSizeType rangeBegin_;
 	VectorArrayOfMatStructType xc_;
 	VectorArrayOfMatStructType yc_;
+	typename PsimagLite::Vector<PsimagLite::Matrix<int> >::Type kronMethods_;
 	VectorBoolType signsNew_;
 	bool wftMode_;
+	bool lowPrecision_;
+	PsimagLite::CodeSectionParams codeSectionParams_;
 };
 } // namespace Dmrg
 
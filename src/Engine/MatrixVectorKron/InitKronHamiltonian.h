@@ -81,6 +81,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "InitKronBase.h"
 #include "Vector.h"
 #include "Profiling.h"
+#include "Mpi.h"
 
 namespace Dmrg {
 
@@ -106,6 +107,7 @@ public:
 	typedef typename ArrayOfMatStructType::GenIjPatchType GenIjPatchType;
 	typedef typename PsimagLite::Vector<ArrayOfMatStructType*>::Type VectorArrayOfMatStructType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
 	typedef typename ArrayOfMatStructType::VectorSizeType VectorSizeType;
 
 	InitKronHamiltonian(const ModelType& model,
@@ -115,22 +117,33 @@ public:
 	               hc.modelHelper().quantumNumber(),
 	               model.params().denseSparseThreshold,
 	               model.params().options.find("KronNoUseLowerPart") == PsimagLite::String::npos
-	               && model.params().options.find("BatchedGemm") == PsimagLite::String::npos),
+	               && model.params().options.find("BatchedGemm") == PsimagLite::String::npos,
+	               hc.codeSectionParams()),
 	      model_(model),
-	      hc_(hc),
 	      vstart_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1),
 	      offsetForPatches_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1)
 	{
-		addHlAndHr();
+		BaseType::setUpVstart(vstart_, BaseType::NEW);
+		assert(vstart_.size() > 0);
+
+		// with KronMpi this rank builds only the blocks of its patches
+		const SizeType ranks = PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD);
+		if (mpi() && !batchedGemm() && ranks > 1)
+			BaseType::distribute(ranks, PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD));
+
+		addHlAndHr(hc);
 
 		{
 			PsimagLite::Profiling profiling("convertXcYcArrays", std::cout);
 
-			convertXcYcArrays();
+			convertXcYcArrays(hc);
 		}
 
-		BaseType::setUpVstart(vstart_, BaseType::NEW);
-		assert(vstart_.size() > 0);
+		// BatchedGemm uses the blocks but not kronMult
+		if (model.params().options.find("KronCalibrate") != PsimagLite::String::npos &&
+		        model.params().options.find("BatchedGemm") == PsimagLite::String::npos)
+			BaseType::calibrate();
+
 		SizeType nsize = vstart_[vstart_.size() - 1];
 		assert(nsize > 0);
 		yin_.resize(nsize, 0.0);
@@ -145,6 +158,16 @@ public:
 		return (model_.params().options.find("KronLoadBalance") != PsimagLite::String::npos);
 	}
 
+	bool workStealing() const
+	{
+		return (model_.params().options.find("KronWorkStealing") != PsimagLite::String::npos);
+	}
+
+	bool mpi() const
+	{
+		return (model_.params().options.find("KronMpi") != PsimagLite::String::npos);
+	}
+
 	// -------------------
 	// copy vin(:) to yin(:)
 	// -------------------
@@ -212,6 +235,116 @@ public:
 		BaseType::copyOut(vout, xout_, vstart_);
 	}
 
+	// Diagonal of the Hamiltonian, in patch order, from the diagonal patches
+	// of each connection: diag(A) kron diag(B). Zero outside of
+	// [patchBegin(), patchEnd())
+	void diagonal(VectorType& d) const
+	{
+		const SizeType nC = BaseType::connections();
+		d.resize(yin_.size());
+		std::fill(d.begin(), d.end(), 0.0);
+		VectorType diagA;
+		VectorType diagB;
+		for (SizeType ipatch = BaseType::patchBegin(); ipatch < BaseType::patchEnd(); ++ipatch) {
+			const SizeType start = vstart_[ipatch];
+			for (SizeType ic = 0; ic < nC; ++ic) {
+				BaseType::xc(ic)(ipatch, ipatch).getDiagonal(diagA);
+				BaseType::yc(ic)(ipatch, ipatch).getDiagonal(diagB);
+				const SizeType sizeLeft = diagA.size();
+				const SizeType sizeRight = diagB.size();
+				assert(start + sizeLeft*sizeRight <= d.size());
+				for (SizeType ileft = 0; ileft < sizeLeft; ++ileft)
+					for (SizeType iright = 0; iright < sizeRight; ++iright)
+						d[start + iright + ileft*sizeRight] += diagA[ileft]*diagB[iright];
+			}
+		}
+	}
+
+	// dest = src in patch order, as copyIn() does for yin(:)
+	void toPatchOrder(VectorType& dest, const VectorType& src) const
+	{
+		const VectorSizeType& permInverse = BaseType::lrs(BaseType::NEW).super().permutationInverse();
+		SizeType nl = BaseType::lrs(BaseType::NEW).left().hamiltonian().rows();
+		SizeType offset = BaseType::offset(BaseType::NEW);
+		SizeType npatches = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size();
+		const BasisType& left = BaseType::lrs(BaseType::NEW).left();
+		const BasisType& right = BaseType::lrs(BaseType::NEW).right();
+
+		dest.resize(yin_.size());
+		for (SizeType ipatch=0; ipatch < npatches; ++ipatch) {
+			SizeType igroup = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT)[ipatch];
+			SizeType jgroup = BaseType::patch(BaseType::NEW, GenIjPatchType::RIGHT)[ipatch];
+			SizeType sizeLeft =  left.partition(igroup+1) - left.partition(igroup);
+			SizeType sizeRight = right.partition(jgroup+1) - right.partition(jgroup);
+			SizeType left_offset = left.partition(igroup);
+			SizeType right_offset = right.partition(jgroup);
+
+			for (SizeType ileft=0; ileft < sizeLeft; ++ileft) {
+				for (SizeType iright=0; iright < sizeRight; ++iright) {
+					SizeType ij = ileft + left_offset + (iright + right_offset)*nl;
+					assert(ij < permInverse.size());
+					SizeType r = permInverse[ij];
+					SizeType ip = vstart_[ipatch] + (iright + ileft * sizeRight);
+					assert(ip < dest.size());
+					assert((r >= offset) && ((r-offset) < src.size()));
+					dest[ip] = src[r-offset];
+				}
+			}
+		}
+	}
+
+	// dest = src in the ordering of the superblock, src in patch order
+	void fromPatchOrder(VectorType& dest, const VectorType& src) const
+	{
+		dest.resize(src.size());
+		BaseType::copyOut(dest, src, vstart_);
+	}
+
+	// copyIn() of k = vin.size() vectors into xmulti and ymulti, where
+	// the k vectors of patch p are next to each other at k*vstart[p]
+	void copyIn(VectorType& xmulti,
+	            VectorType& ymulti,
+	            const VectorVectorType& vout,
+	            const VectorVectorType& vin)
+	{
+		const SizeType k = vin.size();
+		assert(vout.size() == k);
+		const SizeType npatches = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size();
+		xmulti.resize(k*xout_.size());
+		ymulti.resize(k*yin_.size());
+		for (SizeType v = 0; v < k; ++v) {
+			copyIn(vout[v], vin[v]);
+			for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+				const SizeType start = vstart_[ipatch];
+				const SizeType size = vstart_[ipatch + 1] - start;
+				const SizeType multiStart = k*start + v*size;
+				for (SizeType i = 0; i < size; ++i) {
+					xmulti[multiStart + i] = xout_[start + i];
+					ymulti[multiStart + i] = yin_[start + i];
+				}
+			}
+		}
+	}
+
+	// copyOut() of the k = vout.size() vectors in xmulti
+	void copyOut(VectorVectorType& vout, const VectorType& xmulti)
+	{
+		const SizeType k = vout.size();
+		const SizeType npatches = BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size();
+		assert(xmulti.size() == k*xout_.size());
+		for (SizeType v = 0; v < k; ++v) {
+			for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+				const SizeType start = vstart_[ipatch];
+				const SizeType size = vstart_[ipatch + 1] - start;
+				const SizeType multiStart = k*start + v*size;
+				for (SizeType i = 0; i < size; ++i)
+					xout_[start + i] = xmulti[multiStart + i];
+			}
+
+			copyOut(vout[v]);
+		}
+	}
+
 	const VectorType& yin() const { return yin_; }
 
 	VectorType& xout() { return xout_; }
@@ -230,11 +363,11 @@ public:
 
 private:
 
-	void addHlAndHr()
+	void addHlAndHr(const HamiltonianConnectionType& hc)
 	{
 		const RealType value = 1.0;
-		const OperatorStorageType& aL = hc_.modelHelper().leftRightSuper().left().hamiltonian();
-		const OperatorStorageType& aR = hc_.modelHelper().leftRightSuper().right().hamiltonian();
+		const OperatorStorageType& aL = hc.modelHelper().leftRightSuper().left().hamiltonian();
+		const OperatorStorageType& aR = hc.modelHelper().leftRightSuper().right().hamiltonian();
 		identityL_.makeDiagonal(aL.rows(), value);
 		identityR_.makeDiagonal(aR.rows(), value);
 		std::pair<SizeType, SizeType> ops(0,0);
@@ -253,15 +386,15 @@ private:
 		BaseType::addOneConnection(identityL_,aR,link);
 	}
 
-	void convertXcYcArrays()
+	void convertXcYcArrays(const HamiltonianConnectionType& hc)
 	{
-		SizeType total = hc_.tasks();
+		SizeType total = hc.tasks();
 
 		for (SizeType ix=0;ix<total;ix++) {
 			OperatorStorageType const* A = 0;
 			OperatorStorageType const* B = 0;
 
-			LinkType link2 = hc_.getKron(&A, &B, ix);
+			LinkType link2 = hc.getKron(&A, &B, ix);
 			if (link2.type==ProgramGlobals::ConnectionEnum::ENVIRON_SYSTEM)  {
 				LinkType link3 = link2;
 				link3.type = ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON;
@@ -285,7 +418,6 @@ private:
 	InitKronHamiltonian& operator=(const InitKronHamiltonian&);
 
 	const ModelType& model_;
-	const HamiltonianConnectionType& hc_;
 	OperatorStorageType identityL_;
 	OperatorStorageType identityR_;
 	VectorSizeType vstart_;
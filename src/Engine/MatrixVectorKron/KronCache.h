@@ -0,0 +1,196 @@
+#ifndef KRON_CACHE_H
+#define KRON_CACHE_H
+
+#include "Vector.h"
+#include <mutex>
+#include <algorithm>
+
+namespace Dmrg {
+
+// For SolverOptions=KronSetupCache. Keeps the InitKron and KronMatrix built
+// for a (partition, time), so that the matrix vector objects that the ground
+// state solver and the targets build in one DMRG step can share them. One
+// cache lives for one DMRG step only, during which the bases do not change;
+// see MatrixVectorKron::Step. An entry is lent to one user at a time; a user
+// that finds it lent builds its own. Only entries of the latest partition are
+// kept, and of those at most maxIdle entries not lent, the least recently
+// used being dropped first
+template<typename InitKronType, typename KronMatrixType>
+class KronCache {
+
+	typedef typename InitKronType::RealType RealType;
+
+public:
+
+	class Entry {
+
+	public:
+
+		Entry(SizeType partition,
+		      RealType time,
+		      InitKronType* initKron,
+		      KronMatrixType* kronMatrix)
+		    : partition_(partition),
+		      time_(time),
+		      initKron_(initKron),
+		      kronMatrix_(kronMatrix),
+		      lent_(true),
+		      lastUse_(0)
+		{}
+
+		~Entry()
+		{
+			delete kronMatrix_;
+			kronMatrix_ = 0;
+			delete initKron_;
+			initKron_ = 0;
+		}
+
+		InitKronType& initKron() const { return *initKron_; }
+
+		KronMatrixType& kronMatrix() const { return *kronMatrix_; }
+
+	private:
+
+		Entry(const Entry&);
+
+		Entry& operator=(const Entry&);
+
+		friend class KronCache;
+
+		SizeType partition_;
+		RealType time_;
+		InitKronType* initKron_;
+		KronMatrixType* kronMatrix_;
+		bool lent_;
+		SizeType lastUse_;
+	};
+
+	static const SizeType maxIdle = 2;
+
+	KronCache() : partition_(0), clock_(0) {}
+
+	// all users must have given their entries back
+	~KronCache()
+	{
+		for (SizeType i = 0; i < entries_.size(); ++i) {
+			assert(!entries_[i]->lent_);
+			delete entries_[i];
+		}
+	}
+
+	// The entry for this key, now lent to the caller, or 0 if there is none
+	// or if it is lent already
+	Entry* take(SizeType partition, RealType time)
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		for (SizeType i = 0; i < entries_.size(); ++i) {
+			Entry* entry = entries_[i];
+			if (entry->partition_ != partition) continue;
+			if (entry->time_ != time || entry->lent_) continue;
+			entry->lent_ = true;
+			entry->lastUse_ = ++clock_;
+			return entry;
+		}
+
+		return 0;
+	}
+
+	// Takes ownership of initKron and kronMatrix, and returns their entry,
+	// lent to the caller. A new partition drops all entries not lent
+	Entry* put(SizeType partition,
+	           RealType time,
+	           InitKronType* initKron,
+	           KronMatrixType* kronMatrix)
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		if (partition != partition_) {
+			partition_ = partition;
+			dropOld();
+		}
+
+		Entry* entry = new Entry(partition, time, initKron, kronMatrix);
+		entry->lastUse_ = ++clock_;
+		entries_.push_back(entry);
+		return entry;
+	}
+
+	void giveBack(Entry* entry)
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		entry->lent_ = false;
+		entry->lastUse_ = ++clock_;
+		if (!isCurrent(*entry)) dropOld();
+		dropIdle();
+	}
+
+	// Removes entry without deleting its InitKron and KronMatrix, which are
+	// now the caller's
+	void release(Entry* entry)
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		typename PsimagLite::Vector<Entry*>::Type::iterator it = std::find(entries_.begin(),
+		                                                                    entries_.end(),
+		                                                                    entry);
+		assert(it != entries_.end());
+		entries_.erase(it);
+		entry->initKron_ = 0;
+		entry->kronMatrix_ = 0;
+		delete entry;
+	}
+
+private:
+
+	KronCache(const KronCache&);
+
+	KronCache& operator=(const KronCache&);
+
+	void dropOld()
+	{
+		typename PsimagLite::Vector<Entry*>::Type kept;
+		for (SizeType i = 0; i < entries_.size(); ++i) {
+			Entry* entry = entries_[i];
+			if (entry->lent_ || isCurrent(*entry))
+				kept.push_back(entry);
+			else
+				delete entry;
+		}
+
+		entries_.swap(kept);
+	}
+
+	// drops the least recently used entries not lent, until there are maxIdle
+	void dropIdle()
+	{
+		for (;;) {
+			SizeType idle = 0;
+			SizeType oldest = entries_.size();
+			for (SizeType i = 0; i < entries_.size(); ++i) {
+				if (entries_[i]->lent_) continue;
+				++idle;
+				if (oldest == entries_.size() ||
+				        entries_[i]->lastUse_ < entries_[oldest]->lastUse_)
+					oldest = i;
+			}
+
+			if (idle <= maxIdle) return;
+
+			delete entries_[oldest];
+			entries_.erase(entries_.begin() + oldest);
+		}
+	}
+
+	bool isCurrent(const Entry& entry) const
+	{
+		return (entry.partition_ == partition_);
+	}
+
+	std::mutex mutex_;
+	SizeType partition_;
+	SizeType clock_;
+	typename PsimagLite::Vector<Entry*>::Type entries_;
+}; // class KronCache
+
+} // namespace Dmrg
+
+#endif // KRON_CACHE_H
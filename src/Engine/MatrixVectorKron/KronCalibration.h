@@ -0,0 +1,387 @@
+#ifndef KRON_CALIBRATION_H
+#define KRON_CALIBRATION_H
+
+#include "Vector.h"
+#include "TypeToString.h"
+#include "ProgressIndicator.h"
+#include "Concurrency.h"
+#include "../../KronUtil/MatrixDenseOrSparse.h"
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
+
+namespace Dmrg {
+
+// For SolverOptions=KronCalibrate. Times the KronUtil kernels on each pair
+// (A, B) of blocks that a Kron product uses, and keeps the storage of A and
+// of B, dense or sparse, and the method of estimate_kron_cost, 1, 2 or 3,
+// that are fastest on this host. This replaces denseSparseThreshold and
+// denseFlopDiscount for the pairs timed. Choices are kept by shape, and
+// saved to KronCalibration_<host>.txt, which later runs on the host read.
+// Timings vary from run to run, and so may the choices, and with them the
+// rounding of the products: runs that calibrate are not reproducible bit
+// for bit, only to rounding. One pair is timed at a time, so that timings
+// do not compete with each other; the products of other threads, if any,
+// still run meanwhile. Only the root rank writes the file, whole, to a
+// temporary file that then replaces it, so that a reader never sees it in
+// part; choices in the file from other runs are kept
+template<typename MatrixDenseOrSparseType>
+class KronCalibration {
+
+	typedef typename MatrixDenseOrSparseType::ComplexOrRealType ComplexOrRealType;
+	typedef typename MatrixDenseOrSparseType::RealType RealType;
+	typedef typename MatrixDenseOrSparseType::VectorType VectorType;
+
+public:
+
+	// methodN is for kron(A, B), methodT for kron(A^T, B^T); 0 means
+	// that kronMult picks the method
+	struct Choice {
+
+		Choice() : denseA(false), denseB(false), methodN(0), methodT(0) {}
+
+		bool denseA;
+		bool denseB;
+		int methodN;
+		int methodT;
+	};
+
+	static KronCalibration& instance()
+	{
+		static KronCalibration calibration;
+		return calibration;
+	}
+
+	// Sets the storage of a and b, and returns the methods. The transposed
+	// use is timed too if transposed is true; pairs too small to time are
+	// left as they are
+	Choice operator()(MatrixDenseOrSparseType& a,
+	                  MatrixDenseOrSparseType& b,
+	                  bool transposed)
+	{
+		Choice choice;
+		choice.denseA = a.isDense();
+		choice.denseB = b.isDense();
+		const SizeType nnzA = nonZeros(a);
+		const SizeType nnzB = nonZeros(b);
+		if (nnzA == 0 || nnzB == 0) return choice;
+		if (minFlops(a, b, nnzA, nnzB, 'n') < minFlops_) return choice;
+
+		const PsimagLite::String key = makeKey(a, b, nnzA, nnzB, transposed);
+		if (lookUp(choice, key)) {
+			a.setDense(choice.denseA);
+			b.setDense(choice.denseB);
+			return choice;
+		}
+
+		// one pair timed at a time; lookUp() and store() are not held up
+		std::lock_guard<std::mutex> timing(timingMutex_);
+		if (lookUp(choice, key)) {
+			a.setDense(choice.denseA);
+			b.setDense(choice.denseB);
+			return choice;
+		}
+
+		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		const char trans = (isComplex) ? 'c' : 't';
+		RealType bestTime = 0;
+		for (SizeType storage = 0; storage < 4; ++storage) {
+			const bool denseA = (storage & 1);
+			const bool denseB = (storage & 2);
+			if (!denseAllowed(a, nnzA, denseA) || !denseAllowed(b, nnzB, denseB))
+				continue;
+
+			a.setDense(denseA);
+			b.setDense(denseB);
+			int methodN = 0;
+			int methodT = 0;
+			RealType time = timeMethods(methodN, a, b, 'n');
+			if (transposed)
+				time += timeMethods(methodT, a, b, trans);
+
+			if (choice.methodN != 0 && time >= bestTime) continue;
+
+			bestTime = time;
+			choice.denseA = denseA;
+			choice.denseB = denseB;
+			choice.methodN = methodN;
+			choice.methodT = methodT;
+		}
+
+		store(choice, key);
+		a.setDense(choice.denseA);
+		b.setDense(choice.denseB);
+		return choice;
+	}
+
+	// pairs timed and pairs found in the cache since the last call; saves
+	// the choices if there are new ones
+	void report(PsimagLite::ProgressIndicator& progress)
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		PsimagLite::OstringStream msg;
+		msg<<"KronCalibration: "<<timed_<<" block pairs timed, "<<cached_;
+		msg<<" from "<<filename_<<" or earlier steps";
+		progress.printline(msg, std::cout);
+		if (timed_ > 0) save();
+		timed_ = cached_ = 0;
+	}
+
+private:
+
+	typedef std::map<PsimagLite::String, Choice> MapType;
+
+	KronCalibration()
+	    : filename_("KronCalibration_" + hostname() + ".txt"), timed_(0), cached_(0)
+	{
+		load(choices_);
+	}
+
+	KronCalibration(const KronCalibration&);
+
+	KronCalibration& operator=(const KronCalibration&);
+
+	bool lookUp(Choice& choice, const PsimagLite::String& key)
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		typename MapType::const_iterator it = choices_.find(key);
+		if (it == choices_.end()) return false;
+
+		++cached_;
+		choice = it->second;
+		return true;
+	}
+
+	// if another thread timed the same key meanwhile, choice becomes its
+	// choice, so that all pairs with a key agree
+	void store(Choice& choice, const PsimagLite::String& key)
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		typename MapType::const_iterator it = choices_.find(key);
+		if (it != choices_.end()) {
+			choice = it->second;
+			return;
+		}
+
+		choices_[key] = choice;
+		++timed_;
+	}
+
+	// choices from the file, if any
+	void load(MapType& choices) const
+	{
+		std::ifstream fin(filename_.c_str());
+		if (!fin || !fin.good()) return;
+
+		PsimagLite::String line;
+		while (std::getline(fin, line)) {
+			std::istringstream is(line);
+			PsimagLite::String key;
+			for (SizeType i = 0; i < keyFields_; ++i) {
+				PsimagLite::String field;
+				is>>field;
+				key += (i == 0) ? field : " " + field;
+			}
+
+			Choice choice;
+			is>>choice.denseA>>choice.denseB>>choice.methodN>>choice.methodT;
+			if (!is) continue;
+			choices[key] = choice;
+		}
+	}
+
+	// The file becomes the choices of other runs that it has now, and
+	// ours; a run that cannot save still has its choices. Called with the
+	// lock held
+	void save() const
+	{
+		if (!PsimagLite::Concurrency::root()) return;
+
+		MapType choices;
+		load(choices);
+		for (typename MapType::const_iterator it = choices_.begin();
+		     it != choices_.end();
+		     ++it)
+			choices[it->first] = it->second;
+
+		const PsimagLite::String tmp = filename_ + "." + ttos(getpid()) + ".tmp";
+		{
+			std::ofstream fout(tmp.c_str());
+			for (typename MapType::const_iterator it = choices.begin();
+			     it != choices.end();
+			     ++it) {
+				const Choice& choice = it->second;
+				fout<<it->first<<" "<<choice.denseA<<" "<<choice.denseB<<" ";
+				fout<<choice.methodN<<" "<<choice.methodT<<"\n";
+			}
+
+			if (!fout.good()) {
+				std::remove(tmp.c_str());
+				std::cerr<<"WARNING: KronCalibration: could not write "<<tmp<<"\n";
+				return;
+			}
+		}
+
+		if (std::rename(tmp.c_str(), filename_.c_str()) == 0) return;
+
+		std::remove(tmp.c_str());
+		std::cerr<<"WARNING: KronCalibration: could not replace "<<filename_<<"\n";
+	}
+
+	// Fastest method on op(a), op(b) with their storage now, and its time
+	// in milliseconds. Methods with many more flops than the least are not
+	// tried, as kron(A, B) visiting all non zeros on dense blocks
+	RealType timeMethods(int& best,
+	                     const MatrixDenseOrSparseType& a,
+	                     const MatrixDenseOrSparseType& b,
+	                     char trans) const
+	{
+		const bool noTrans = (trans == 'n');
+		const SizeType xsize = (noTrans) ? a.rows()*b.rows() : a.cols()*b.cols();
+		const SizeType ysize = (noTrans) ? a.cols()*b.cols() : a.rows()*b.rows();
+		VectorType x(xsize, 0.0);
+		VectorType y(ysize);
+		for (SizeType i = 0; i < ysize; ++i)
+			y[i] = 1.0/(1.0 + (i % 7));
+
+		RealType flops[3];
+		methodFlops(flops, a, b, nonZeros(a), nonZeros(b), trans);
+		const RealType least = std::min(flops[0], std::min(flops[1], flops[2]));
+
+		RealType bestTime = 0;
+		best = 0;
+		for (int imethod = 1; imethod <= 3; ++imethod) {
+			if (flops[imethod - 1] > pruneFactor_*least) continue;
+
+			SizeType repetitions = 0;
+			RealType millis = 0;
+			const PsimagLite::MemoryUsage::TimeHandle time1 =
+			        PsimagLite::ProgressIndicator::time();
+			do {
+				kronMultMethod(imethod, x, 0, y, 0, trans, trans, a, b, 1.0);
+				++repetitions;
+				const PsimagLite::MemoryUsage::TimeHandle time2 =
+				        PsimagLite::ProgressIndicator::time();
+				millis = (time2 - time1).millis();
+			} while (millis < minMillis_ && repetitions < maxRepetitions_);
+
+			const RealType time = millis/repetitions;
+			if (best != 0 && time >= bestTime) continue;
+			best = imethod;
+			bestTime = time;
+		}
+
+		return bestTime;
+	}
+
+	// flops of methods 1, 2 and 3 of estimate_kron_cost, with no discount
+	static void methodFlops(RealType* flops,
+	                        const MatrixDenseOrSparseType& a,
+	                        const MatrixDenseOrSparseType& b,
+	                        SizeType nnzA,
+	                        SizeType nnzB,
+	                        char trans)
+	{
+		const bool noTrans = (trans == 'n');
+		const RealType nrowA = (noTrans) ? a.rows() : a.cols();
+		const RealType ncolA = (noTrans) ? a.cols() : a.rows();
+		const RealType nrowB = (noTrans) ? b.rows() : b.cols();
+		const RealType ncolB = (noTrans) ? b.cols() : b.rows();
+		flops[0] = 2.0*nnzB*ncolA + 2.0*nnzA*nrowB;
+		flops[1] = 2.0*nnzA*ncolB + 2.0*nnzB*nrowA;
+		flops[2] = 2.0*nnzA*nnzB;
+	}
+
+	static RealType minFlops(const MatrixDenseOrSparseType& a,
+	                         const MatrixDenseOrSparseType& b,
+	                         SizeType nnzA,
+	                         SizeType nnzB,
+	                         char trans)
+	{
+		RealType flops[3];
+		methodFlops(flops, a, b, nnzA, nnzB, trans);
+		return std::min(flops[0], std::min(flops[1], flops[2]));
+	}
+
+	// no dense storage for blocks mostly zeros
+	static bool denseAllowed(const MatrixDenseOrSparseType& m, SizeType nnz, bool dense)
+	{
+		if (!dense || m.isDense()) return true;
+		return (maxDenseFill_*nnz >= m.rows()*m.cols());
+	}
+
+	// Non zeros of the values, not of the storage, so that the key does not
+	// depend on the storage the block had before
+	static SizeType nonZeros(const MatrixDenseOrSparseType& m)
+	{
+		if (m.isDense()) return countNonZeros(m.dense());
+		return m.sparse().nonZeros();
+	}
+
+	static SizeType countNonZeros(const PsimagLite::Matrix<ComplexOrRealType>& m)
+	{
+		SizeType count = 0;
+		for (SizeType j = 0; j < m.cols(); ++j)
+			for (SizeType i = 0; i < m.rows(); ++i)
+				if (m(i, j) != static_cast<ComplexOrRealType>(0.0)) ++count;
+		return count;
+	}
+
+	// shapes, and density as -log2(nnz/(rows*cols)), which is all the timing
+	// depends on besides the pattern
+	static PsimagLite::String makeKey(const MatrixDenseOrSparseType& a,
+	                                  const MatrixDenseOrSparseType& b,
+	                                  SizeType nnzA,
+	                                  SizeType nnzB,
+	                                  bool transposed)
+	{
+		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		PsimagLite::String key = (isComplex) ? "C" : "R";
+		key += ttos(sizeof(RealType)) + " " + ttos(transposed ? 1 : 0);
+		key += " " + ttos(a.rows()) + " " + ttos(a.cols()) + " ";
+		key += ttos(densityBucket(nnzA, a.rows()*a.cols()));
+		key += " " + ttos(b.rows()) + " " + ttos(b.cols()) + " ";
+		key += ttos(densityBucket(nnzB, b.rows()*b.cols()));
+		return key;
+	}
+
+	static SizeType densityBucket(SizeType nnz, SizeType total)
+	{
+		SizeType bucket = 0;
+		while (2*nnz <= total && nnz > 0) {
+			nnz *= 2;
+			++bucket;
+		}
+
+		return bucket;
+	}
+
+	static PsimagLite::String hostname()
+	{
+		char name[256];
+		if (gethostname(name, sizeof(name)) != 0) return "unknown";
+		name[sizeof(name) - 1] = '\0';
+		return name;
+	}
+
+	static const SizeType keyFields_ = 8;
+	static const SizeType maxRepetitions_ = 100;
+	static const SizeType maxDenseFill_ = 16;
+	static const SizeType pruneFactor_ = 8;
+	static const SizeType minFlops_ = 20000;
+	static const SizeType minMillis_ = 2;
+
+	std::mutex mutex_;
+	std::mutex timingMutex_;
+	PsimagLite::String filename_;
+	MapType choices_;
+	SizeType timed_;
+	SizeType cached_;
+}; // class KronCalibration
+
+} // namespace Dmrg
+
+#endif // KRON_CALIBRATION_H
@@ -96,9 +96,14 @@ class KronConnections {
 	typedef PsimagLite::Concurrency ConcurrencyType;
 	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename MatrixDenseOrSparseType::LowPrecisionType LowPrecisionType;
+	typedef typename LowPrecisionType::VectorType VectorLowType;
+	typedef typename PsimagLite::Vector<VectorLowType>::Type VectorVectorLowType;
 
 public:
 
+	static const SizeType NOT_HERE = static_cast<SizeType>(-1);
+
 	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
 	typedef typename MatrixDenseOrSparseType::VectorType VectorType;
 	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
@@ -107,24 +112,83 @@ public:
 	KronConnections(InitKronType& initKron)
 	    : initKron_(initKron),
 	      x_(initKron.xout()),
-	      y_(initKron.yin())
-	{}
+	      y_(initKron.yin()),
+	      k_(1),
+	      patchBegin_(0),
+	      patchEnd_(initKron.numberOfPatches(InitKronType::NEW)),
+	      xBase_(0),
+	      yOffsets_(0)
+	{
+		initLowPrecision();
+	}
+
+	// k vectors at once, x and y in patch order, see InitKronType::copyIn(),
+	// with the k vectors of each patch next to each other
+	KronConnections(InitKronType& initKron,
+	                VectorType& x,
+	                const VectorType& y,
+	                SizeType k)
+	    : initKron_(initKron),
+	      x_(x),
+	      y_(y),
+	      k_(k),
+	      patchBegin_(0),
+	      patchEnd_(initKron.numberOfPatches(InitKronType::NEW)),
+	      xBase_(0),
+	      yOffsets_(0)
+	{
+		initLowPrecision();
+	}
+
+	// One vector, output patches [patchBegin, patchEnd) only, with x holding
+	// only those patches, and inPatch at y[yOffsets[inPatch]], or not in y
+	// if yOffsets[inPatch] is NOT_HERE. See KronDistribution
+	KronConnections(InitKronType& initKron,
+	                VectorType& x,
+	                const VectorType& y,
+	                SizeType patchBegin,
+	                SizeType patchEnd,
+	                const VectorSizeType& yOffsets)
+	    : initKron_(initKron),
+	      x_(x),
+	      y_(y),
+	      k_(1),
+	      patchBegin_(patchBegin),
+	      patchEnd_(patchEnd),
+	      xBase_(initKron.offsetForPatches(InitKronType::NEW, patchBegin)),
+	      yOffsets_(&yOffsets)
+	{
+		initLowPrecision();
+	}
 
 	SizeType tasks() const
 	{
-		return initKron_.numberOfPatches(InitKronType::NEW);
+		return patchEnd_ - patchBegin_;
 	}
 
-	void doTask(SizeType outPatch, SizeType)
+	void doTask(SizeType taskNumber, SizeType threadNum)
 	{
 		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
 
+		const SizeType outPatch = patchBegin_ + taskNumber;
 		SizeType nC = initKron_.connections();
 		SizeType total = initKron_.numberOfPatches(InitKronType::OLD);
-		SizeType offsetX = initKron_.offsetForPatches(InitKronType::NEW, outPatch);
+		SizeType offsetX = k_*(initKron_.offsetForPatches(InitKronType::NEW, outPatch) - xBase_);
 		assert(offsetX < x_.size());
+		const bool lowPrecision = initKron_.lowPrecision();
+		VectorLowType* xLow = 0;
+		if (lowPrecision) {
+			assert(threadNum < xLow_.size());
+			xLow = &xLow_[threadNum];
+			const SizeType size = k_*(initKron_.offsetForPatches(InitKronType::NEW, outPatch + 1) -
+			                          initKron_.offsetForPatches(InitKronType::NEW, outPatch));
+			xLow->resize(size);
+		}
+
 		for (SizeType inPatch=0;inPatch<total;++inPatch) {
-			SizeType offsetY = initKron_.offsetForPatches(InitKronType::OLD, inPatch);
+			SizeType offsetY = (yOffsets_) ? (*yOffsets_)[inPatch] :
+			                                 k_*initKron_.offsetForPatches(InitKronType::OLD, inPatch);
+			if (yOffsets_ && offsetY == NOT_HERE) continue;
 			assert(offsetY < y_.size());
 			for (SizeType ic=0;ic<nC;++ic) {
 				const ArrayOfMatStructType& xiStruct = initKron_.xc(ic);
@@ -145,15 +209,23 @@ public:
 					initKron_.checks(Amat, Bmat, outPatch, inPatch);
 
 				const char opt = performTranspose ? (isComplex ? 'c': 't') : 'n';
-				kronMult(x_,
-				         offsetX,
-				         y_,
+				const int imethod = initKron_.kronMethod(ic, outPatch, inPatch);
+				if (!lowPrecision) {
+					multiply(x_, offsetX, y_, offsetY, opt, imethod, Amat, Bmat);
+					continue;
+				}
+
+				std::fill(xLow->begin(), xLow->end(), 0.0);
+				multiply(*xLow,
+				         0,
+				         yLow_,
 				         offsetY,
 				         opt,
-				         opt,
-				         Amat,
-				         Bmat,
-				         initKron_.denseFlopDiscount());
+				         imethod,
+				         Amat.lowPrecision(),
+				         Bmat.lowPrecision());
+				for (SizeType i = 0; i < xLow->size(); ++i)
+					x_[offsetX + i] += (*xLow)[i];
 			}
 		}
 	}
@@ -162,6 +234,56 @@ public:
 
 private:
 
+	// the whole of y, once, and a per-thread buffer for one output patch;
+	// only each kernel product is in LowComplexOrRealType, the sums over
+	// connections and input patches are in x_
+	void initLowPrecision()
+	{
+		if (!initKron_.lowPrecision()) return;
+
+		yLow_.resize(y_.size());
+		for (SizeType i = 0; i < y_.size(); ++i)
+			yLow_[i] = typename LowPrecisionType::value_type(y_[i]);
+
+		xLow_.resize(initKron_.codeSectionParams().npthreads);
+	}
+
+	// imethod is from InitKronBase::kronMethod(); products of k_ > 1 vectors
+	// have their own choice of method
+	template<typename SomeMatrixDenseOrSparseType>
+	void multiply(typename SomeMatrixDenseOrSparseType::VectorType& x,
+	              SizeType offsetX,
+	              const typename SomeMatrixDenseOrSparseType::VectorType& y,
+	              SizeType offsetY,
+	              char opt,
+	              int imethod,
+	              const SomeMatrixDenseOrSparseType& Amat,
+	              const SomeMatrixDenseOrSparseType& Bmat) const
+	{
+		if (k_ == 1)
+			kronMultMethod(imethod,
+			               x,
+			               offsetX,
+			               y,
+			               offsetY,
+			               opt,
+			               opt,
+			               Amat,
+			               Bmat,
+			               initKron_.denseFlopDiscount());
+		else
+			kronMultMulti(x,
+			              offsetX,
+			              y,
+			              offsetY,
+			              k_,
+			              opt,
+			              opt,
+			              Amat,
+			              Bmat,
+			              initKron_.denseFlopDiscount());
+	}
+
 	// disable copy ctor
 	KronConnections(const KronConnections&);
 
@@ -171,6 +293,13 @@ private:
 	const InitKronType& initKron_;
 	VectorType& x_;
 	const VectorType& y_;
+	SizeType k_;
+	SizeType patchBegin_;
+	SizeType patchEnd_;
+	SizeType xBase_;
+	const VectorSizeType* yOffsets_;
+	VectorLowType yLow_;
+	VectorVectorLowType xLow_;
 }; //class KronConnections
 
 } // namespace PsimagLite
@@ -0,0 +1,334 @@
+#ifndef KRON_CONNECTIONS_STEALING_H
+#define KRON_CONNECTIONS_STEALING_H
+
+#include "Matrix.h"
+#include "Concurrency.h"
+#include "KronUtilWrapper.h"
+#include <deque>
+#include <mutex>
+#include <algorithm>
+
+namespace Dmrg {
+
+// Alternative to KronConnections for SolverOptions=KronWorkStealing.
+// Work is split into (outPatch, range of inPatches) tasks of similar cost,
+// costs are from estimate_kron_cost. Each worker has a deque of tasks, and
+// steals from the others when its own is empty. Tasks sharing an outPatch
+// compute into a scratch vector and add it to xout under that patch's lock
+template<typename InitKronType>
+class KronConnectionsStealing {
+
+	typedef typename InitKronType::SparseMatrixType SparseMatrixType;
+	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
+	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
+	typedef typename InitKronType::RealType RealType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<VectorSizeType>::Type VectorVectorSizeType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+
+public:
+
+	typedef typename MatrixDenseOrSparseType::VectorType VectorType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+
+	struct Task {
+
+		Task(SizeType outPatch_, SizeType inBegin_, SizeType inEnd_, RealType cost_)
+		    : outPatch(outPatch_), inBegin(inBegin_), inEnd(inEnd_), cost(cost_)
+		{}
+
+		SizeType outPatch;
+		SizeType inBegin;
+		SizeType inEnd;
+		RealType cost;
+	};
+
+	typedef typename PsimagLite::Vector<Task>::Type VectorTaskType;
+
+	// Built once per Kron matrix, and used by all its matrix vector products
+	class Schedule {
+
+	public:
+
+		Schedule(const InitKronType& initKron, SizeType workers)
+		    : workers_((workers == 0) ? 1 : workers),
+		      splitOutPatch_(initKron.numberOfPatches(InitKronType::NEW), false),
+		      initial_(workers_),
+		      scratch_(workers_)
+		{
+			const SizeType nout = initKron.numberOfPatches(InitKronType::NEW);
+			const SizeType nin = initKron.numberOfPatches(InitKronType::OLD);
+
+			VectorVectorRealType costs(nout);
+			RealType total = 0;
+			for (SizeType outPatch = 0; outPatch < nout; ++outPatch) {
+				costs[outPatch].resize(nin, 0);
+				for (SizeType inPatch = 0; inPatch < nin; ++inPatch) {
+					costs[outPatch][inPatch] = cost(initKron, outPatch, inPatch);
+					total += costs[outPatch][inPatch];
+				}
+			}
+
+			// a few tasks per worker, so that stealing has something to take
+			const RealType target = total/(workers_*tasksPerWorker_);
+			SizeType maxSplitSize = 0;
+			for (SizeType outPatch = 0; outPatch < nout; ++outPatch) {
+				SizeType begin = 0;
+				RealType sum = 0;
+				const SizeType before = tasks_.size();
+				for (SizeType inPatch = 0; inPatch < nin; ++inPatch) {
+					sum += costs[outPatch][inPatch];
+					if (sum < target && inPatch + 1 < nin) continue;
+					tasks_.push_back(Task(outPatch, begin, inPatch + 1, sum));
+					begin = inPatch + 1;
+					sum = 0;
+				}
+
+				if (tasks_.size() - before < 2) continue;
+				splitOutPatch_[outPatch] = true;
+				maxSplitSize = std::max(maxSplitSize, outPatchSize(initKron, outPatch));
+			}
+
+			// largest first, each to the least loaded worker
+			VectorSizeType order(tasks_.size());
+			for (SizeType i = 0; i < order.size(); ++i) order[i] = i;
+			std::sort(order.begin(), order.end(), CostGreater(tasks_));
+			VectorRealType load(workers_, 0);
+			for (SizeType i = 0; i < order.size(); ++i) {
+				SizeType w = std::min_element(load.begin(), load.end()) - load.begin();
+				initial_[w].push_back(order[i]);
+				load[w] += tasks_[order[i]].cost;
+			}
+
+			for (SizeType w = 0; w < workers_; ++w)
+				scratch_[w].resize(maxSplitSize);
+		}
+
+		SizeType workers() const { return workers_; }
+
+		const VectorTaskType& tasks() const { return tasks_; }
+
+		bool splitOutPatch(SizeType outPatch) const
+		{
+			assert(outPatch < splitOutPatch_.size());
+			return splitOutPatch_[outPatch];
+		}
+
+		const VectorSizeType& initial(SizeType worker) const
+		{
+			assert(worker < initial_.size());
+			return initial_[worker];
+		}
+
+		// each worker touches only its own
+		VectorType& scratch(SizeType worker) const
+		{
+			assert(worker < scratch_.size());
+			return scratch_[worker];
+		}
+
+	private:
+
+		typedef typename PsimagLite::Vector<VectorRealType>::Type VectorVectorRealType;
+
+		class CostGreater {
+
+		public:
+
+			CostGreater(const VectorTaskType& tasks) : tasks_(tasks) {}
+
+			bool operator()(SizeType a, SizeType b) const
+			{
+				return (tasks_[a].cost > tasks_[b].cost);
+			}
+
+		private:
+
+			const VectorTaskType& tasks_;
+		};
+
+		// flops of all connections from inPatch to outPatch, plus the size
+		// of the output, so that no task is free
+		static RealType cost(const InitKronType& initKron,
+		                     SizeType outPatch,
+		                     SizeType inPatch)
+		{
+			const SizeType nC = initKron.connections();
+			const bool performTranspose = (initKron.useLowerPart() && (outPatch < inPatch));
+			const SizeType o = (performTranspose) ? inPatch : outPatch;
+			const SizeType i = (performTranspose) ? outPatch : inPatch;
+			RealType sum = 0;
+			for (SizeType ic = 0; ic < nC; ++ic) {
+				const MatrixDenseOrSparseType& a = initKron.xc(ic)(o, i);
+				const MatrixDenseOrSparseType& b = initKron.yc(ic)(o, i);
+				const SizeType nnzA = nonZeros(a);
+				const SizeType nnzB = nonZeros(b);
+				if (nnzA == 0 || nnzB == 0) continue;
+
+				ComplexOrRealType kronNnz = 0.0;
+				ComplexOrRealType kronFlops = 0.0;
+				int imethod = 0;
+				estimate_kron_cost(a.rows(),
+				                   a.cols(),
+				                   nnzA,
+				                   b.rows(),
+				                   b.cols(),
+				                   nnzB,
+				                   &kronNnz,
+				                   &kronFlops,
+				                   &imethod,
+				                   initKron.denseFlopDiscount());
+				sum += std::real(kronFlops);
+			}
+
+			return sum + outPatchSize(initKron, outPatch);
+		}
+
+		static SizeType nonZeros(const MatrixDenseOrSparseType& m)
+		{
+			return (m.isDense()) ? m.rows()*m.cols() : m.sparse().nonZeros();
+		}
+
+		static SizeType outPatchSize(const InitKronType& initKron, SizeType outPatch)
+		{
+			return initKron.offsetForPatches(InitKronType::NEW, outPatch + 1) -
+			        initKron.offsetForPatches(InitKronType::NEW, outPatch);
+		}
+
+		static const SizeType tasksPerWorker_ = 4;
+
+		SizeType workers_;
+		VectorTaskType tasks_;
+		typename PsimagLite::Vector<bool>::Type splitOutPatch_;
+		VectorVectorSizeType initial_;
+		mutable VectorVectorType scratch_;
+	};
+
+	KronConnectionsStealing(InitKronType& initKron,
+	                        const Schedule& schedule,
+	                        VectorType& x,
+	                        const VectorType& y)
+	    : initKron_(initKron),
+	      schedule_(schedule),
+	      x_(x),
+	      y_(y),
+	      deques_(schedule.workers()),
+	      dequeMutexes_(schedule.workers()),
+	      patchMutexes_(initKron.numberOfPatches(InitKronType::NEW))
+	{
+		for (SizeType w = 0; w < deques_.size(); ++w) {
+			const VectorSizeType& initial = schedule_.initial(w);
+			deques_[w].assign(initial.begin(), initial.end());
+		}
+	}
+
+	// one task per worker; each one runs until there is nothing to steal
+	SizeType tasks() const { return schedule_.workers(); }
+
+	void doTask(SizeType worker, SizeType)
+	{
+		SizeType taskIndex = 0;
+		while (nextTask(taskIndex, worker))
+			runTask(schedule_.tasks()[taskIndex], worker);
+	}
+
+	void sync() {}
+
+private:
+
+	// own tasks from the front, largest first; stolen ones from the back
+	bool nextTask(SizeType& taskIndex, SizeType worker)
+	{
+		const SizeType workers = deques_.size();
+		for (SizeType i = 0; i < workers; ++i) {
+			const SizeType w = (worker + i) % workers;
+			std::lock_guard<std::mutex> guard(dequeMutexes_[w]);
+			if (deques_[w].empty()) continue;
+			if (i == 0) {
+				taskIndex = deques_[w].front();
+				deques_[w].pop_front();
+			} else {
+				taskIndex = deques_[w].back();
+				deques_[w].pop_back();
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void runTask(const Task& task, SizeType worker)
+	{
+		const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+		const SizeType outPatch = task.outPatch;
+		const SizeType offsetX = initKron_.offsetForPatches(InitKronType::NEW, outPatch);
+		const bool split = schedule_.splitOutPatch(outPatch);
+		const SizeType size = initKron_.offsetForPatches(InitKronType::NEW, outPatch + 1) -
+		        offsetX;
+
+		VectorType& scratch = schedule_.scratch(worker);
+		if (split)
+			std::fill(scratch.begin(), scratch.begin() + size, 0.0);
+
+		VectorType& xout = (split) ? scratch : x_;
+		const SizeType offsetOut = (split) ? 0 : offsetX;
+
+		const SizeType nC = initKron_.connections();
+		for (SizeType inPatch = task.inBegin; inPatch < task.inEnd; ++inPatch) {
+			SizeType offsetY = initKron_.offsetForPatches(InitKronType::OLD, inPatch);
+			assert(offsetY < y_.size());
+			for (SizeType ic = 0; ic < nC; ++ic) {
+				const ArrayOfMatStructType& xiStruct = initKron_.xc(ic);
+				const ArrayOfMatStructType& yiStruct = initKron_.yc(ic);
+
+				const bool performTranspose = (initKron_.useLowerPart() &&
+				                               (outPatch < inPatch));
+
+				const MatrixDenseOrSparseType& Amat =  performTranspose ?
+				            xiStruct(inPatch,outPatch): xiStruct(outPatch,inPatch);
+
+				const MatrixDenseOrSparseType& Bmat =  performTranspose ?
+				            yiStruct(inPatch,outPatch) : yiStruct(outPatch,inPatch);
+
+				if (!performTranspose)
+					initKron_.checks(Amat, Bmat, outPatch, inPatch);
+
+				const char opt = performTranspose ? (isComplex ? 'c': 't') : 'n';
+				kronMultMethod(initKron_.kronMethod(ic, outPatch, inPatch),
+				               xout,
+				               offsetOut,
+				               y_,
+				               offsetY,
+				               opt,
+				               opt,
+				               Amat,
+				               Bmat,
+				               initKron_.denseFlopDiscount());
+			}
+		}
+
+		if (!split) return;
+
+		std::lock_guard<std::mutex> guard(patchMutexes_[outPatch]);
+		for (SizeType i = 0; i < size; ++i)
+			x_[offsetX + i] += scratch[i];
+	}
+
+	KronConnectionsStealing(const KronConnectionsStealing&);
+
+	KronConnectionsStealing& operator=(const KronConnectionsStealing&);
+
+	const InitKronType& initKron_;
+	const Schedule& schedule_;
+	VectorType& x_;
+	const VectorType& y_;
+	typename PsimagLite::Vector<std::deque<SizeType> >::Type deques_;
+	std::vector<std::mutex> dequeMutexes_;
+	std::vector<std::mutex> patchMutexes_;
+}; //class KronConnectionsStealing
+
+} // namespace Dmrg
+
+#endif // KRON_CONNECTIONS_STEALING_H
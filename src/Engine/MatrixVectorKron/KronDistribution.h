@@ -0,0 +1,339 @@
+#ifndef KRON_DISTRIBUTION_H
+#define KRON_DISTRIBUTION_H
+
+#include "Vector.h"
+#include "Mpi.h"
+#include "ProgressIndicator.h"
+#include "KronConnections.h"
+#include <limits>
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+namespace Dmrg {
+
+// For SolverOptions=KronMpi. Each MPI rank has the range of output patches
+// of InitKronBase::distribute(), and the blocks of that range only. A rank's
+// rows of a vector in patch order are a slice of it. A rank's product needs
+// only the input patches that its blocks connect to its output patches;
+// exchange() brings those from the ranks that have them, and nothing else.
+// Each exchange is one MPI_Alltoallv, and gather() is one MPI_Allgatherv
+template<typename InitKronType>
+class KronDistribution {
+
+	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
+	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
+	typedef typename PsimagLite::Vector<bool>::Type VectorBoolType;
+	typedef typename PsimagLite::Vector<VectorBoolType>::Type VectorVectorBoolType;
+	typedef PsimagLite::Vector<int>::Type VectorIntType;
+
+public:
+
+	typedef typename MatrixDenseOrSparseType::VectorType VectorType;
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef KronConnections<InitKronType> KronConnectionsType;
+
+	KronDistribution(const InitKronType& initKron)
+	    : initKron_(initKron),
+	      progress_("KronDistribution"),
+	      ranks_(PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD)),
+	      rank_(PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD)),
+	      rangeBegin_(initKron.patchRanges()),
+	      neededBy_(ranks_),
+	      yOffsets_(initKron.numberOfPatches(InitKronType::OLD), KronConnectionsType::NOT_HERE),
+	      ySize_(0)
+	{
+		assert(rangeBegin_.size() == ranks_ + 1);
+		assert(patchBegin() == initKron.patchBegin() && patchEnd() == initKron.patchEnd());
+		setNeeds();
+
+		const SizeType npatch = yOffsets_.size();
+		for (SizeType p = 0; p < npatch; ++p) {
+			if (!needs_[p]) continue;
+			yOffsets_[p] = ySize_;
+			ySize_ += patchSize(p);
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"rank "<<rank_<<" of "<<ranks_<<" has patches ["<<patchBegin()<<", ";
+		msg<<patchEnd()<<") of "<<npatch<<", rows "<<localSize()<<" of ";
+		msg<<initKron.size(InitKronType::NEW)<<", needs "<<ySize_<<" rows of y";
+		progress_.printline(msg, std::cout);
+	}
+
+	SizeType patchBegin() const { return rangeBegin_[rank_]; }
+
+	SizeType patchEnd() const { return rangeBegin_[rank_ + 1]; }
+
+	// where this rank's rows start in a vector in patch order
+	SizeType localOffset() const
+	{
+		return initKron_.offsetForPatches(InitKronType::NEW, patchBegin());
+	}
+
+	SizeType localSize() const
+	{
+		return initKron_.offsetForPatches(InitKronType::NEW, patchEnd()) - localOffset();
+	}
+
+	// where each input patch is in the y of exchange()
+	const VectorSizeType& yOffsets() const { return yOffsets_; }
+
+	// y = the input patches this rank needs, given this rank's rows yLocal;
+	// every rank must call this at the same time
+	void exchange(VectorType& y, const VectorType& yLocal) const
+	{
+		assert(yLocal.size() == localSize());
+		y.resize(ySize_);
+		for (SizeType p = patchBegin(); p < patchEnd(); ++p) {
+			if (yOffsets_[p] == KronConnectionsType::NOT_HERE) continue;
+			const SizeType offset = initKron_.offsetForPatches(InitKronType::OLD, p) -
+			        localOffset();
+			const SizeType size = patchSize(p);
+			for (SizeType i = 0; i < size; ++i)
+				y[yOffsets_[p] + i] = yLocal[offset + i];
+		}
+
+		// for each rank r, this rank's patches that r needs, in order
+		VectorSizeType sendCounts(ranks_, 0);
+		sendBuffer_.clear();
+		for (SizeType r = 0; r < ranks_; ++r) {
+			if (r == rank_) continue;
+			for (SizeType p = patchBegin(); p < patchEnd(); ++p) {
+				if (!neededBy_[r][p - patchBegin()]) continue;
+				const SizeType offset = initKron_.offsetForPatches(InitKronType::OLD, p) -
+				        localOffset();
+				sendBuffer_.insert(sendBuffer_.end(),
+				                   yLocal.begin() + offset,
+				                   yLocal.begin() + offset + patchSize(p));
+				sendCounts[r] += patchSize(p);
+			}
+		}
+
+		allToAll(recvBuffer_, recvCounts_, sendBuffer_, sendCounts);
+
+		SizeType offset = 0;
+		for (SizeType r = 0; r < ranks_; ++r) {
+			if (r == rank_) continue;
+			for (SizeType p = rangeBegin_[r]; p < rangeBegin_[r + 1]; ++p) {
+				if (!needs_[p]) continue;
+				const SizeType size = patchSize(p);
+				for (SizeType i = 0; i < size; ++i)
+					y[yOffsets_[p] + i] = recvBuffer_[offset + i];
+				offset += size;
+			}
+		}
+
+		assert(offset == recvBuffer_.size());
+	}
+
+	// x += the vector in patch order whose slice on each rank is that rank's
+	// xLocal. Every rank gets all of it, because only the preconditioned
+	// solver keeps vectors distributed; see MatrixVectorKron::distributed().
+	// Every rank must call this at the same time
+	void gather(VectorType& x, const VectorType& xLocal) const
+	{
+		assert(xLocal.size() == localSize());
+		const SizeType total = initKron_.size(InitKronType::NEW);
+		assert(x.size() == total);
+		VectorSizeType counts(ranks_);
+		for (SizeType r = 0; r < ranks_; ++r)
+			counts[r] = initKron_.offsetForPatches(InitKronType::NEW, rangeBegin_[r + 1]) -
+			        initKron_.offsetForPatches(InitKronType::NEW, rangeBegin_[r]);
+
+		recvBuffer_.resize(total);
+		allGather(recvBuffer_, counts, xLocal);
+		for (SizeType i = 0; i < total; ++i)
+			x[i] += recvBuffer_[i];
+	}
+
+	// v = the sum over ranks of v, for the scalar products of the solver
+	static void sum(VectorType& v)
+	{
+		PsimagLite::MPI::allReduce(v);
+	}
+
+private:
+
+	KronDistribution(const KronDistribution&);
+
+	KronDistribution& operator=(const KronDistribution&);
+
+	// needs_[p] is true if this rank needs input patch p, from its own
+	// blocks; neededBy_[r][p - patchBegin()] is true if rank r needs this
+	// rank's patch p, which rank r says
+	void setNeeds()
+	{
+		const SizeType npatch = initKron_.numberOfPatches(InitKronType::OLD);
+		needs_.resize(npatch, false);
+		for (SizeType outPatch = patchBegin(); outPatch < patchEnd(); ++outPatch) {
+			for (SizeType inPatch = 0; inPatch < npatch; ++inPatch) {
+				if (needs_[inPatch]) continue;
+				needs_[inPatch] = connects(outPatch, inPatch);
+			}
+		}
+
+		const SizeType mine = patchEnd() - patchBegin();
+		for (SizeType r = 0; r < ranks_; ++r)
+			neededBy_[r].resize(mine, false);
+
+		// to each rank r, which of its patches this rank needs, as 0 or 1
+		VectorIntType sendBuffer;
+		VectorSizeType sendCounts(ranks_, 0);
+		VectorSizeType recvCounts(ranks_, 0);
+		for (SizeType r = 0; r < ranks_; ++r) {
+			if (r == rank_) continue;
+			for (SizeType p = rangeBegin_[r]; p < rangeBegin_[r + 1]; ++p)
+				sendBuffer.push_back((needs_[p]) ? 1 : 0);
+			sendCounts[r] = rangeBegin_[r + 1] - rangeBegin_[r];
+			recvCounts[r] = mine;
+		}
+
+		VectorIntType recvBuffer;
+		allToAll(recvBuffer, recvCounts, sendBuffer, sendCounts);
+
+		SizeType offset = 0;
+		for (SizeType r = 0; r < ranks_; ++r) {
+			if (r == rank_) continue;
+			for (SizeType i = 0; i < mine; ++i)
+				neededBy_[r][i] = (recvBuffer[offset + i] == 1);
+			offset += mine;
+		}
+
+		// rows of y that exchange() receives from each rank
+		recvCounts_.assign(ranks_, 0);
+		for (SizeType r = 0; r < ranks_; ++r) {
+			if (r == rank_) continue;
+			for (SizeType p = rangeBegin_[r]; p < rangeBegin_[r + 1]; ++p)
+				if (needs_[p]) recvCounts_[r] += patchSize(p);
+		}
+	}
+
+	// recv = what each rank sent this rank, in order of rank, given what this
+	// rank sends each rank, also in order of rank; counts are in elements.
+	// Sends bytes, so it works for real and complex, of any precision
+	template<typename SomeVectorType>
+	void allToAll(SomeVectorType& recv,
+	              const VectorSizeType& recvCounts,
+	              const SomeVectorType& send,
+	              const VectorSizeType& sendCounts) const
+	{
+		assert(recvCounts.size() == ranks_ && sendCounts.size() == ranks_);
+		SizeType total = 0;
+		for (SizeType r = 0; r < ranks_; ++r)
+			total += recvCounts[r];
+
+		recv.resize(total);
+
+#ifdef USE_MPI
+		const SizeType bytes = sizeof(typename SomeVectorType::value_type);
+		VectorIntType sendBytes;
+		VectorIntType sendDispl;
+		VectorIntType recvBytes;
+		VectorIntType recvDispl;
+		toBytes(sendBytes, sendDispl, sendCounts, bytes);
+		toBytes(recvBytes, recvDispl, recvCounts, bytes);
+		MPI_Alltoallv(const_cast<typename SomeVectorType::value_type*>(send.data()),
+		              sendBytes.data(),
+		              sendDispl.data(),
+		              MPI_BYTE,
+		              recv.data(),
+		              recvBytes.data(),
+		              recvDispl.data(),
+		              MPI_BYTE,
+		              MPI_COMM_WORLD);
+#else
+		if (total > 0 || send.size() > 0)
+			err("KronDistribution: more than one rank needs a build with MPI\n");
+#endif
+	}
+
+	// all = the slices of all ranks, in order of rank; counts in elements
+	void allGather(VectorType& all,
+	               const VectorSizeType& counts,
+	               const VectorType& mine) const
+	{
+		assert(counts.size() == ranks_ && counts[rank_] == mine.size());
+
+#ifdef USE_MPI
+		const SizeType bytes = sizeof(typename VectorType::value_type);
+		VectorIntType allBytes;
+		VectorIntType allDispl;
+		toBytes(allBytes, allDispl, counts, bytes);
+		MPI_Allgatherv(const_cast<typename VectorType::value_type*>(mine.data()),
+		               allBytes[rank_],
+		               MPI_BYTE,
+		               all.data(),
+		               allBytes.data(),
+		               allDispl.data(),
+		               MPI_BYTE,
+		               MPI_COMM_WORLD);
+#else
+		all = mine;
+#endif
+	}
+
+	// MPI counts and displacements are int
+	static void toBytes(VectorIntType& bytes,
+	                    VectorIntType& displ,
+	                    const VectorSizeType& counts,
+	                    SizeType sizeOfElement)
+	{
+		const SizeType n = counts.size();
+		bytes.resize(n);
+		displ.resize(n);
+		SizeType sum = 0;
+		for (SizeType r = 0; r < n; ++r) {
+			const SizeType b = counts[r]*sizeOfElement;
+			if (sum + b > static_cast<SizeType>(std::numeric_limits<int>::max()))
+				err("KronDistribution: messages over 2GB are not supported\n");
+			bytes[r] = b;
+			displ[r] = sum;
+			sum += b;
+		}
+	}
+
+	// true if some connection has blocks from inPatch to outPatch
+	bool connects(SizeType outPatch, SizeType inPatch) const
+	{
+		const bool performTranspose = (initKron_.useLowerPart() && outPatch < inPatch);
+		const SizeType o = (performTranspose) ? inPatch : outPatch;
+		const SizeType i = (performTranspose) ? outPatch : inPatch;
+		for (SizeType ic = 0; ic < initKron_.connections(); ++ic) {
+			if (isEmpty(initKron_.xc(ic)(o, i))) continue;
+			if (isEmpty(initKron_.yc(ic)(o, i))) continue;
+			return true;
+		}
+
+		return false;
+	}
+
+	// dense blocks read all of their input, so they count even if zero
+	static bool isEmpty(const MatrixDenseOrSparseType& m)
+	{
+		return (!m.isDense() && m.sparse().nonZeros() == 0);
+	}
+
+	SizeType patchSize(SizeType p) const
+	{
+		return initKron_.offsetForPatches(InitKronType::OLD, p + 1) -
+		        initKron_.offsetForPatches(InitKronType::OLD, p);
+	}
+
+	const InitKronType& initKron_;
+	PsimagLite::ProgressIndicator progress_;
+	SizeType ranks_;
+	SizeType rank_;
+	VectorSizeType rangeBegin_;
+	VectorBoolType needs_;
+	VectorVectorBoolType neededBy_;
+	VectorSizeType yOffsets_;
+	SizeType ySize_;
+	VectorSizeType recvCounts_;
+	mutable VectorType sendBuffer_;
+	mutable VectorType recvBuffer_;
+}; // class KronDistribution
+
+} // namespace Dmrg
+
+#endif // KRON_DISTRIBUTION_H
@@ -81,6 +81,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 #include "Matrix.h"
 #include "KronConnections.h"
+#include "KronConnectionsStealing.h"
+#include "KronDistribution.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
 #include "PsimagLite.h"
@@ -99,8 +101,11 @@ class KronMatrix {
 	typedef typename InitKronType::SparseMatrixType SparseMatrixType;
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef KronConnections<InitKronType> KronConnectionsType;
+	typedef KronConnectionsStealing<InitKronType> KronConnectionsStealingType;
+	typedef typename KronConnectionsStealingType::Schedule ScheduleType;
 	typedef typename KronConnectionsType::MatrixType MatrixType;
 	typedef typename KronConnectionsType::VectorType VectorType;
+	typedef typename KronConnectionsType::VectorVectorType VectorVectorType;
 	typedef typename InitKronType::ArrayOfMatStructType ArrayOfMatStructType;
 	typedef typename InitKronType::GenIjPatchType GenIjPatchType;
 	typedef typename ArrayOfMatStructType::MatrixDenseOrSparseType MatrixDenseOrSparseType;
@@ -110,38 +115,88 @@ class KronMatrix {
 
 public:
 
+	typedef KronDistribution<InitKronType> KronDistributionType;
+
 	KronMatrix(InitKronType& initKron, PsimagLite::String name)
 	    : initKron_(initKron),
 	      progress_("KronMatrix"),
-	      batchedGemm_(initKron)
+	      batchedGemm_(initKron),
+	      schedule_(0),
+	      distribution_(0)
 	{
+		// initKron has only the blocks of this rank's patches
+		if (initKron.distributed())
+			distribution_ = new KronDistributionType(initKron);
+
+		if (initKron.workStealing() && !batchedGemm_.enabled() && !distribution_)
+			schedule_ = new ScheduleType(initKron,
+			                             initKron.codeSectionParams().npthreads);
+
 		PsimagLite::String str((initKron.loadBalance()) ? "true" : "false");
 		PsimagLite::OstringStream msg;
 		msg<<"KronMatrix: "<<name<<" sizes="<<initKron.size(InitKronType::NEW);
 		msg<<" "<<initKron.size(InitKronType::OLD);
 		msg<<" loadBalance "<<str;
+		if (schedule_)
+			msg<<" workStealing tasks="<<schedule_->tasks().size();
+		if (distribution_)
+			msg<<" mpi";
 		progress_.printline(msg, std::cout);
 	}
 
+	~KronMatrix()
+	{
+		delete schedule_;
+		schedule_ = 0;
+		delete distribution_;
+		distribution_ = 0;
+	}
+
 	void matrixVectorProduct(VectorType& vout, const VectorType& vin) const
 	{
 		initKron_.copyIn(vout, vin);
+		matrixVectorProductPatchOrder(initKron_.xout(), initKron_.yin());
+		initKron_.copyOut(vout);
+	}
 
+	// vout += H*vin, with vout and vin already in patch order,
+	// see InitKronType::toPatchOrder()
+	void matrixVectorProductPatchOrder(VectorType& vout, const VectorType& vin) const
+	{
 		if (batchedGemm_.enabled()) {
-			VectorType& xout = initKron_.xout();
-			VectorType xoutTmp(xout.size(), 0.0);
-			batchedGemm_.matrixVector(xoutTmp, initKron_.yin());
+			VectorType xoutTmp(vout.size(), 0.0);
+			batchedGemm_.matrixVector(xoutTmp, vin);
 			for(SizeType i = 0; i < xoutTmp.size(); ++i)
-				xout[i] += xoutTmp[i];
+				vout[i] += xoutTmp[i];
+
+			return;
+		}
 
-			initKron_.copyOut(vout);
+		// each rank does its rows, and then gets those of the other ranks;
+		// for the solvers that need whole vectors, see KronDistribution::gather()
+		if (distribution_) {
+			const SizeType offset = distribution_->localOffset();
+			const SizeType size = distribution_->localSize();
+			VectorType xLocal(size, 0.0);
+			VectorType yLocal(vin.begin() + offset, vin.begin() + offset + size);
+			matrixVectorProductLocal(xLocal, yLocal);
+			distribution_->gather(vout, xLocal);
 			return;
 		}
 
-		KronConnectionsType kc(initKron_);
+		if (schedule_) {
+			KronConnectionsStealingType kcs(initKron_, *schedule_, vout, vin);
+			typedef PsimagLite::Parallelizer<KronConnectionsStealingType> ParallelizerType;
+			ParallelizerType parallelConnections(initKron_.codeSectionParams());
+			parallelConnections.loopCreate(kcs);
+			kcs.sync();
+			return;
+		}
+
+		KronConnectionsType kc(initKron_, vout, vin, 1);
 
 		typedef PsimagLite::Parallelizer<KronConnectionsType> ParallelizerType;
-		ParallelizerType parallelConnections(PsimagLite::Concurrency::codeSectionParams);
+		ParallelizerType parallelConnections(initKron_.codeSectionParams());
 
 		if (initKron_.loadBalance())
 			parallelConnections.loopCreate(kc, initKron_.weightsOfPatchesNew());
@@ -149,8 +204,77 @@ public:
 			parallelConnections.loopCreate(kc);
 
 		kc.sync();
+	}
 
-		initKron_.copyOut(vout);
+	// With SolverOptions=KronMpi, xLocal += H*y restricted to this rank's
+	// rows, given yLocal, this rank's rows of y; both in patch order. Every
+	// rank must call this at the same time. See KronDistribution
+	void matrixVectorProductLocal(VectorType& xLocal, const VectorType& yLocal) const
+	{
+		if (!distribution_)
+			err("KronMatrix::matrixVectorProductLocal() needs KronMpi and MPI ranks\n");
+
+		distribution_->exchange(yNeeded_, yLocal);
+		KronConnectionsType kc(initKron_,
+		                       xLocal,
+		                       yNeeded_,
+		                       distribution_->patchBegin(),
+		                       distribution_->patchEnd(),
+		                       distribution_->yOffsets());
+
+		typedef PsimagLite::Parallelizer<KronConnectionsType> ParallelizerType;
+		ParallelizerType parallelConnections(initKron_.codeSectionParams());
+		parallelConnections.loopCreate(kc);
+		kc.sync();
+	}
+
+	const KronDistributionType* distribution() const { return distribution_; }
+
+	// Operators in single precision, see InitKronBase::toLowPrecision().
+	// Not with BatchedGemm; ends work stealing, whose tasks need the
+	// operators in full precision
+	bool toLowPrecision()
+	{
+		if (batchedGemm_.enabled()) return false;
+
+		delete schedule_;
+		schedule_ = 0;
+		initKron_.toLowPrecision();
+
+		PsimagLite::OstringStream msg;
+		msg<<"Operators now in single precision";
+		progress_.printline(msg, std::cout);
+		return true;
+	}
+
+	// vout[v] += H*vin[v] for all v, with one pass over the Kron operators
+	void matrixMatrixProduct(VectorVectorType& vout, const VectorVectorType& vin) const
+	{
+		const SizeType k = vin.size();
+		assert(vout.size() == k);
+		if (k < 2 || batchedGemm_.enabled() || distribution_) {
+			for (SizeType v = 0; v < k; ++v)
+				matrixVectorProduct(vout[v], vin[v]);
+			return;
+		}
+
+		VectorType xmulti;
+		VectorType ymulti;
+		initKron_.copyIn(xmulti, ymulti, vout, vin);
+
+		KronConnectionsType kc(initKron_, xmulti, ymulti, k);
+
+		typedef PsimagLite::Parallelizer<KronConnectionsType> ParallelizerType;
+		ParallelizerType parallelConnections(initKron_.codeSectionParams());
+
+		if (initKron_.loadBalance())
+			parallelConnections.loopCreate(kc, initKron_.weightsOfPatchesNew());
+		else
+			parallelConnections.loopCreate(kc);
+
+		kc.sync();
+
+		initKron_.copyOut(vout, xmulti);
 	}
 
 private:
@@ -162,6 +286,9 @@ private:
 	InitKronType& initKron_;
 	PsimagLite::ProgressIndicator progress_;
 	BatchedGemmType batchedGemm_;
+	ScheduleType* schedule_;
+	KronDistributionType* distribution_;
+	mutable VectorType yNeeded_;
 }; //class KronMatrix
 
 } // namespace PsimagLite
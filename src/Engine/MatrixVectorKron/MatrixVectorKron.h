@@ -83,6 +83,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Vector.h"
 #include "InitKronHamiltonian.h"
 #include "KronMatrix.h"
+#include "KronCache.h"
 #include "MatrixVectorBase.h"
 
 namespace Dmrg {
@@ -93,6 +94,8 @@ class MatrixVectorKron : public MatrixVectorBase<ModelType_> {
 
 	static const bool CHECK_KRON = true;
 
+	static const SizeType checkKronBlock_ = 16;
+
 public:
 
 	typedef ModelType_ ModelType;
@@ -106,18 +109,83 @@ public:
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> FullMatrixType;
 	typedef typename SparseMatrixType::value_type value_type;
 	typedef typename ModelType::HamiltonianConnectionType HamiltonianConnectionType;
+	typedef KronCache<InitKronType, KronMatrixType> KronCacheType;
+	typedef typename KronCacheType::Entry KronCacheEntryType;
+	typedef typename KronMatrixType::KronDistributionType KronDistributionType;
+
+	// One DMRG step, from before its ground state solver to after its
+	// targets, during which the bases do not change. With KronSetupCache,
+	// the MatrixVectorKron objects built during the step share the Kron
+	// operators of this step's cache, which goes away with the step
+	class Step {
+
+	public:
+
+		Step(const ModelType& model)
+		    : cache_(0)
+		{
+			if (model.params().options.find("KronSetupCache") == PsimagLite::String::npos)
+				return;
+
+			if (current())
+				err("MatrixVectorKron::Step: a step is already open\n");
+
+			cache_ = new KronCacheType;
+			current() = cache_;
+		}
+
+		~Step()
+		{
+			if (!cache_) return;
+			current() = 0;
+			delete cache_;
+			cache_ = 0;
+		}
+
+	private:
+
+		Step(const Step&);
+
+		Step& operator=(const Step&);
+
+		KronCacheType* cache_;
+	};
 
 	MatrixVectorKron(const ModelType& model,
 	                 const HamiltonianConnectionType& hc,
 	                 ReflectionSymmetryType* = 0)
 	    : params_(model.params()),
-	      initKron_(model, hc),
-	      kronMatrix_(initKron_, "Hamiltonian"),
-	      time_(0, 0)
+	      initKron_(0),
+	      kronMatrix_(0),
+	      cache_(current()),
+	      cacheEntry_(0),
+	      time_(0, 0),
+	      patchOrder_(false),
+	      distributed_(false),
+	      checkMatrixMatrix_(params_.options.find("KronCheckMatrixMatrix") !=
+	        PsimagLite::String::npos)
 	{
+		const SizeType partition = hc.modelHelper().m();
+		if (cache_)
+			cacheEntry_ = cache_->take(partition, hc.targetTime());
+
+		if (cacheEntry_) {
+			initKron_ = &cacheEntry_->initKron();
+			kronMatrix_ = &cacheEntry_->kronMatrix();
+		} else {
+			initKron_ = new InitKronType(model, hc);
+			kronMatrix_ = new KronMatrixType(*initKron_, "Hamiltonian");
+			if (cache_)
+				cacheEntry_ = cache_->put(partition,
+				                          hc.targetTime(),
+				                          initKron_,
+				                          kronMatrix_);
+		}
+
 		int maxMatrixRankStored = model.params().maxMatrixRankStored;
 		if (hc.modelHelper().size() > maxMatrixRankStored) return;
 
@@ -130,9 +198,19 @@ public:
 	~MatrixVectorKron()
 	{
 		std::cout<<"DeltaClock matrixVectorProduct "<<time_.millis()<<"\n";
+
+		if (cacheEntry_) {
+			cache_->giveBack(cacheEntry_);
+			return;
+		}
+
+		delete kronMatrix_;
+		kronMatrix_ = 0;
+		delete initKron_;
+		initKron_ = 0;
 	}
 
-	SizeType rows() const { return initKron_.size(InitKronType::NEW); }
+	SizeType rows() const { return initKron_->size(InitKronType::NEW); }
 
 	template<typename SomeVectorType>
 	void matrixVectorProduct(SomeVectorType &x,SomeVectorType const &y) const
@@ -141,12 +219,157 @@ public:
 
 		if (matrixStored_.rows() > 0)
 			matrixStored_.matrixVectorProduct(x,y);
+		else if (distributed_)
+			kronMatrix_->matrixVectorProductLocal(x,y);
+		else if (patchOrder_)
+			kronMatrix_->matrixVectorProductPatchOrder(x,y);
 		else
-			kronMatrix_.matrixVectorProduct(x,y);
+			kronMatrix_->matrixVectorProduct(x,y);
+
+		const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
+		const PsimagLite::MemoryUsage::TimeHandle deltaTime = time2 - time1;
+		time_ += deltaTime;
+	}
+
+	// x[v] += H*y[v] for all v; H is read once for all vectors
+	void matrixMatrixProduct(VectorVectorType& x, const VectorVectorType& y) const
+	{
+		const PsimagLite::MemoryUsage::TimeHandle time1 = PsimagLite::ProgressIndicator::time();
+
+		VectorVectorType expected;
+		if (checkMatrixMatrix_) {
+			expected = x;
+			for (SizeType v = 0; v < y.size(); ++v)
+				matrixVectorProduct(expected[v], y[v]);
+		}
+
+		if (matrixStored_.rows() > 0) {
+			for (SizeType v = 0; v < y.size(); ++v)
+				matrixStored_.matrixVectorProduct(x[v], y[v]);
+		} else if (distributed_) {
+			for (SizeType v = 0; v < y.size(); ++v)
+				kronMatrix_->matrixVectorProductLocal(x[v], y[v]);
+		} else if (patchOrder_) {
+			for (SizeType v = 0; v < y.size(); ++v)
+				kronMatrix_->matrixVectorProductPatchOrder(x[v], y[v]);
+		} else {
+			kronMatrix_->matrixMatrixProduct(x, y);
+		}
 
 		const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
 		const PsimagLite::MemoryUsage::TimeHandle deltaTime = time2 - time1;
 		time_ += deltaTime;
+
+		if (checkMatrixMatrix_)
+			checkMatrixMatrix(x, expected);
+	}
+
+	// With patch order on, the vectors given to and returned by the matrix
+	// vector products are in Kron patch order, which saves the permutation
+	// of each product. Ignored if the matrix is stored
+	void patchOrder(bool flag) { patchOrder_ = (flag && matrixStored_.rows() == 0); }
+
+	bool patchOrder() const { return patchOrder_; }
+
+	// With distributed on, which needs KronMpi and more than one MPI rank,
+	// the vectors given to and returned by the products are this rank's rows
+	// of vectors in patch order; see toLocal() and fromLocal(). Every rank
+	// must do each product at the same time. Ignored if the matrix is stored
+	void distributed(bool flag)
+	{
+		distributed_ = (flag && matrixStored_.rows() == 0 && kronMatrix_->distribution());
+	}
+
+	bool distributed() const { return distributed_; }
+
+	// dest = this rank's rows of src, src in patch order
+	void toLocal(VectorType& dest, const VectorType& src) const
+	{
+		if (!distributed_) {
+			dest = src;
+			return;
+		}
+
+		slice(dest, src);
+	}
+
+	// dest in patch order = the vector whose rows on each rank are that
+	// rank's src. Every rank must call this at the same time
+	void fromLocal(VectorType& dest, const VectorType& src) const
+	{
+		if (!distributed_) {
+			dest = src;
+			return;
+		}
+
+		dest.resize(rows());
+		std::fill(dest.begin(), dest.end(), 0.0);
+		kronMatrix_->distribution()->gather(dest, src);
+	}
+
+	// v = the sum over ranks of v, for scalar products of distributed vectors
+	void sumOverRanks(VectorType& v) const
+	{
+		if (distributed_) KronDistributionType::sum(v);
+	}
+
+	// Kron operators in single precision from now on, the vectors given
+	// to and returned by the products are unchanged. Ignored if the
+	// matrix is stored, or with BatchedGemm
+	void lowPrecision(bool flag)
+	{
+		if (!flag || matrixStored_.rows() > 0) return;
+
+		// the cached operators stay in full precision for the other users
+		if (cacheEntry_) {
+			cache_->release(cacheEntry_);
+			cacheEntry_ = 0;
+		}
+
+		kronMatrix_->toLowPrecision();
+	}
+
+	// d[i] = H_{i,i}, in patch order if patchOrder() is on, and only this
+	// rank's rows if distributed() is on
+	void diagonal(VectorType& d) const
+	{
+		if (matrixStored_.rows() > 0) {
+			BaseType::diagonal(d, matrixStored_);
+			return;
+		}
+
+		VectorType dPatched;
+		initKron_->diagonal(dPatched);
+		if (distributed_) {
+			slice(d, dPatched);
+			return;
+		}
+
+		// with KronMpi each rank has the diagonal of its rows only
+		const KronDistributionType* distribution = kronMatrix_->distribution();
+		if (distribution) {
+			VectorType dLocal;
+			slice(dLocal, dPatched);
+			std::fill(dPatched.begin(), dPatched.end(), 0.0);
+			distribution->gather(dPatched, dLocal);
+		}
+
+		if (patchOrder_) {
+			d.swap(dPatched);
+			return;
+		}
+
+		initKron_->fromPatchOrder(d, dPatched);
+	}
+
+	void toPatchOrder(VectorType& dest, const VectorType& src) const
+	{
+		initKron_->toPatchOrder(dest, src);
+	}
+
+	void fromPatchOrder(VectorType& dest, const VectorType& src) const
+	{
+		initKron_->fromPatchOrder(dest, src);
 	}
 
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
@@ -156,6 +379,43 @@ public:
 
 private:
 
+	MatrixVectorKron(const MatrixVectorKron&);
+
+	MatrixVectorKron& operator=(const MatrixVectorKron&);
+
+	void slice(VectorType& dest, const VectorType& src) const
+	{
+		const KronDistributionType* distribution = kronMatrix_->distribution();
+		assert(distribution);
+		const SizeType offset = distribution->localOffset();
+		dest.assign(src.begin() + offset, src.begin() + offset + distribution->localSize());
+	}
+
+	// the cache of the open Step, if any
+	static KronCacheType*& current()
+	{
+		static KronCacheType* cache = 0;
+		return cache;
+	}
+
+	// for SolverOptions=KronCheckMatrixMatrix
+	static void checkMatrixMatrix(const VectorVectorType& x, const VectorVectorType& expected)
+	{
+		assert(x.size() == expected.size());
+		for (SizeType v = 0; v < x.size(); ++v) {
+			RealType diff = 0;
+			RealType norm = 0;
+			for (SizeType i = 0; i < x[v].size(); ++i) {
+				diff += std::norm(x[v][i] - expected[v][i]);
+				norm += std::norm(expected[v][i]);
+			}
+
+			if (diff <= 1e-20 + 1e-20*norm) continue;
+			err("KronCheckMatrixMatrix: vector " + ttos(v) + " of " + ttos(x.size()) +
+			    " differs from matrixVectorProduct by " + ttos(sqrt(diff)) + "\n");
+		}
+	}
+
 	void checkKron() const
 	{
 		if (!CHECK_KRON)
@@ -168,14 +428,17 @@ private:
 		SizeType n = rows();
 		std::cout<<n<<"\n";
 		FullMatrixType m(n, n);
-		for (SizeType i = 0; i < n; ++i) {
-			VectorType e(n, 0.0);
-			e[i] = 1.0;
-			VectorType ey(n, 0.0);
-			kronMatrix_.matrixVectorProduct(ey,e);
-			for (SizeType j = 0; j < n; ++j)
-				m(i, j) = ey[j];
-
+		for (SizeType i0 = 0; i0 < n; i0 += checkKronBlock_) {
+			const SizeType k = std::min(checkKronBlock_, n - i0);
+			VectorVectorType e(k, VectorType(n, 0.0));
+			VectorVectorType ey(k, VectorType(n, 0.0));
+			for (SizeType v = 0; v < k; ++v)
+				e[v][i0 + v] = 1.0;
+
+			kronMatrix_->matrixMatrixProduct(ey, e);
+			for (SizeType v = 0; v < k; ++v)
+				for (SizeType j = 0; j < n; ++j)
+					m(i0 + v, j) = ey[v][j];
 		}
 
 		std::cout<<"Matrix as thought of by Kron\n";
@@ -186,10 +449,15 @@ private:
 	}
 
 	const ParametersType& params_;
-	InitKronType initKron_;
-	KronMatrixType kronMatrix_;
+	InitKronType* initKron_;
+	KronMatrixType* kronMatrix_;
+	KronCacheType* cache_;
+	KronCacheEntryType* cacheEntry_;
 	SparseMatrixType matrixStored_;
 	mutable PsimagLite::MemoryUsage::TimeHandle time_;
+	bool patchOrder_;
+	bool distributed_;
+	bool checkMatrixMatrix_;
 }; // class MatrixVectorKron
 } // namespace Dmrg
 
@@ -100,6 +100,7 @@ public:
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> FullMatrixType;
+	typedef typename BaseType::VectorType VectorType;
 	typedef typename ModelType::HamiltonianConnectionType HamiltonianConnectionType;
 
 	MatrixVectorOnTheFly(const ModelType& model,
@@ -125,6 +126,24 @@ public:
 			model_.matrixVectorProduct(x, y, hc_);
 	}
 
+	// d[i] = H_{i,i}; d is empty if not available (SU(2))
+	void diagonal(VectorType& d) const
+	{
+		if (matrixStored_.rows() > 0)
+			BaseType::diagonal(d, matrixStored_);
+		else if (ModelHelperType::isSu2())
+			d.clear();
+		else
+			hc_.diagonal(d);
+	}
+
+	template<typename SomeVectorVectorType>
+	void matrixMatrixProduct(SomeVectorVectorType &x, SomeVectorVectorType const &y) const
+	{
+		for (SizeType v = 0; v < y.size(); ++v)
+			matrixVectorProduct(x[v], y[v]);
+	}
+
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
 	{
 		int mrs = model_.params().maxMatrixRankStored;
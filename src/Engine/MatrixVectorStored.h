@@ -101,6 +101,7 @@ public:
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> FullMatrixType;
+	typedef typename BaseType::VectorType VectorType;
 	typedef typename ModelType::HamiltonianConnectionType HamiltonianConnectionType;
 
 	MatrixVectorStored(const ModelType& model,
@@ -142,6 +143,19 @@ public:
 		matrixStored_[pointer_].matrixVectorProduct(x,y);
 	}
 
+	// d[i] = H_{i,i}
+	void diagonal(VectorType& d) const
+	{
+		BaseType::diagonal(d, matrixStored_[pointer_]);
+	}
+
+	template<typename SomeVectorVectorType>
+	void matrixMatrixProduct(SomeVectorVectorType &x, SomeVectorVectorType const &y) const
+	{
+		for (SizeType v = 0; v < y.size(); ++v)
+			matrixStored_[pointer_].matrixVectorProduct(x[v],y[v]);
+	}
+
 	value_type operator()(SizeType i,SizeType j) const
 	{
 		return matrixStored_[pointer_](i,j);
@@ -404,9 +404,11 @@ for (SizeType dof = 0; dof < numberOfDofs; ++dof) {
 	                         const HamiltonianConnectionType& hc) const
 	{
 		typedef PsimagLite::Parallelizer<ParallelHamConnectionType> ParallelizerType;
-		ParallelizerType parallelConnections(PsimagLite::Concurrency::codeSectionParams);
+		ParallelizerType parallelConnections(hc.codeSectionParams());
 
-		ParallelHamConnectionType phc(x, y, hc);
+		const bool rowPartitioned = (modelCommon_.params().options.find("OnTheFlyRowPartition")
+		                             != PsimagLite::String::npos);
+		ParallelHamConnectionType phc(x, y, hc, rowPartitioned);
 		parallelConnections.loopCreate(phc);
 
 		phc.sync();
@@ -117,7 +117,9 @@ public:
 	ModelHelperLocal(SizeType m, const LeftRightSuperType& lrs)
 	    : m_(m),
 	      lrs_(lrs),
-	      buffer_(lrs_.left().size()),
+	      bufferBegin_(lrs_.left().size(), 0),
+	      bufferEnd_(lrs_.left().size(), 0),
+	      bufferOffset_(lrs_.left().size() + 1, 0),
 	      garbage_(ConcurrencyType::codeSectionParams.npthreads),
 	      seen_(ConcurrencyType::codeSectionParams.npthreads)
 	{
@@ -251,7 +253,7 @@ public:
 				int alphaPrime = A.getCol(k);
 				for (int kk=B.getRowPtr(beta);kk<B.getRowPtr(beta+1);kk++) {
 					int betaPrime= B.getCol(kk);
-					int j = buffer_[alphaPrime][betaPrime];
+					int j = buffer(alphaPrime, betaPrime);
 					if (j<0) continue;
 					/* fermion signs note:
 					here the environ is applied first and has to "cross"
@@ -277,6 +279,19 @@ public:
 	                     const SparseMatrixType& A,
 	                     const SparseMatrixType& B,
 	                     const LinkType& link) const
+	{
+		fastOpProdInter(x, y, A, B, link, 0, size());
+	}
+
+	// Same as above, but only for rows rowBegin <= i < rowEnd of x
+	// Threads owning disjoint row ranges can then write to x without races
+	void fastOpProdInter(VectorSparseElementType& x,
+	                     const VectorSparseElementType& y,
+	                     const SparseMatrixType& A,
+	                     const SparseMatrixType& B,
+	                     const LinkType& link,
+	                     SizeType rowBegin,
+	                     SizeType rowEnd) const
 	{
 		RealType fermionSign =  (link.fermionOrBoson == ProgramGlobals::FermionOrBosonEnum::FERMION)
 		        ? -1 : 1;
@@ -285,16 +300,16 @@ public:
 			LinkType link2 = link;
 			link2.value *= fermionSign;
 			link2.type = ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON;
-			fastOpProdInter(x,y,B,A,link2);
+			fastOpProdInter(x, y, B, A, link2, rowBegin, rowEnd);
 			return;
 		}
 
 		//! work only on partition m
-		int m = m_;
-		int offset = lrs_.super().partition(m);
-		int total = lrs_.super().partition(m+1) - offset;
+		int begin = rowBegin;
+		int end = rowEnd;
+		assert(end <= size());
 
-		for (int i=0;i<total;++i) {
+		for (int i=begin;i<end;++i) {
 			// row i of the ordered product basis
 			int alpha=alpha_[i];
 			int beta=beta_[i];
@@ -315,12 +330,14 @@ public:
 			for (int k=startk;k<endk;++k) {
 				int alphaPrime = A.getCol(k);
 				SparseElementType tmp2 = A.getValue(k) *fsValue;
-				const typename PsimagLite::Vector<int>::Type& bufferTmp =
-				        buffer_[alphaPrime];
+				const int betaBegin = bufferBegin_[alphaPrime];
+				const int betaEnd = bufferEnd_[alphaPrime];
+				const int* bufferTmp = bufferData_.data() + bufferOffset_[alphaPrime];
 
 				for (int kk=startkk;kk<endkk;++kk) {
 					int betaPrime= B.getCol(kk);
-					int j = bufferTmp[betaPrime];
+					if (betaPrime < betaBegin || betaPrime >= betaEnd) continue;
+					int j = bufferTmp[betaPrime - betaBegin];
 					if (j<0) continue;
 
 					SparseElementType tmp = tmp2 * B.getValue(kk);
@@ -340,23 +357,33 @@ public:
 	// Has been changed to accomodate for reflection symmetry
 	void hamiltonianLeftProduct(VectorSparseElementType& x,
 	                            const VectorSparseElementType& y) const
+	{
+		hamiltonianLeftProduct(x, y, 0, size());
+	}
+
+	// Same as above, but only for rows rowBegin <= i < rowEnd of x
+	void hamiltonianLeftProduct(VectorSparseElementType& x,
+	                            const VectorSparseElementType& y,
+	                            SizeType rowBegin,
+	                            SizeType rowEnd) const
 	{
 		int m = m_;
 		int offset = lrs_.super().partition(m);
 		int i,k,alphaPrime;
-		int bs = lrs_.super().partition(m+1)-offset;
+		int end = rowEnd;
+		assert(end <= size());
 		const SparseMatrixType& hamiltonian = lrs_.left().hamiltonian().getCRS();
 		SizeType ns = lrs_.left().size();
 		SparseElementType sum = 0.0;
 		PackIndicesType pack(ns);
-		for (i=0;i<bs;i++) {
+		for (i=rowBegin;i<end;i++) {
 			SizeType r,beta;
 			pack.unpack(r,beta,lrs_.super().permutation(i+offset));
 
 			// row i of the ordered product basis
 			for (k=hamiltonian.getRowPtr(r);k<hamiltonian.getRowPtr(r+1);k++) {
 				alphaPrime = hamiltonian.getCol(k);
-				int j = buffer_[alphaPrime][beta];
+				int j = buffer(alphaPrime, beta);
 				if (j<0) continue;
 				sum += hamiltonian.getValue(k)*y[j];
 			}
@@ -373,22 +400,32 @@ public:
 	// This is a performance critical function
 	void hamiltonianRightProduct(VectorSparseElementType& x,
 	                             const VectorSparseElementType& y) const
+	{
+		hamiltonianRightProduct(x, y, 0, size());
+	}
+
+	// Same as above, but only for rows rowBegin <= i < rowEnd of x
+	void hamiltonianRightProduct(VectorSparseElementType& x,
+	                             const VectorSparseElementType& y,
+	                             SizeType rowBegin,
+	                             SizeType rowEnd) const
 	{
 		int m = m_;
 		int offset = lrs_.super().partition(m);
 		int i,k;
-		int bs = lrs_.super().partition(m+1)-offset;
+		int end = rowEnd;
+		assert(end <= size());
 		const SparseMatrixType& hamiltonian = lrs_.right().hamiltonian().getCRS();
 		SizeType ns = lrs_.left().size();
 		SparseElementType sum = 0.0;
 		PackIndicesType pack(ns);
-		for (i=0;i<bs;i++) {
+		for (i=rowBegin;i<end;i++) {
 			SizeType alpha,r;
 			pack.unpack(alpha,r,lrs_.super().permutation(i+offset));
 
 			// row i of the ordered product basis
 			for (k=hamiltonian.getRowPtr(r);k<hamiltonian.getRowPtr(r+1);k++) {
-				int j = buffer_[alpha][hamiltonian.getCol(k)];
+				int j = buffer(alpha, hamiltonian.getCol(k));
 				if (j<0) continue;
 				sum += hamiltonian.getValue(k)*y[j];
 			}
@@ -398,6 +435,44 @@ public:
 		}
 	}
 
+	// Does x[i] += (AB)_{i,i}, with A and B as in fastOpProdInter
+	void diagonalInter(VectorSparseElementType& x,
+	                   const SparseMatrixType& A,
+	                   const SparseMatrixType& B,
+	                   const LinkType& link) const
+	{
+		RealType fermionSign =  (link.fermionOrBoson == ProgramGlobals::FermionOrBosonEnum::FERMION)
+		        ? -1 : 1;
+
+		if (link.type==ProgramGlobals::ConnectionEnum::ENVIRON_SYSTEM)  {
+			LinkType link2 = link;
+			link2.value *= fermionSign;
+			link2.type = ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON;
+			diagonalInter(x, B, A, link2);
+			return;
+		}
+
+		const int total = size();
+		assert(x.size() >= static_cast<SizeType>(total));
+		for (int i = 0; i < total; ++i) {
+			SparseElementType fsValue = (fermionSign < 0 && fermionSigns_[i])
+			        ? -link.value
+			        : link.value;
+			x[i] += crsDiagonal(A, alpha_[i])*crsDiagonal(B, beta_[i])*fsValue;
+		}
+	}
+
+	// Does x[i] += diagonal of the left and right Hamiltonians for row i
+	void hamiltonianDiagonal(VectorSparseElementType& x) const
+	{
+		const SparseMatrixType& left = lrs_.left().hamiltonian().getCRS();
+		const SparseMatrixType& right = lrs_.right().hamiltonian().getCRS();
+		const int total = size();
+		assert(x.size() >= static_cast<SizeType>(total));
+		for (int i = 0; i < total; ++i)
+			x[i] += crsDiagonal(left, alpha_[i]) + crsDiagonal(right, beta_[i]);
+	}
+
 	// if option==true let H_{alpha,beta; alpha',beta'} =
 	// basis2.hamiltonian_{alpha,alpha'} \delta_{beta,beta'}
 	// if option==false let  H_{alpha,beta; alpha',beta'} =
@@ -461,21 +536,60 @@ public:
 
 private:
 
+	static SparseElementType crsDiagonal(const SparseMatrixType& m, SizeType row)
+	{
+		for (int k = m.getRowPtr(row); k < m.getRowPtr(row + 1); ++k)
+			if (static_cast<SizeType>(m.getCol(k)) == row) return m.getValue(k);
+
+		return 0.0;
+	}
+
+	// Index in this sector of the state (alphaPrime, betaPrime), or -1 if
+	// the state does not belong to this sector
+	int buffer(SizeType alphaPrime, SizeType betaPrime) const
+	{
+		assert(alphaPrime < bufferBegin_.size());
+		if (betaPrime < bufferBegin_[alphaPrime] || betaPrime >= bufferEnd_[alphaPrime])
+			return -1;
+
+		return bufferData_[bufferOffset_[alphaPrime] + betaPrime - bufferBegin_[alphaPrime]];
+	}
+
+	// For each alphaPrime of the left basis, the betaPrime of the right basis that
+	// are in this sector lie in [bufferBegin_[alphaPrime], bufferEnd_[alphaPrime]),
+	// because the right basis is ordered by quantum numbers.
+	// Only these ranges are stored, contiguously, in bufferData_,
+	// so that memory scales with the size of the sector and not with ns*ne
 	void createBuffer()
 	{
 		SizeType ns=lrs_.left().size();
-		SizeType ne=lrs_.right().size();
 		int offset = lrs_.super().partition(m_);
 		int total = lrs_.super().partition(m_+1) - offset;
 
-		typename PsimagLite::Vector<int>::Type  tmpBuffer(ne);
-		for (SizeType alphaPrime=0;alphaPrime<ns;alphaPrime++) {
-			for (SizeType betaPrime=0;betaPrime<ne;betaPrime++) {
-				tmpBuffer[betaPrime] = lrs_.super().
-				        permutationInverse(alphaPrime + betaPrime*ns) -offset;
-				if (tmpBuffer[betaPrime]>=total) tmpBuffer[betaPrime]= -1;
-			}
-			buffer_[alphaPrime]=tmpBuffer;
+		PackIndicesType pack(ns);
+		VectorSizeType seen(ns, 0);
+		for (int i = 0; i < total; ++i) {
+			SizeType alphaPrime = 0;
+			SizeType betaPrime = 0;
+			pack.unpack(alphaPrime, betaPrime, lrs_.super().permutation(i + offset));
+			if (seen[alphaPrime] == 0 || betaPrime < bufferBegin_[alphaPrime])
+				bufferBegin_[alphaPrime] = betaPrime;
+			if (seen[alphaPrime] == 0 || betaPrime + 1 > bufferEnd_[alphaPrime])
+				bufferEnd_[alphaPrime] = betaPrime + 1;
+			seen[alphaPrime] = 1;
+		}
+
+		for (SizeType alphaPrime = 0; alphaPrime < ns; ++alphaPrime)
+			bufferOffset_[alphaPrime + 1] = bufferOffset_[alphaPrime] +
+			        bufferEnd_[alphaPrime] - bufferBegin_[alphaPrime];
+
+		bufferData_.resize(bufferOffset_[ns], -1);
+
+		for (int i = 0; i < total; ++i) {
+			SizeType alphaPrime = 0;
+			SizeType betaPrime = 0;
+			pack.unpack(alphaPrime, betaPrime, lrs_.super().permutation(i + offset));
+			bufferData_[bufferOffset_[alphaPrime] + betaPrime - bufferBegin_[alphaPrime]] = i;
 		}
 	}
 
@@ -514,7 +628,10 @@ private:
 
 	int m_;
 	const LeftRightSuperType& lrs_;
-	typename PsimagLite::Vector<PsimagLite::Vector<int>::Type>::Type buffer_;
+	VectorSizeType bufferBegin_;
+	VectorSizeType bufferEnd_;
+	VectorSizeType bufferOffset_;
+	PsimagLite::Vector<int>::Type bufferData_;
 	typename PsimagLite::Vector<SizeType>::Type alpha_,beta_;
 	typename PsimagLite::Vector<bool>::Type fermionSigns_;
 	mutable VectorVectorOperatorStorageType garbage_;
@@ -243,6 +243,19 @@ public:
 	                     SparseMatrixType const &B,
 	                     const LinkType& link,
 	                     bool flipped=false) const
+	{
+		fastOpProdInter(x, y, A, B, link, 0, x.size(), flipped);
+	}
+
+	// Same as above, but only for rows rowBegin <= ix < rowEnd of x
+	void fastOpProdInter(VectorSparseElementType& x,
+	                     const VectorSparseElementType& y,
+	                     SparseMatrixType const &A,
+	                     SparseMatrixType const &B,
+	                     const LinkType& link,
+	                     SizeType rowBegin,
+	                     SizeType rowEnd,
+	                     bool flipped=false) const
 	{
 		//int const SystemEnviron=1,EnvironSystem=2;
 		RealType fermionSign =  (link.fermionOrBoson == ProgramGlobals::FermionOrBosonEnum::FERMION)
@@ -252,7 +265,7 @@ public:
 			LinkType link2 = link;
 			link2.value *= fermionSign;
 			link2.type = ProgramGlobals::ConnectionEnum::SYSTEM_ENVIRON;
-			fastOpProdInter(x,y,B,A,link2,true);
+			fastOpProdInter(x, y, B, A, link2, rowBegin, rowEnd, true);
 			return;
 		}
 
@@ -264,7 +277,7 @@ public:
 
 		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
 			int ix = su2reduced_.flavorMapping(i)-offset;
-			if (ix<0 || ix>=int(x.size())) continue;
+			if (ix<int(rowBegin) || ix>=int(rowEnd)) continue;
 
 			SizeType i1=su2reduced_.reducedEffective(i).first;
 			SizeType i2=su2reduced_.reducedEffective(i).second;
@@ -316,6 +329,15 @@ public:
 	// Has been changed to accomodate for reflection symmetry
 	void hamiltonianLeftProduct(VectorSparseElementType& x,
 	                            const VectorSparseElementType& y) const
+	{
+		hamiltonianLeftProduct(x, y, 0, x.size());
+	}
+
+	// Same as above, but only for rows rowBegin <= ix < rowEnd of x
+	void hamiltonianLeftProduct(VectorSparseElementType& x,
+	                            const VectorSparseElementType& y,
+	                            SizeType rowBegin,
+	                            SizeType rowEnd) const
 	{
 		//! work only on partition m
 		int m = m_;
@@ -324,7 +346,7 @@ public:
 
 		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
 			int ix = su2reduced_.flavorMapping(i)-offset;
-			if (ix<0 || ix>=int(x.size())) continue;
+			if (ix<int(rowBegin) || ix>=int(rowEnd)) continue;
 
 			SizeType i1=su2reduced_.reducedEffective(i).first;
 			SizeType i2=su2reduced_.reducedEffective(i).second;
@@ -354,6 +376,15 @@ public:
 	// This is a performance critical function
 	void hamiltonianRightProduct(VectorSparseElementType& x,
 	                             const VectorSparseElementType& y) const
+	{
+		hamiltonianRightProduct(x, y, 0, x.size());
+	}
+
+	// Same as above, but only for rows rowBegin <= ix < rowEnd of x
+	void hamiltonianRightProduct(VectorSparseElementType& x,
+	                             const VectorSparseElementType& y,
+	                             SizeType rowBegin,
+	                             SizeType rowEnd) const
 	{
 		//! work only on partition m
 		int m = m_;
@@ -362,7 +393,7 @@ public:
 
 		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
 			int ix = su2reduced_.flavorMapping(i)-offset;
-			if (ix<0 || ix>=int(x.size())) continue;
+			if (ix<int(rowBegin) || ix>=int(rowEnd)) continue;
 
 			SizeType i1=su2reduced_.reducedEffective(i).first;
 			SizeType i2=su2reduced_.reducedEffective(i).second;
@@ -474,6 +505,19 @@ public:
 
 	SizeType m() const {return m_;}
 
+	void diagonalInter(VectorSparseElementType&,
+	                   const SparseMatrixType&,
+	                   const SparseMatrixType&,
+	                   const LinkType&) const
+	{
+		err("ModelHelperSu2: diagonal of the Hamiltonian not available\n");
+	}
+
+	void hamiltonianDiagonal(VectorSparseElementType&) const
+	{
+		err("ModelHelperSu2: diagonal of the Hamiltonian not available\n");
+	}
+
 	const LeftRightSuperType& leftRightSuper() const
 	{
 		return lrs_;
@@ -131,7 +131,8 @@ public:
 	              params.options.find("fixLegacyBugs") == PsimagLite::String::npos),
 	      onepoint_(helper_),
 	      skeleton_(helper_, true),
-	      twopoint_(skeleton_),
+	      twopoint_(skeleton_,
+	                params.options.find("twoPointIncremental") != PsimagLite::String::npos),
 	      fourpoint_(skeleton_)
 	{}
 
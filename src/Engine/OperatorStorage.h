@@ -4,12 +4,16 @@
 #include "BlockOffDiagMatrix.h"
 #include "Matrix.h"
 #include "Io/IoNg.h"
+#include <mutex>
+#include <atomic>
 
 // Selects storage for operators,
 // This can be just a CRS matrix or it can be the following.
 // Blocked off diagonal matrix,
 // but blocks are now dense matrices, in the future we might make them
 // MatrixDenseOrSparse type
+// ChangeOfBasis leaves operators blocked; the blocks are then made into
+// the CRS matrix, and dropped, only when something needs it
 // It also selects BlockDiagonalType for storage that we know is
 // block diagonal, like the DMRG transformation matrix
 namespace Dmrg {
@@ -30,29 +34,46 @@ public:
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
-	OperatorStorage() : justCrs_(true)
+	OperatorStorage() : justCrs_(true), blocked_(0)
 	{}
 
 	explicit OperatorStorage(const SparseMatrixType& src)
-	    : justCrs_(true), crs_(src)
+	    : justCrs_(true), crs_(src), blocked_(0)
 	{}
 
-	void makeDiagonal(SizeType rows, ComplexOrRealType value = 1) // replace this by a ctor
+	// under the lock of other, whose blocks another thread may be making
+	// into its CRS matrix
+	OperatorStorage(const OperatorStorage& other)
+	    : justCrs_(true), blocked_(0)
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::makeDiagonal\n");
+		copyFrom(other);
+	}
 
-		justCrs_ = true;
+	OperatorStorage& operator=(const OperatorStorage& other)
+	{
+		if (this == &other) return *this;
+		clear();
+		copyFrom(other);
+		return *this;
+	}
+
+	~OperatorStorage()
+	{
+		delete blocked_;
+		blocked_ = 0;
+	}
+
+	void makeDiagonal(SizeType rows, ComplexOrRealType value = 1) // replace this by a ctor
+	{
+		toCrs();
 		crs_.makeDiagonal(rows, value);
 	}
 
 	void read(PsimagLite::String label,
 	          PsimagLite::IoNgSerializer& io)
 	{
-		if (justCrs_)
-			return crs_.read(label, io);
-
-		throw PsimagLite::RuntimeError("OperatorStorage::read\n");
+		toCrs();
+		crs_.read(label, io);
 	}
 
 	void write(PsimagLite::String label,
@@ -60,77 +81,61 @@ public:
 	           PsimagLite::IoSerializer::WriteMode mode = PsimagLite::IoNgSerializer::NO_OVERWRITE)
 	const
 	{
-		if (justCrs_)
-			return crs_.write(label, io, mode);
-
-		throw PsimagLite::RuntimeError("OperatorStorage::write\n");
+		getCRS().write(label, io, mode);
 	}
 
 	void overwrite(PsimagLite::String label,
 	               PsimagLite::IoNgSerializer& io) const
 	{
-		if (justCrs_)
-			return crs_.overwrite(label, io);
-
-		throw PsimagLite::RuntimeError("OperatorStorage::overwrite\n");
+		getCRS().overwrite(label, io);
 	}
 
 	OperatorStorage operator+=(const OperatorStorage& other)
 	{
-		if (justCrs_ && other.justCrs_) {
-			crs_ += other.crs_;
-			return *this;
-		}
-
-		throw PsimagLite::RuntimeError("OperatorStorage::operator+=\n");
+		toCrs();
+		crs_ += other.getCRS();
+		return *this;
 	}
 
 	OperatorStorage operator*=(const ComplexOrRealType& value)
 	{
-		if (justCrs_) {
-			crs_ *= value;
+		if (!justCrs_) {
+			(*blocked_) *= value;
 			return *this;
 		}
 
-		throw PsimagLite::RuntimeError("OperatorStorage::operator*=\n");
+		crs_ *= value;
+		return *this;
 	}
 
 	void fromDense(const PsimagLite::Matrix<ComplexOrRealType>& m)
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::fromDense()\n");
-
+		toCrs();
 		fullMatrixToCrsMatrix(crs_, m);
 	}
 
 	void clear()
 	{
-		if (justCrs_)
-			return crs_.clear();
-
-		throw PsimagLite::RuntimeError("OperatorStorage::clear()\n");
+		delete blocked_;
+		blocked_ = 0;
+		justCrs_ = true;
+		crs_.clear();
 	}
 
 	void checkValidity() const
 	{
-		if (justCrs_)
-			return crs_.checkValidity();
-
-		throw PsimagLite::RuntimeError("OperatorStorage::checkValidity\n");
+		getCRS().checkValidity();
 	}
 
 	void conjugate()
 	{
-		if (justCrs_)
-			return crs_.conjugate();
-
-		throw PsimagLite::RuntimeError("OperatorStorage::conjugate\n");
+		toCrs();
+		crs_.conjugate();
 	}
 
 	void transpose()
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::transpose\n");
+		toCrs();
 
 		// transpose conjugate
 		SparseMatrixType copy = crs_;
@@ -143,91 +148,143 @@ public:
 	void rotate(const PsimagLite::CrsMatrix<ComplexOrRealType>& left,
 	            const PsimagLite::CrsMatrix<ComplexOrRealType>& right)
 	{
-		if (justCrs_) {
-			SparseMatrixType tmp;
-			multiply(tmp, crs_, right);
-			multiply(crs_, left, tmp);
-			return;
-		}
-
-		throw PsimagLite::RuntimeError("OperatorStorage::rotate\n");
+		toCrs();
+		SparseMatrixType tmp;
+		multiply(tmp, crs_, right);
+		multiply(crs_, left, tmp);
 	}
 
 	MatrixType toDense() const
 	{
-		if (justCrs_)
-			return crs_.toDense();
-
-		throw PsimagLite::RuntimeError("OperatorStorage::toDense\n");
+		return getCRS().toDense();
 	}
 
+	// If blocked, the blocks are made into the CRS matrix and dropped, so
+	// that the operator is not stored twice; under the lock of this operator,
+	// as threads may ask for it at the same time
 	const SparseMatrixType& getCRS() const
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::toCRS\n");
+		if (justCrs_) return crs_;
+
+		std::lock_guard<std::mutex> guard(mutex_);
+		if (!justCrs_) {
+			blocked_->toSparse(crs_);
+			delete blocked_;
+			blocked_ = 0;
+			justCrs_ = true;
+		}
+
 		return crs_;
 	}
 
 	// FIXME TODO DELETE THIS FUNCTION!!
 	SparseMatrixType& getCRSNonConst()
 	{
-		if (!justCrs_)
-			throw PsimagLite::RuntimeError("OperatorStorage::toCRS\n");
+		toCrs();
 		return crs_;
 	}
 
 	SizeType nonZeros() const
 	{
-		if (justCrs_)
-			return crs_.nonZeros();
-
-		throw PsimagLite::RuntimeError("OperatorStorage::nonZeros\n");
+		return getCRS().nonZeros();
 	}
 
 	SizeType rows() const
 	{
-		if (justCrs_)
-			return crs_.rows();
+		if (justCrs_) return crs_.rows();
 
-		throw PsimagLite::RuntimeError("OperatorStorage::rows()\n");
+		std::lock_guard<std::mutex> guard(mutex_);
+		return (justCrs_) ? crs_.rows() : blocked_->rows();
 	}
 
 	SizeType cols() const
 	{
-		if (justCrs_)
-			return crs_.cols();
+		if (justCrs_) return crs_.cols();
 
-		throw PsimagLite::RuntimeError("OperatorStorage::cols()\n");
+		std::lock_guard<std::mutex> guard(mutex_);
+		return (justCrs_) ? crs_.cols() : blocked_->cols();
 	}
 
 	bool justCRS() const { return justCrs_; }
 
+	// values and indices stored, of the CRS matrix or of the blocks,
+	// without making the CRS matrix
+	SizeType bytes() const
+	{
+		if (justCrs_) return crsBytes();
+
+		std::lock_guard<std::mutex> guard(mutex_);
+		if (justCrs_) return crsBytes();
+
+		const VectorSizeType& offsetRows = blocked_->offsets(true);
+		const VectorSizeType& offsetCols = blocked_->offsets(false);
+		SizeType sum = (offsetRows.size() + offsetCols.size())*sizeof(SizeType);
+		for (SizeType i = 0; i + 1 < offsetRows.size(); ++i) {
+			for (SizeType j = 0; j + 1 < offsetCols.size(); ++j) {
+				const MatrixType* m = blocked_->block(i, j);
+				if (m) sum += m->rows()*m->cols()*sizeof(ComplexOrRealType);
+			}
+		}
+
+		return sum;
+	}
+
+	// true if stored as blocks of these square partitions
+	bool isBlocked(const VectorSizeType& partitions) const
+	{
+		if (justCrs_) return false;
+
+		std::lock_guard<std::mutex> guard(mutex_);
+		return (!justCrs_ && blocked_->offsets(true) == partitions);
+	}
+
+	// Stores as dense blocks of these square partitions, non zero blocks only
+	void toBlocked(const VectorSizeType& partitions)
+	{
+		if (isBlocked(partitions)) return;
+
+		BlockOffDiagMatrixType* blocked = new BlockOffDiagMatrixType(getCRS(), partitions);
+		delete blocked_;
+		blocked_ = blocked;
+		justCrs_ = false;
+		crs_.clear();
+	}
+
+	// valid until the blocks are made into the CRS matrix, see getCRS()
+	const BlockOffDiagMatrixType& getBlocked() const
+	{
+		if (justCrs_)
+			throw PsimagLite::RuntimeError("OperatorStorage::getBlocked\n");
+
+		return *blocked_;
+	}
+
+	BlockOffDiagMatrixType& getBlockedNonConst()
+	{
+		if (justCrs_)
+			throw PsimagLite::RuntimeError("OperatorStorage::getBlockedNonConst\n");
+
+		return *blocked_;
+	}
+
 	friend void transposeConjugate(OperatorStorage& dest,
 	                               const OperatorStorage& src)
 	{
-		if (dest.justCRS() && src.justCRS())
-			return transposeConjugate(dest.crs_, src.getCRS());
-
-		err("OperatorStorage: transposeConjugate\n");
+		dest.toCrs();
+		transposeConjugate(dest.crs_, src.getCRS());
 	}
 
 	friend void fromCRS(OperatorStorage& dest,
 	                    const PsimagLite::CrsMatrix<ComplexOrRealType>& src)
 	{
-		if (dest.justCrs_) {
-			dest.crs_ = src;
-			return;
-		}
-
-		throw PsimagLite::RuntimeError("OperatorStorage: fromCRS\n");
+		dest.toCrs();
+		dest.crs_ = src;
 	}
 
 	friend void bcast(OperatorStorage& dest)
 	{
-		if (dest.justCrs_)
-			return bcast(dest.crs_);
-
-		err("OperatorStorage: bcast\n");
+		dest.toCrs();
+		bcast(dest.crs_);
 	}
 
 	// See CrsMatrix.h line 734
@@ -238,30 +295,54 @@ public:
 	                             bool order,
 	                             const VectorSizeType& permutationFull)
 	{
-		if (B.justCRS() && A.justCRS())
-			return externalProduct(B.crs_,
-			                       A.getCRS(),
-			                       nout,
-			                       signs,
-			                       order,
-			                       permutationFull);
-
-		throw PsimagLite::RuntimeError("OperatorStorage: externalProduct\n");
+		B.toCrs();
+		externalProduct(B.crs_,
+		                A.getCRS(),
+		                nout,
+		                signs,
+		                order,
+		                permutationFull);
 	}
 
 	friend void fullMatrixToCrsMatrix(OperatorStorage& dest,
 	                                  const PsimagLite::Matrix<ComplexOrRealType>& src)
 	{
-		if (dest.justCrs_)
-			return fullMatrixToCrsMatrix(dest.crs_, src);
-
-		err("OperatorStorage: fullMatrixToCrsMatrix\n");
+		dest.toCrs();
+		fullMatrixToCrsMatrix(dest.crs_, src);
 	}
 
 private:
 
-	bool justCrs_;
-	SparseMatrixType crs_;
+	// back to CRS storage, before changing the CRS matrix
+	void toCrs()
+	{
+		getCRS();
+	}
+
+	void copyFrom(const OperatorStorage& other)
+	{
+		std::lock_guard<std::mutex> guard(other.mutex_);
+		if (other.justCrs_) {
+			crs_ = other.crs_;
+			return;
+		}
+
+		blocked_ = new BlockOffDiagMatrixType(*other.blocked_);
+		justCrs_ = false;
+	}
+
+	SizeType crsBytes() const
+	{
+		return crs_.nonZeros()*(sizeof(ComplexOrRealType) + sizeof(SizeType)) +
+		        (crs_.rows() + 1)*sizeof(SizeType);
+	}
+
+	// justCrs_ changes in getCRS(), which is const; blocked_ and crs_ are
+	// then only read or written under mutex_
+	mutable std::atomic<bool> justCrs_;
+	mutable SparseMatrixType crs_;
+	mutable BlockOffDiagMatrixType* blocked_;
+	mutable std::mutex mutex_;
 };
 
 template<typename ComplexOrRealType>
@@ -269,10 +350,7 @@ OperatorStorage<ComplexOrRealType>
 operator*(const typename OperatorStorage<ComplexOrRealType>::RealType& value,
           const OperatorStorage<ComplexOrRealType>& storage)
 {
-	if (storage.justCRS())
-		return storage.getCRS()*value;
-
-	throw PsimagLite::RuntimeError("OperatorStorage: operator*\n");
+	return storage.getCRS()*value;
 }
 
 template<typename ComplexOrRealType>
@@ -280,57 +358,39 @@ OperatorStorage<ComplexOrRealType>
 operator*(const OperatorStorage<ComplexOrRealType>& a,
           const OperatorStorage<ComplexOrRealType>& b)
 {
-	if (a.justCRS() && b.justCRS())
-		return OperatorStorage<ComplexOrRealType>(a.getCRS()*b.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: operator*\n");
+	return OperatorStorage<ComplexOrRealType>(a.getCRS()*b.getCRS());
 }
 
 template<typename ComplexOrRealType>
 void crsMatrixToFullMatrix(PsimagLite::Matrix<ComplexOrRealType>& dest,
                            const OperatorStorage<ComplexOrRealType>& src)
 {
-	if (src.justCRS())
-		return crsMatrixToFullMatrix(dest, src.getCRS());
-
-	err("OperatorStorage: crsMatrixToFullMatrix\n");
+	return crsMatrixToFullMatrix(dest, src.getCRS());
 }
 
 template<typename ComplexOrRealType>
 PsimagLite::Matrix<ComplexOrRealType> multiplyTc(const OperatorStorage<ComplexOrRealType>& src1,
                                                  const OperatorStorage<ComplexOrRealType>& src2)
 {
-	if (src1.justCRS() && src2.justCRS())
-		return multiplyTc(src1.getCRS(), src2.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: multiplyTc\n");
+	return multiplyTc(src1.getCRS(), src2.getCRS());
 }
 
 template<typename ComplexOrRealType>
 bool isHermitian(const OperatorStorage<ComplexOrRealType>& src)
 {
-	if (src.justCRS())
-		return isHermitian(src.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: isHermitian\n");
+	return isHermitian(src.getCRS());
 }
 
 template<typename ComplexOrRealType>
 bool isAntiHermitian(const OperatorStorage<ComplexOrRealType>& src)
 {
-	if (src.justCRS())
-		return isAntiHermitian(src.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: isHermitian\n");
+	return isAntiHermitian(src.getCRS());
 }
 
 template<typename ComplexOrRealType>
 bool isTheIdentity(const OperatorStorage<ComplexOrRealType>& src)
 {
-	if (src.justCRS())
-		return isTheIdentity(src.getCRS());
-
-	throw PsimagLite::RuntimeError("OperatorStorage: isTheIdentity\n");
+	return isTheIdentity(src.getCRS());
 }
 
 template<typename ComplexOrRealType>
@@ -81,6 +81,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 #include "ReducedOperators.h"
 #include <cassert>
+#include <algorithm>
 #include "ProgressIndicator.h"
 #include "Complex.h"
 #include "Concurrency.h"
@@ -146,12 +147,20 @@ public:
 		      ftransform(ftransform1),
 		      thisBasis(thisBasis1),
 		      hasMpi_(ConcurrencyType::hasMpi()),
-		      startEnd_(startEnd)
+		      startEnd_(startEnd),
+		      weights_(tasks(), 1)
 		{
 			reducedOpImpl_.prepareTransform(ftransform,thisBasis);
+
+			if (BasisType::useSu2Symmetry()) return;
+
+			for (SizeType k = 0; k < operators_.size(); ++k) {
+				if (isExcluded(k)) continue;
+				weights_[k] = cost(operators_[k].getStorage());
+			}
 		}
 
-		void doTask(SizeType taskNumber, SizeType)
+		void doTask(SizeType taskNumber, SizeType threadNum)
 		{
 			SizeType k = taskNumber;
 			if (isExcluded(k) && k < operators_.size()) {
@@ -160,11 +169,14 @@ public:
 			}
 
 			if (!BasisType::useSu2Symmetry())
-				reducedOpImpl_.changeBasis(operators_[k].getStorageNonConst());
+				reducedOpImpl_.changeBasis(operators_[k].getStorageNonConst(), threadNum);
 			else
 				reducedOpImpl_.changeBasis(k);
 		}
 
+		// so that threads get about the same work, see cost(...)
+		const VectorSizeType& weights() const { return weights_; }
+
 		SizeType tasks() const
 		{
 			if (BasisType::useSu2Symmetry()) return reducedOpImpl_.size();
@@ -186,6 +198,32 @@ public:
 
 	private:
 
+		// About the flops of changing the basis of s: each non zero block
+		// of rows x cols costs rows*cols*(rows + cols). CRS storage is not
+		// yet in blocks; its non zeros go to blocks of the average size
+		SizeType cost(const StorageType& s) const
+		{
+			if (s.justCRS()) {
+				const SizeType blocks = std::max(ftransform.blocks(),
+				                                 static_cast<SizeType>(1));
+				return 1 + 2*s.nonZeros()*(s.rows()/blocks);
+			}
+
+			const typename StorageType::BlockOffDiagMatrixType& m = s.getBlocked();
+			const SizeType n = m.offsets(true).size();
+			SizeType sum = 1;
+			for (SizeType i = 0; i + 1 < n; ++i) {
+				for (SizeType j = 0; j + 1 < n; ++j) {
+					const typename StorageType::BlockOffDiagMatrixType::value_type* b =
+					        m.block(i, j);
+					if (b == 0) continue;
+					sum += b->rows()*b->cols()*(b->rows() + b->cols());
+				}
+			}
+
+			return sum;
+		}
+
 		bool isExcluded(SizeType k) const
 		{
 			if (changeAll_ == ChangeAllEnum::TRUE_SET)
@@ -214,6 +252,7 @@ public:
 		const BasisType* thisBasis;
 		bool hasMpi_;
 		const PairSizeSizeType& startEnd_;
+		VectorSizeType weights_;
 	};
 
 	Operators(const BasisType* thisBasis)
@@ -323,7 +362,7 @@ public:
 
 		MyLoop helper(reducedOpImpl_,operators_,ftransform,thisBasis,startEnd);
 
-		threadObject.loopCreate(helper); // FIXME: needs weights
+		threadObject.loopCreate(helper, helper.weights());
 
 		helper.gather();
 
@@ -103,7 +103,8 @@ public:
 	                           const SparseMatrixType& O2,
 	                           ProgramGlobals::FermionOrBosonEnum fermionicSign,
 	                           PsimagLite::String bra,
-	                           PsimagLite::String ket)
+	                           PsimagLite::String ket,
+	                           bool byRow = false)
 	    : w_(w),
 	      twopoint_(twopoint),
 	      pairs_(pairs),
@@ -111,13 +112,26 @@ public:
 	      O2_(O2),
 	      fermionicSign_(fermionicSign),
 	      bra_(bra),
-	      ket_(ket)
+	      ket_(ket),
+	      byRow_(byRow)
 	{}
 
+	// If byRow is true, then each pair (i, cols) is a whole row i,
+	// and all j with i <= j < cols are computed
 	void doTask(SizeType taskNumber, SizeType)
 	{
 		SizeType i = pairs_[taskNumber].first;
 		SizeType j = pairs_[taskNumber].second;
+		if (byRow_)
+			return twopoint_.calcCorrelationRow(w_,
+			                                    i,
+			                                    j,
+			                                    O1_,
+			                                    O2_,
+			                                    fermionicSign_,
+			                                    bra_,
+			                                    ket_);
+
 		w_(i,j) = twopoint_.calcCorrelation(i,
 		                                    j,
 		                                    O1_,
@@ -139,6 +153,7 @@ private:
 	const ProgramGlobals::FermionOrBosonEnum fermionicSign_;
 	const PsimagLite::String bra_;
 	const PsimagLite::String ket_;
+	const bool byRow_;
 }; // class Parallel2PointCorrelations
 } // namespace Dmrg 
 
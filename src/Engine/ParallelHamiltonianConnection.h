@@ -2,6 +2,7 @@
 #define PARALLELHAMILTONIANCONNECTION_H
 #include "Concurrency.h"
 #include "Vector.h"
+#include <algorithm>
 
 namespace Dmrg {
 
@@ -20,19 +21,33 @@ class ParallelHamiltonianConnection {
 
 public:
 
+	// If rowPartitioned is true then each task owns a contiguous slice of rows of x,
+	// and loops over all connections for its slice.
+	// No per-thread copies of x nor reduction are then needed.
+	// Note that rowPartitioned is ignored if MPI is enabled for this code section
 	ParallelHamiltonianConnection(VectorType& x,
 	                              const VectorType& y,
-	                              const HamiltonianConnectionType& hc)
+	                              const HamiltonianConnectionType& hc,
+	                              bool rowPartitioned = false)
 	    : x_(x),
 	      y_(y),
 	      hc_(hc),
-	      xtemp_(ConcurrencyType::storageSize(ConcurrencyType::codeSectionParams.npthreads))
+	      rowPartitioned_(rowPartitioned &&
+	                      ConcurrencyType::isMpiDisabled("HamiltonianConnection")),
+	      rowTasks_(std::min(hc.codeSectionParams().npthreads,
+	                         static_cast<SizeType>(x.size()))),
+	      xtemp_((rowPartitioned_) ?
+	                 0 : ConcurrencyType::storageSize(hc.codeSectionParams().npthreads))
 	{
 		hc_.modelHelper().clearThreadSelves();
+		if (rowTasks_ == 0) rowTasks_ = 1;
 	}
 
 	void doTask(SizeType taskNumber ,SizeType threadNum)
 	{
+		if (rowPartitioned_)
+			return doTaskRows(taskNumber);
+
 		if (xtemp_[threadNum].size() != x_.size())
 			xtemp_[threadNum].resize(x_.size(),0.0);
 
@@ -66,10 +81,15 @@ public:
 		                           y_);
 	}
 
-	SizeType tasks() const { return hc_.tasks() + 2; }
+	SizeType tasks() const
+	{
+		return (rowPartitioned_) ? rowTasks_ : hc_.tasks() + 2;
+	}
 
 	void sync()
 	{
+		if (rowPartitioned_) return; // x_ has already been written in place
+
 		SizeType total = 0;
 		for (SizeType threadNum = 0; threadNum < xtemp_.size(); threadNum++)
 			if (xtemp_[threadNum].size() == x_.size()) total++;
@@ -94,9 +114,57 @@ public:
 
 private:
 
+	// x_[i] += (H*y_)[i] for i in the slice owned by this task
+	void doTaskRows(SizeType taskNumber)
+	{
+		SizeType total = x_.size();
+		SizeType each = total/rowTasks_;
+		SizeType remainder = total % rowTasks_;
+		SizeType rowBegin = taskNumber*each + std::min(taskNumber, remainder);
+		SizeType rowEnd = rowBegin + each + ((taskNumber < remainder) ? 1 : 0);
+		assert(rowEnd <= total);
+
+		const ModelHelperType& modelHelper = hc_.modelHelper();
+		modelHelper.hamiltonianLeftProduct(x_, y_, rowBegin, rowEnd);
+		modelHelper.hamiltonianRightProduct(x_, y_, rowBegin, rowEnd);
+
+		// only one task reports to the dumper
+		const bool dumps = (taskNumber == 0);
+		if (dumps) {
+			const SparseMatrixType& hamLeft = modelHelper.leftRightSuper().
+			        left().hamiltonian().getCRS();
+			hc_.kroneckerDumper().push(true, hamLeft, y_);
+			const SparseMatrixType& hamRight = modelHelper.leftRightSuper().
+			        right().hamiltonian().getCRS();
+			hc_.kroneckerDumper().push(false, hamRight, y_);
+		}
+
+		SizeType nlinks = hc_.tasks();
+		for (SizeType xx = 0; xx < nlinks; ++xx) {
+			OperatorStorageType const* A = 0;
+			OperatorStorageType const* B = 0;
+			const LinkType& link2 = hc_.getKron(&A, &B, xx);
+			modelHelper.fastOpProdInter(x_,
+			                            y_,
+			                            A->getCRS(),
+			                            B->getCRS(),
+			                            link2,
+			                            rowBegin,
+			                            rowEnd);
+			if (!dumps) continue;
+			hc_.kroneckerDumper().push(A->getCRS(),
+			                           B->getCRS(),
+			                           link2.value,
+			                           link2.fermionOrBoson,
+			                           y_);
+		}
+	}
+
 	VectorType& x_;
 	const VectorType& y_;
 	const HamiltonianConnectionType& hc_;
+	bool rowPartitioned_;
+	SizeType rowTasks_;
 	typename PsimagLite::Vector<VectorType>::Type xtemp_;
 };
 }
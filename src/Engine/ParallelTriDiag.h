@@ -79,6 +79,11 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 #include "Mpi.h"
 #include "Concurrency.h"
+#include "Parallelizer.h"
+#include "NoPthreadsNg.h"
+#include "ProgressIndicator.h"
+#include "SplitThreads.h"
+#include <algorithm>
 
 namespace Dmrg {
 
@@ -94,12 +99,15 @@ class ParallelTriDiag {
 	typedef typename LanczosSolverType::TridiagonalMatrixType TridiagonalMatrixType;
 	typedef typename ModelType::InputValidatorType InputValidatorType;
 	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef typename LanczosSolverType::ParametersSolverType ParametersSolverType;
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 public:
 
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type TargetVectorType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixComplexOrRealType;
 	typedef typename PsimagLite::Vector<MatrixComplexOrRealType>::Type VectorMatrixFieldType;
+	typedef typename PsimagLite::Vector<TargetVectorType>::Type VectorVectorType;
 
 	ParallelTriDiag(const VectorWithOffsetType& phi,
 	                VectorMatrixFieldType& T,
@@ -116,23 +124,201 @@ public:
 	      lrs_(lrs),
 	      currentTime_(currentTime),
 	      model_(model),
-	      io_(io)
+	      paramsForSolver_(io,"Tridiag"),
+	      progress_("ParallelTriDiag")
 	{}
 
+	// Tridiagonalizes all sectors of phi. With SolverOptions=parallelSectors,
+	// sectors run concurrently, and each matrix vector product gets
+	// threads in proportion to the size of its sector
+	void loopCreate()
+	{
+		const SizeType sectors = phi_.sectors();
+		threads_.assign(sectors, 0);
+		if (!canRunSectorsInParallel()) {
+			typedef PsimagLite::NoPthreadsNg<ParallelTriDiag> ParallelizerType;
+			ParallelizerType threadedTriDiag(PsimagLite::CodeSectionParams(1));
+			threadedTriDiag.loopCreate(*this);
+			return;
+		}
+
+		VectorSizeType weights(sectors);
+		for (SizeType ii = 0; ii < sectors; ++ii)
+			weights[ii] = phi_.effectiveSize(phi_.sector(ii));
+
+		SplitThreads split(ConcurrencyType::codeSectionParams.npthreads, weights);
+		for (SizeType ii = 0; ii < sectors; ++ii)
+			threads_[ii] = split.inner(ii);
+
+		PsimagLite::OstringStream msg;
+		msg<<"Tridiagonalizing "<<sectors<<" sectors with "<<split.outer();
+		msg<<" threads, and up to "<<split.maxInner();
+		msg<<" threads for each matrix vector product";
+		progress_.printline(msg, std::cout);
+
+		typedef PsimagLite::Parallelizer<ParallelTriDiag> ParallelizerType;
+		PsimagLite::CodeSectionParams codeSectionParams(split.outer());
+		ParallelizerType threadedTriDiag(codeSectionParams);
+		threadedTriDiag.loopCreate(*this, weights);
+	}
+
 	SizeType tasks() const { return phi_.sectors(); }
 
-	void doTask(SizeType ii, SizeType)
+	void doTask(SizeType ii, SizeType threadNum)
 	{
 		SizeType i = phi_.sector(ii);
-		steps_[ii] = triDiag(phi_,T_[ii],V_[ii],i);
+		assert(ii < threads_.size());
+		steps_[ii] = triDiag(phi_,T_[ii],V_[ii],i,threadNum,threads_[ii]);
+	}
+
+	// Two-pass mode: V has no columns because the Lanczos vectors were
+	// not stored. Regenerate them from phi and the tridiagonal matrix ab,
+	// which must not have been diagonalized yet, and set ys[x] = V*xs[x]
+	// and vTimesPhi[k] = <v_k|phi> for k < vTimesPhi.size().
+	// The first pass, without its vectors, could not have reorthogonalized,
+	// so it used the plain recurrence
+	// b_{k+1} v_{k+1} = H v_k - a_k v_k - b_k v_{k-1}, with a_k = ab(k, k)
+	// and b_{k+1} = ab(k + 1, k). That is checked on the first steps, where
+	// a_k = <v_k|H|v_k> and |b_{k+1}| = |H v_k - a_k v_k - b_k v_{k-1}| must
+	// hold to rounding; later steps only report how far they are from it
+	static void lanczosVectorsTimes(VectorVectorType& ys,
+	                                const VectorVectorType& xs,
+	                                TargetVectorType& vTimesPhi,
+	                                const MatrixComplexOrRealType& ab,
+	                                const VectorWithOffsetType& phi,
+	                                SizeType i0,
+	                                const LeftRightSuperType& lrs,
+	                                RealType currentTime,
+	                                const ModelType& model)
+	{
+		SizeType total = phi.effectiveSize(i0);
+		TargetVectorType phi2(total);
+		phi.extract(phi2,i0);
+
+		SizeType n2 = vTimesPhi.size();
+		ys.resize(xs.size());
+		for (SizeType x = 0; x < xs.size(); ++x) {
+			if (xs[x].size() > n2) n2 = xs[x].size();
+			ys[x].resize(total);
+			std::fill(ys[x].begin(), ys[x].end(), 0.0);
+		}
+
+		if (n2 == 0) return;
+		assert(n2 <= ab.rows());
+
+		RealType norm2 = 0;
+		for (SizeType i = 0; i < total; ++i)
+			norm2 += PsimagLite::real(PsimagLite::conj(phi2[i])*phi2[i]);
+
+		if (norm2 == 0)
+			err("ParallelTriDiag: cannot regenerate Lanczos vectors of a zero vector\n");
+
+		const RealType factor = 1.0/sqrt(norm2);
+		TargetVectorType v(total);
+		for (SizeType i = 0; i < total; ++i)
+			v[i] = phi2[i]*factor;
+
+		TargetVectorType vold(total, 0.0);
+		TargetVectorType w(total);
+		RealType maxDeviation = 0;
+		const SizeType stepsChecked = 3;
+
+		SizeType p = lrs.super().findPartitionNumber(phi.offset(i0));
+		typename ModelType::HamiltonianConnectionType hc(p,
+		                                                 lrs,
+		                                                 model.geometry(),
+		                                                 ModelType::modelLinks(),
+		                                                 currentTime,
+		                                                 0);
+		typename LanczosSolverType::MatrixType lanczosHelper(model, hc);
+
+		for (SizeType k = 0; k < n2; ++k) {
+			if (k < vTimesPhi.size()) {
+				ComplexOrRealType sum = 0.0;
+				for (SizeType i = 0; i < total; ++i)
+					sum += PsimagLite::conj(v[i])*phi2[i];
+				vTimesPhi[k] = sum;
+			}
+
+			for (SizeType x = 0; x < xs.size(); ++x) {
+				if (k >= xs[x].size()) continue;
+				const ComplexOrRealType c = xs[x][k];
+				for (SizeType i = 0; i < total; ++i)
+					ys[x][i] += c*v[i];
+			}
+
+			if (k + 1 == n2) break;
+
+			std::fill(w.begin(), w.end(), 0.0);
+			lanczosHelper.matrixVectorProduct(w, v);
+			const ComplexOrRealType a = ab(k, k);
+			const ComplexOrRealType b = (k > 0) ? ab(k, k - 1) : 0.0;
+			const ComplexOrRealType bnext = ab(k + 1, k);
+			if (std::abs(bnext) == 0) break;
+
+			ComplexOrRealType vHv = 0.0;
+			for (SizeType i = 0; i < total; ++i)
+				vHv += PsimagLite::conj(v[i])*w[i];
+
+			RealType norm2w = 0;
+			for (SizeType i = 0; i < total; ++i) {
+				w[i] -= a*v[i] + b*vold[i];
+				norm2w += PsimagLite::real(PsimagLite::conj(w[i])*w[i]);
+			}
+
+			const RealType scale = std::abs(a) + std::abs(b) + std::abs(bnext);
+			const RealType deviation = (std::abs(vHv - a) +
+			                            fabs(sqrt(norm2w) - std::abs(bnext)))/scale;
+			if (deviation > maxDeviation) maxDeviation = deviation;
+			if (k < stepsChecked && deviation > 1e-8)
+				err("ParallelTriDiag: the tridiagonal matrix does not follow the"
+				    " three-term recurrence; use TridiagMemoryBudget=0\n");
+
+			for (SizeType i = 0; i < total; ++i)
+				w[i] /= bnext;
+
+			vold.swap(v);
+			v.swap(w);
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"Regenerated "<<n2<<" Lanczos vectors of sector "<<i0;
+		msg<<", max. relative deviation from the tridiagonal matrix "<<maxDeviation;
+		PsimagLite::ProgressIndicator progress("ParallelTriDiag");
+		progress.printline(msg, std::cout);
 	}
 
 private:
 
+	bool canRunSectorsInParallel() const
+	{
+		if (phi_.sectors() < 2) return false;
+		if (ConcurrencyType::codeSectionParams.npthreads < 2) return false;
+
+		const PsimagLite::String& options = model_.params().options;
+		if (options.find("parallelSectors") == PsimagLite::String::npos) return false;
+		if (options.find("KroneckerDumper") != PsimagLite::String::npos) return false;
+
+		return ConcurrencyType::isMpiDisabled("ParallelTriDiag");
+	}
+
+	// Memory needed to keep all Lanczos vectors of a sector, compared
+	// to TridiagMemoryBudget (in megabytes, zero means no budget)
+	bool needsTwoPass(SizeType total, SizeType maxSteps) const
+	{
+		const SizeType budget = model_.params().tridiagMemoryBudget;
+		if (budget == 0) return false;
+		const long double bytes = static_cast<long double>(total)*maxSteps*
+		        sizeof(ComplexOrRealType);
+		return (bytes > static_cast<long double>(budget)*1024*1024);
+	}
+
 	SizeType triDiag(const VectorWithOffsetType& phi,
 	                 MatrixComplexOrRealType& T,
 	                 MatrixComplexOrRealType& V,
-	                 SizeType i0)
+	                 SizeType i0,
+	                 SizeType threadNum,
+	                 SizeType threads)
 	{
 		SizeType p = lrs_.super().findPartitionNumber(phi.offset(i0));
 		typename ModelType::HamiltonianConnectionType hc(p,
@@ -140,22 +326,29 @@ private:
 		                                                 model_.geometry(),
 		                                                 ModelType::modelLinks(),
 		                                                 currentTime_,
-		                                                 0);
+		                                                 0,
+		                                                 threads);
 		typename LanczosSolverType::MatrixType lanczosHelper(model_, hc);
 
-		typename LanczosSolverType::ParametersSolverType params(io_,"Tridiag");
-		params.lotaMemory = true;
+		ParametersSolverType params = paramsForSolver_;
+		params.threadId = threadNum;
+		SizeType total = phi.effectiveSize(i0);
+		const bool twoPass = needsTwoPass(total, params.steps);
+		params.lotaMemory = !twoPass;
 
 		LanczosSolverType lanczosSolver(lanczosHelper, params);
 
 		TridiagonalMatrixType ab;
-		SizeType total = phi.effectiveSize(i0);
 		TargetVectorType phi2(total);
 		phi.extract(phi2,i0);
 		lanczosSolver.decomposition(phi2,ab);
 		ab.buildDenseMatrix(T);
 
-		V = lanczosSolver.lanczosVectors();
+		// see lanczosVectorsTimes()
+		if (twoPass)
+			V.clear();
+		else
+			V = lanczosSolver.lanczosVectors();
 
 		return lanczosSolver.steps();
 	}
@@ -167,7 +360,9 @@ private:
 	const LeftRightSuperType& lrs_;
 	RealType currentTime_;
 	const ModelType& model_;
-	InputValidatorType& io_;
+	const ParametersSolverType paramsForSolver_;
+	PsimagLite::ProgressIndicator progress_;
+	VectorSizeType threads_;
 }; // class ParallelTriDiag
 } // namespace Dmrg
 
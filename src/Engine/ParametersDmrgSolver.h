@@ -129,6 +129,27 @@ The first movement starts from where the infinite loop left off, at the middle o
  lattice.
 See the below for more information and examples on Finite Loops.
 
+\item[TridiagMemoryBudget=integer] Optional, in megabytes. If the Lanczos vectors
+of one sector for Krylov time evolution or correction vectors would need more than
+this, they are not stored. Instead they are regenerated from the tridiagonal
+matrix when needed, at the cost of extra matrix vector products.
+Zero, the default, means no budget.
+
+\item[ShrinkStacksMemoryBudget=integer] Optional, in megabytes, and only used
+with SolverOptions=shrinkStacksOnDisk. The most recent bases of the system
+and environ shrink stacks, half of the budget each, are kept in memory,
+and only the older ones spill to disk.
+Zero, the default, means that all bases go to disk.
+
+\item[DavidsonMaxSubspace=integer] Optional, and only used with
+SolverOptions=preconditionedDavidson. The largest number of vectors of the
+Davidson subspace before it restarts; at least 2. Defaults to 24.
+
+\item[DavidsonMinDenominator=real] Optional, and only used with
+SolverOptions=preconditionedDavidson. The smallest |theta - H_{i,i}| that the
+diagonal preconditioner divides by; smaller ones are replaced by it.
+Defaults to 1e-4.
+
 \end{itemize}
 */
 template<typename FieldType,typename InputValidatorType, typename QnType>
@@ -166,6 +187,10 @@ struct ParametersDmrgSolver {
 	VectorFiniteLoopType finiteLoop;
 	FieldType degeneracyMax;
 	FieldType denseSparseThreshold;
+	SizeType tridiagMemoryBudget;
+	SizeType shrinkStacksMemoryBudget;
+	SizeType davidsonMaxSubspace;
+	FieldType davidsonMinDenominator;
 
 	void write(PsimagLite::String label,
 	           PsimagLite::IoSerializer& ioSerializer) const
@@ -196,6 +221,10 @@ struct ParametersDmrgSolver {
 		ioSerializer.write(root + "/finiteLoop", finiteLoop);
 		ioSerializer.write(root + "/degeneracyMax", degeneracyMax);
 		ioSerializer.write(root + "/denseSparseThreshold", denseSparseThreshold);
+		ioSerializer.write(root + "/tridiagMemoryBudget", tridiagMemoryBudget);
+		ioSerializer.write(root + "/shrinkStacksMemoryBudget", shrinkStacksMemoryBudget);
+		ioSerializer.write(root + "/davidsonMaxSubspace", davidsonMaxSubspace);
+		ioSerializer.write(root + "/davidsonMinDenominator", davidsonMinDenominator);
 	}
 
 	template<typename SomeMemResolvType>
@@ -222,7 +251,11 @@ struct ParametersDmrgSolver {
 	      recoverySave("no"),
 	      adjustQuantumNumbers(0, QnType(false, VectorSizeType(), PairSizeType(0, 0), 0)),
 	      degeneracyMax(1e-12),
-	      denseSparseThreshold(0.2)
+	      denseSparseThreshold(0.2),
+	      tridiagMemoryBudget(0),
+	      shrinkStacksMemoryBudget(0),
+	      davidsonMaxSubspace(24),
+	      davidsonMinDenominator(1e-4)
 	{
 		io.readline(model,"Model=");
 		io.readline(options,"SolverOptions=");
@@ -357,6 +390,22 @@ struct ParametersDmrgSolver {
 			io.readline(denseSparseThreshold, "DenseSparseThreshold=");
 		} catch (std::exception&) {}
 
+		try {
+			io.readline(tridiagMemoryBudget, "TridiagMemoryBudget=");
+		} catch (std::exception&) {}
+
+		try {
+			io.readline(shrinkStacksMemoryBudget, "ShrinkStacksMemoryBudget=");
+		} catch (std::exception&) {}
+
+		try {
+			io.readline(davidsonMaxSubspace, "DavidsonMaxSubspace=");
+		} catch (std::exception&) {}
+
+		try {
+			io.readline(davidsonMinDenominator, "DavidsonMinDenominator=");
+		} catch (std::exception&) {}
+
 		if (isObserveCode) return;
 		bool hasRestart = false;
 		PsimagLite::String restartFrom;
@@ -579,6 +628,10 @@ struct ParametersDmrgSolver {
 
 		os<<"parameters.degeneracyMax="<<p.degeneracyMax<<"\n";
 		os<<"parameters.denseSparseThreshold="<<p.denseSparseThreshold<<"\n";
+		os<<"parameters.tridiagMemoryBudget="<<p.tridiagMemoryBudget<<"\n";
+		os<<"parameters.shrinkStacksMemoryBudget="<<p.shrinkStacksMemoryBudget<<"\n";
+		os<<"parameters.davidsonMaxSubspace="<<p.davidsonMaxSubspace<<"\n";
+		os<<"parameters.davidsonMinDenominator="<<p.davidsonMinDenominator<<"\n";
 		os<<"parameters.nthreads="<<p.nthreads<<"\n";
 		os<<"parameters.useReflectionSymmetry="<<p.useReflectionSymmetry<<"\n";
 		os<<p.checkpoint;
@@ -0,0 +1,205 @@
+#ifndef PARTIALSVD_H
+#define PARTIALSVD_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "BLAS.h"
+#include "Random48.h"
+
+namespace Dmrg {
+
+// Leading singular triplets of one symmetry block by randomized range finding
+// (Halko, Martinsson, Tropp), for truncations that keep few states
+template<typename ComplexOrRealType>
+class PartialSvd {
+
+public:
+
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+
+	PartialSvd(SizeType keptStates, RealType tolerance, SizeType seed)
+	    : keptStates_(keptStates),
+	      tolerance_((tolerance < 0) ? 0 : tolerance),
+	      rng_(seed)
+	{}
+
+	// Returns false when the block is too small to benefit or when the
+	// sampled subspace cannot be trusted; the caller then does a full SVD.
+	// Otherwise u is a square unitary whose leading columns are the left
+	// singular vectors of m, eigs has only the squared singular values that
+	// were computed, in decreasing order, and residual is the weight of
+	// the remaining columns of u, which were not computed
+	bool operator()(MatrixType& u,
+	                VectorRealType& eigs,
+	                RealType& residual,
+	                const MatrixType& m)
+	{
+		const SizeType rows = m.rows();
+		const SizeType cols = m.cols();
+		const SizeType l = std::min(keptStates_ + oversampling_, std::min(rows, cols));
+		if (rows < minRows_ || l == 0 || 2*l > rows) return false;
+
+		RealType frobenius = 0;
+		for (SizeType j = 0; j < cols; ++j)
+			for (SizeType i = 0; i < rows; ++i)
+				frobenius += std::norm(m(i, j));
+
+		MatrixType omega(cols, l);
+		for (SizeType j = 0; j < l; ++j)
+			for (SizeType i = 0; i < cols; ++i)
+				myRandomT(omega(i, j));
+
+		MatrixType y(rows, l);
+		gemm('N', 'N', y, m, omega);
+		MatrixType q;
+		householder(q, y, l);
+
+		MatrixType z(cols, l);
+		MatrixType qz;
+		for (SizeType it = 0; it < powerIterations_; ++it) {
+			gemm('C', 'N', z, m, q);
+			householder(qz, z, l);
+			gemm('N', 'N', y, m, qz);
+			householder(q, y, l);
+		}
+
+		// b = q^\dagger m is small, and so is b b^\dagger
+		MatrixType b(l, cols);
+		gemm('C', 'N', b, q, m);
+		MatrixType c(l, l);
+		gemm('N', 'C', c, b, b);
+		VectorRealType w(l);
+		diag(c, w, 'V');
+
+		RealType captured = 0;
+		for (SizeType i = 0; i < l; ++i) {
+			if (w[i] < 0) w[i] = 0;
+			captured += w[i];
+		}
+
+		residual = frobenius - captured;
+		if (residual < 0) residual = 0;
+
+		// no state left out can outweigh one we computed, unless
+		// what was left out is below tolerance anyway
+		if (residual > w[0] && residual > tolerance_) return false;
+
+		MatrixType ul(rows, l);
+		gemm('N', 'N', ul, q, c);
+
+		householder(u, ul, rows);
+		for (SizeType j = 0; j < l; ++j)
+			for (SizeType i = 0; i < rows; ++i)
+				u(i, j) = ul(i, l - 1 - j);
+
+		eigs.resize(l);
+		for (SizeType i = 0; i < l; ++i)
+			eigs[i] = w[l - 1 - i];
+
+		return true;
+	}
+
+private:
+
+	// result = op(a) * op(b), with result already sized
+	static void gemm(char opA, char opB, MatrixType& result, const MatrixType& a, const MatrixType& b)
+	{
+		const int mm = result.rows();
+		const int nn = result.cols();
+		const int kk = (opA == 'N') ? a.cols() : a.rows();
+		const ComplexOrRealType alpha = 1.0;
+		const ComplexOrRealType beta = 0.0;
+		psimag::BLAS::GEMM(opA,
+		                   opB,
+		                   mm,
+		                   nn,
+		                   kk,
+		                   alpha,
+		                   &(a(0, 0)),
+		                   a.rows(),
+		                   &(b(0, 0)),
+		                   b.rows(),
+		                   beta,
+		                   &(result(0, 0)),
+		                   result.rows());
+	}
+
+	// Householder QR of a (rows >= cols); q gets the first qcols columns
+	// of the unitary factor, which is always orthonormal, even if a is
+	// rank deficient
+	static void householder(MatrixType& q, MatrixType a, SizeType qcols)
+	{
+		const SizeType rows = a.rows();
+		const SizeType n = a.cols();
+		assert(n <= rows && qcols <= rows);
+		MatrixType v(rows, n);
+		v.setTo(0.0);
+		for (SizeType j = 0; j < n; ++j) {
+			RealType norm2 = 0;
+			for (SizeType i = j; i < rows; ++i)
+				norm2 += std::norm(a(i, j));
+
+			const RealType absx0 = std::abs(a(j, j));
+			const ComplexOrRealType phase = (absx0 > 0) ? a(j, j)/absx0 : 1.0;
+			for (SizeType i = j; i < rows; ++i)
+				v(i, j) = a(i, j);
+			v(j, j) += phase*std::sqrt(norm2);
+
+			RealType vnorm2 = 0;
+			for (SizeType i = j; i < rows; ++i)
+				vnorm2 += std::norm(v(i, j));
+
+			if (vnorm2 == 0) continue;
+
+			const RealType factor = 1.0/std::sqrt(vnorm2);
+			for (SizeType i = j; i < rows; ++i)
+				v(i, j) *= factor;
+
+			reflect(a, v, j, j);
+		}
+
+		q.resize(rows, qcols);
+		q.setTo(0.0);
+		for (SizeType i = 0; i < qcols; ++i)
+			q(i, i) = 1.0;
+
+		for (SizeType j = n; j > 0; --j)
+			reflect(q, v, j - 1, 0);
+	}
+
+	// a(j:, c0:) -= 2 v_j (v_j^\dagger a(j:, c0:))
+	static void reflect(MatrixType& a, const MatrixType& v, SizeType j, SizeType c0)
+	{
+		const SizeType rows = a.rows();
+		for (SizeType c = c0; c < a.cols(); ++c) {
+			ComplexOrRealType sum = 0.0;
+			for (SizeType i = j; i < rows; ++i)
+				sum += PsimagLite::conj(v(i, j))*a(i, c);
+
+			sum *= 2.0;
+			for (SizeType i = j; i < rows; ++i)
+				a(i, c) -= v(i, j)*sum;
+		}
+	}
+
+	void myRandomT(std::complex<RealType>& value)
+	{
+		value = std::complex<RealType>(rng_() - 0.5, rng_() - 0.5);
+	}
+
+	void myRandomT(RealType& value)
+	{
+		value = rng_() - 0.5;
+	}
+
+	static const SizeType oversampling_ = 10;
+	static const SizeType powerIterations_ = 2;
+	static const SizeType minRows_ = 64;
+
+	SizeType keptStates_;
+	RealType tolerance_;
+	PsimagLite::Random48<RealType> rng_;
+};
+}
+#endif // PARTIALSVD_H
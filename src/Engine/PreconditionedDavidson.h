@@ -0,0 +1,257 @@
+#ifndef PRECONDITIONEDDAVIDSON_H
+#define PRECONDITIONEDDAVIDSON_H
+#include "Vector.h"
+#include "Matrix.h"
+#include "ProgressIndicator.h"
+#include "TypeToString.h"
+
+namespace Dmrg {
+
+// Davidson with the diagonal (Jacobi) preconditioner: the correction vector
+// is t_i = r_i/(theta - H_{i,i}), where r is the residual of the Ritz pair
+// (theta, u). The matrix must have diagonal(d); if d comes back empty
+// the correction is the residual itself. The vectors may be the rows of
+// this MPI rank only, see MatrixVectorKron::distributed(); then each scalar
+// product is summed over ranks with the matrix's sumOverRanks().
+// The largest subspace and the smallest |theta - H_{i,i}| come from the
+// input, see DavidsonMaxSubspace= and DavidsonMinDenominator=
+template<typename ParametersType, typename MatrixType, typename VectorType>
+class PreconditionedDavidson {
+
+	typedef typename VectorType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixFieldType;
+
+public:
+
+	PreconditionedDavidson(const MatrixType& mat,
+	                       const ParametersType& params,
+	                       SizeType maxSubspace,
+	                       RealType minDenominator)
+	    : mat_(mat),
+	      maxMatrixVectorProducts_(params.steps),
+	      tolerance_((params.tolerance > 0) ? params.tolerance : 1e-10),
+	      maxSubspace_(maxSubspace),
+	      minDenominator_(minDenominator),
+	      progress_("PreconditionedDavidson")
+	{
+		if (maxSubspace_ < 2)
+			err("PreconditionedDavidson: DavidsonMaxSubspace must be at least 2\n");
+		if (minDenominator_ <= 0)
+			err("PreconditionedDavidson: DavidsonMinDenominator must be positive\n");
+	}
+
+	// Lowest eigenpair if excited == 0, and else the excited-th one
+	// of the subspace. Throws if it does not converge within the
+	// allowed matrix vector products, as the PsimagLite solvers do, or
+	// if the correction vector adds nothing to the subspace
+	void computeOneState(RealType& energy,
+	                     VectorType& z,
+	                     const VectorType& initialVector,
+	                     SizeType excited)
+	{
+		const SizeType n = initialVector.size();
+		const SizeType maxSubspace = std::min(mat_.rows(), std::max(maxSubspace_, excited + 2));
+		const SizeType keep = std::min(excited + 2, maxSubspace - 1);
+
+		VectorType diagonal;
+		mat_.diagonal(diagonal);
+
+		VectorVectorType v;
+		VectorVectorType w;
+		MatrixFieldType h(maxSubspace, maxSubspace);
+		VectorType t = initialVector;
+		VectorType r(n);
+		VectorRealType eigs;
+		MatrixFieldType s;
+		RealType rnorm = 0;
+		SizeType products = 0;
+		bool converged = false;
+
+		while (products < maxMatrixVectorProducts_) {
+			if (!addToSubspace(v, w, h, t)) {
+				if (v.size() == 0) break;
+
+				// t in span(v): the subspace cannot grow any more
+				throw PsimagLite::RuntimeError("PreconditionedDavidson: correction " +
+				                               PsimagLite::String("is in the subspace, ") +
+				                               "residual=" + ttos(rnorm) + " after " +
+				                               ttos(products) + " matrix vector products" +
+				                               ", try another DavidsonMinDenominator\n");
+			}
+
+			++products;
+
+			const SizeType k = v.size();
+			s.resize(k, k);
+			for (SizeType j = 0; j < k; ++j)
+				for (SizeType i = 0; i < k; ++i)
+					s(i, j) = h(i, j);
+			eigs.resize(k);
+			diag(s, eigs, 'V');
+
+			const SizeType target = std::min(excited, k - 1);
+			energy = eigs[target];
+			ritz(z, v, s, target);
+			ritz(r, w, s, target);
+			for (SizeType i = 0; i < n; ++i)
+				r[i] -= energy*z[i];
+
+			rnorm = norm(r);
+			if (rnorm < tolerance_ && k > excited) {
+				converged = true;
+				break;
+			}
+
+			precondition(t, r, diagonal, energy);
+
+			if (k < maxSubspace) continue;
+
+			restart(v, w, h, s, eigs, keep);
+		}
+
+		if (v.size() == 0)
+			throw PsimagLite::RuntimeError("PreconditionedDavidson: initial vector is zero\n");
+
+		PsimagLite::OstringStream msg;
+		msg<<"Energy="<<energy<<" after "<<products<<" matrix vector products";
+		msg<<", residual="<<rnorm<<" preconditioned="<<((diagonal.size() > 0) ? 1 : 0);
+		progress_.printline(msg, std::cout);
+
+		if (converged) return;
+
+		throw PsimagLite::RuntimeError("PreconditionedDavidson: not converged, residual=" +
+		                               ttos(rnorm) + " after " + ttos(products) +
+		                               " matrix vector products\n");
+	}
+
+private:
+
+	// Orthonormalizes t against v, then appends it to v, H*t to w, and
+	// the new column and row to h. Returns false if t is in span(v)
+	bool addToSubspace(VectorVectorType& v,
+	                   VectorVectorType& w,
+	                   MatrixFieldType& h,
+	                   VectorType& t) const
+	{
+		const RealType norm0 = norm(t);
+		if (norm0 == 0) return false;
+
+		// classical Gram-Schmidt, twice is enough; one sum over ranks per pass
+		const SizeType k = v.size();
+		VectorType c(k);
+		for (SizeType pass = 0; pass < 2 && k > 0; ++pass) {
+			for (SizeType j = 0; j < k; ++j)
+				c[j] = scalarProduct(v[j], t);
+			mat_.sumOverRanks(c);
+			for (SizeType j = 0; j < k; ++j)
+				for (SizeType i = 0; i < t.size(); ++i)
+					t[i] -= c[j]*v[j][i];
+		}
+
+		const RealType norm1 = norm(t);
+		if (norm1 < 1e-12*norm0) return false;
+
+		const RealType factor = 1.0/norm1;
+		for (SizeType i = 0; i < t.size(); ++i)
+			t[i] *= factor;
+
+		VectorType ht(t.size(), 0.0);
+		mat_.matrixVectorProduct(ht, t);
+
+		v.push_back(t);
+		w.push_back(ht);
+		VectorType column(k + 1);
+		for (SizeType j = 0; j <= k; ++j)
+			column[j] = scalarProduct(v[j], ht);
+		mat_.sumOverRanks(column);
+		for (SizeType j = 0; j <= k; ++j) {
+			h(j, k) = column[j];
+			h(k, j) = PsimagLite::conj(h(j, k));
+		}
+
+		h(k, k) = PsimagLite::real(h(k, k));
+		return true;
+	}
+
+	void precondition(VectorType& t,
+	                  const VectorType& r,
+	                  const VectorType& diagonal,
+	                  RealType theta) const
+	{
+		t = r;
+		if (diagonal.size() != r.size()) return;
+
+		for (SizeType i = 0; i < t.size(); ++i) {
+			RealType denominator = theta - PsimagLite::real(diagonal[i]);
+			if (fabs(denominator) < minDenominator_)
+				denominator = (denominator < 0) ? -minDenominator_ : minDenominator_;
+			t[i] /= denominator;
+		}
+	}
+
+	// Keeps the lowest keep Ritz vectors
+	void restart(VectorVectorType& v,
+	             VectorVectorType& w,
+	             MatrixFieldType& h,
+	             const MatrixFieldType& s,
+	             const VectorRealType& eigs,
+	             SizeType keep) const
+	{
+		VectorVectorType v2(keep);
+		VectorVectorType w2(keep);
+		for (SizeType j = 0; j < keep; ++j) {
+			ritz(v2[j], v, s, j);
+			ritz(w2[j], w, s, j);
+		}
+
+		v.swap(v2);
+		w.swap(w2);
+		h.setTo(0.0);
+		for (SizeType j = 0; j < keep; ++j)
+			h(j, j) = eigs[j];
+	}
+
+	// dest = sum_i basis[i]*s(i, col)
+	static void ritz(VectorType& dest,
+	                 const VectorVectorType& basis,
+	                 const MatrixFieldType& s,
+	                 SizeType col)
+	{
+		assert(basis.size() > 0);
+		const SizeType n = basis[0].size();
+		dest.resize(n);
+		std::fill(dest.begin(), dest.end(), 0.0);
+		for (SizeType j = 0; j < basis.size(); ++j) {
+			const ComplexOrRealType c = s(j, col);
+			for (SizeType i = 0; i < n; ++i)
+				dest[i] += c*basis[j][i];
+		}
+	}
+
+	RealType norm(const VectorType& t) const
+	{
+		VectorType sum(1, scalarProduct(t, t));
+		mat_.sumOverRanks(sum);
+		return sqrt(PsimagLite::real(sum[0]));
+	}
+
+	static ComplexOrRealType scalarProduct(const VectorType& a, const VectorType& b)
+	{
+		ComplexOrRealType sum = 0.0;
+		for (SizeType i = 0; i < a.size(); ++i)
+			sum += PsimagLite::conj(a[i])*b[i];
+		return sum;
+	}
+
+	const MatrixType& mat_;
+	SizeType maxMatrixVectorProducts_;
+	RealType tolerance_;
+	SizeType maxSubspace_;
+	RealType minDenominator_;
+	PsimagLite::ProgressIndicator progress_;
+};
+}
+#endif // PRECONDITIONEDDAVIDSON_H
@@ -417,10 +417,10 @@ public:
 		io.write(reducedOperators_, "Operators", mode);
 	}
 
-	void changeBasis(OperatorStorageType& v)
+	void changeBasis(OperatorStorageType& v, SizeType threadNum = 0)
 	{
 		if (!useSu2Symmetry_)
-			return changeOfBasis_(v);
+			return changeOfBasis_(v, threadNum);
 
 		v.rotate(su2TransformT_, su2Transform_);
 	}
@@ -0,0 +1,58 @@
+#ifndef DMRG_SPLITTHREADS_H
+#define DMRG_SPLITTHREADS_H
+#include "Vector.h"
+#include <cassert>
+#include <algorithm>
+
+namespace Dmrg {
+
+// Splits threads among tasks that run concurrently, for example the
+// sectors of a superblock: outer() threads run the tasks, and task i
+// gets inner(i) threads of its own, in proportion to weights[i], and at
+// least one. Nothing global is changed; each task must be handed its
+// inner(i), see HamiltonianConnection
+class SplitThreads {
+
+public:
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	SplitThreads(SizeType threads, const VectorSizeType& weights)
+	    : outer_(std::min(threads, static_cast<SizeType>(weights.size()))),
+	      inner_(weights.size(), 1)
+	{
+		const SizeType tasks = weights.size();
+		SizeType sum = 0;
+		for (SizeType i = 0; i < tasks; ++i)
+			sum += weights[i];
+
+		for (SizeType i = 0; i < tasks; ++i) {
+			const SizeType t = (sum == 0) ? threads/tasks
+			                              : (threads*weights[i])/sum;
+			inner_[i] = std::max(t, static_cast<SizeType>(1));
+		}
+	}
+
+	SizeType outer() const { return outer_; }
+
+	SizeType inner(SizeType i) const
+	{
+		assert(i < inner_.size());
+		return inner_[i];
+	}
+
+	SizeType maxInner() const
+	{
+		return (inner_.size() == 0) ? 1 : *std::max_element(inner_.begin(),
+		                                                     inner_.end());
+	}
+
+private:
+
+	SizeType outer_;
+	VectorSizeType inner_;
+}; // class SplitThreads
+
+} // namespace Dmrg
+
+#endif // DMRG_SPLITTHREADS_H
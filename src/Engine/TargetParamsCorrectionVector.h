@@ -94,6 +94,7 @@ public:
 
 	typedef TargetParamsCommon<ModelType> BaseType;
 	typedef typename ModelType::RealType RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef typename BaseType::BaseType::PairFreqType PairFreqType;
 	typedef typename ModelType::OperatorType OperatorType;
 	typedef typename OperatorType::PairType PairType;
@@ -122,8 +123,17 @@ public:
 			throw PsimagLite::RuntimeError(msg += "must be either Real or Matsubara\n");
 		}
 
-		RealType omega;
-		io.readline(omega,"CorrectionVectorOmega=");
+		// many omegas in one run share the Krylov space, see CorrectionVectorSkeleton
+		try {
+			io.read(omegas_,"CorrectionVectorOmegas");
+		} catch (std::exception&) {}
+
+		RealType omega = 0;
+		if (omegas_.size() == 0)
+			io.readline(omega,"CorrectionVectorOmega=");
+		else
+			omega = omegas_[0];
+
 		omega_=PairFreqType(freqEnum, omega);
 		io.readline(eta_,"CorrectionVectorEta=");
 
@@ -142,6 +152,9 @@ public:
 			throw PsimagLite::RuntimeError(str);
 		}
 
+		if (omegas_.size() > 0 && algorithm_ != BaseType::AlgorithmEnum::KRYLOV)
+			err("CorrectionVectorOmegas needs CorrectionVectorAlgorithm=Krylov\n");
+
 		try {
 			io.readline(cgSteps_,"ConjugateGradientSteps=");
 		} catch (std::exception& e) {}
@@ -187,6 +200,12 @@ public:
 		omega_ = PairFreqType(freqEnum,x);
 	}
 
+	// empty unless CorrectionVectorOmegas was given
+	const VectorRealType& omegas() const
+	{
+		return omegas_;
+	}
+
 	virtual RealType eta() const
 	{
 		return eta_;
@@ -209,6 +228,7 @@ private:
 	SizeType cgSteps_;
 	RealType correctionA_;
 	PairFreqType omega_;
+	VectorRealType omegas_;
 	RealType eta_;
 	RealType cgEps_;
 }; // class TargetParamsCorrectionVector
@@ -222,6 +242,8 @@ inline std::ostream& operator<<(std::ostream& os,
 	os<<tp;
 	os<<"DynamicDmrgType="<<t.type()<<"\n";
 	os<<"CorrectionVectorOmega="<<t.omega()<<"\n";
+	if (t.omegas().size() > 0)
+		os<<"CorrectionVectorOmegas="<<t.omegas()<<"\n";
 	os<<"CorrectionVectorEta="<<t.eta()<<"\n";
 	os<<"ConjugateGradientSteps"<<t.cgSteps()<<"\n";
 	os<<"ConjugateGradientEps"<<t.cgEps()<<"\n";
@@ -143,6 +143,8 @@ public:
 	BaseType,
 	TargetParamsType> CorrectionVectorSkeletonType;
 	typedef typename BasisType::QnType QnType;
+	typedef typename CorrectionVectorSkeletonType::VectorVectorWithOffsetType
+	VectorVectorWithOffsetType;
 
 	TargetingCorrectionVector(const LeftRightSuperType& lrs,
 	                          const ModelType& model,
@@ -163,7 +165,12 @@ public:
 
 	SizeType sites() const { return tstStruct_.sites(); }
 
-	SizeType targets() const { return 4; }
+	// with CorrectionVectorOmegas, xi and xr for each omega follow phi
+	SizeType targets() const
+	{
+		const SizeType n = tstStruct_.omegas().size();
+		return (n > 0) ? 2 + 2*n : 4;
+	}
 
 	RealType weight(SizeType i) const
 	{
@@ -252,9 +259,18 @@ private:
 		if (count==0) return;
 
 		this->common().aoe().targetVectors(1) = phiNew;
-		skeleton_.calcDynVectors(this->common().aoe().targetVectors(1),
-		                         this->common().aoe().targetVectors(2),
-		                         this->common().aoe().targetVectors(3));
+		if (tstStruct_.omegas().size() > 0) {
+			VectorVectorWithOffsetType tvs;
+			skeleton_.calcDynVectors(this->common().aoe().targetVectors(1),
+			                         tstStruct_.omegas(),
+			                         tvs);
+			for (SizeType x = 0; x < tvs.size(); ++x)
+				this->common().aoe().targetVectors(2 + x) = tvs[x];
+		} else {
+			skeleton_.calcDynVectors(this->common().aoe().targetVectors(1),
+			                         this->common().aoe().targetVectors(2),
+			                         this->common().aoe().targetVectors(3));
+		}
 
 		setWeights();
 
@@ -171,7 +171,7 @@ public:
 		if (!wft.isEnabled())
 			err("TargetingRixsDynamic needs wft\n");
 
-		if (tstStruct_.algorithm() == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) {
+		if (isCorrectionVector()) {
 			return; // early exit here
 		}
 
@@ -198,14 +198,13 @@ public:
 		tstStruct2_ = nullptr;
 	}
 
-	SizeType sites() const { return (tstStruct_.algorithm() ==
-		                             TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) ?
+	SizeType sites() const { return (isCorrectionVector()) ?
 		            tstStruct_.sites() : tstStruct2_->sites(); }
 
 	SizeType targets() const
 	{
 		const AlgorithmEnumType algo = tstStruct_.algorithm();
-		if (algo == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) {
+		if (isCorrectionVector()) {
 			return 10;
 		} else if (algo == TargetParamsType::BaseType::AlgorithmEnum::CHEBYSHEV) {
 			return 12;
@@ -231,7 +230,7 @@ public:
 
 		SizeType tenOrTwelveOrSixteen;
 		const AlgorithmEnumType algo = tstStruct_.algorithm();
-		if (algo == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) {
+		if (isCorrectionVector()) {
 			tenOrTwelveOrSixteen = 10;
 		} else if (algo == TargetParamsType::BaseType::AlgorithmEnum::CHEBYSHEV) {
 			tenOrTwelveOrSixteen = 12;
@@ -273,8 +272,7 @@ public:
 
 		this->common().aoe().wftSome(site, 0, 6);
 
-		const AlgorithmEnumType algo = tstStruct_.algorithm();
-		if (algo == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) {
+		if (isCorrectionVector()) {
 			this->common().aoe().wftSome(site, 6, this->common().aoe().targetVectors().size());
 		} else {
 			// just to set the stage and currenttime: CHEBY and KRYLOVTIME
@@ -477,7 +475,7 @@ private:
 		SizeType nineOrTenOrFifteen = (isChevy) ? 10 : 15;
 		SizeType eightOrEleven = (isChevy) ? 8 : 11;
 
-		if (algo == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) {
+		if (isCorrectionVector()) {
 			nineOrTenOrFifteen = 9;
 			eightOrEleven = 8;
 		}
@@ -532,7 +530,7 @@ private:
 
 		const AlgorithmEnumType algo = tstStruct_.algorithm();
 
-		if (algo == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV) {
+		if (isCorrectionVector()) {
 			skeleton_.calcDynVectors(this->common().aoe().targetVectors(6),
 			                         this->common().aoe().targetVectors(7),
 			                         this->common().aoe().targetVectors(8),
@@ -593,9 +591,7 @@ private:
 	                const VectorWithOffsetType& src,
 	                ProgramGlobals::DirectionEnum direction)
 	{
-		const AlgorithmEnumType algo = tstStruct_.algorithm();
-
-		if (algo != TargetParamsType::BaseType::AlgorithmEnum::KRYLOV)
+		if (!isCorrectionVector())
 			this->common().aoe().applyOneOperator(loopNumber,
 		                                          indexOfOperator,
 		                                          site,
@@ -613,6 +609,15 @@ private:
 		                                          tstStruct_);
 	}
 
+	// Krylov and ConjugateGradient compute correction vectors directly,
+	// the other algorithms through time evolution
+	bool isCorrectionVector() const
+	{
+		const AlgorithmEnumType algo = tstStruct_.algorithm();
+		return (algo == TargetParamsType::BaseType::AlgorithmEnum::KRYLOV ||
+		        algo == TargetParamsType::BaseType::AlgorithmEnum::CONJUGATE_GRADIENT);
+	}
+
 	void setWeights(SizeType n)
 	{
 		gsWeight_ = tstStruct_.gsWeight();
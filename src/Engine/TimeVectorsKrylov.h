@@ -126,6 +126,7 @@ public:
 	typedef typename ParallelTriDiagType::MatrixComplexOrRealType MatrixComplexOrRealType;
 	typedef typename ParallelTriDiagType::TargetVectorType VectorType;
 	typedef typename ParallelTriDiagType::VectorMatrixFieldType VectorMatrixFieldType;
+	typedef typename ParallelTriDiagType::VectorVectorType VectorVectorType;
 	typedef typename LanczosSolverType::TridiagonalMatrixType TridiagonalMatrixType;
 	typedef typename ModelType::InputValidatorType InputValidatorType;
 	typedef typename PsimagLite::Vector<VectorWithOffsetType>::Type VectorVectorWithOffsetType;
@@ -205,12 +206,17 @@ public:
 
 		triDiag(phi,T,V,steps);
 
+		// tridiagonal matrices of sectors whose Lanczos vectors were not stored
+		VectorMatrixFieldType ab(phi.sectors());
+		for (SizeType ii=0;ii<phi.sectors();ii++)
+			if (V[ii].cols() == 0) ab[ii] = T[ii];
+
 		VectorVectorRealType eigs(phi.sectors());
 
 		for (SizeType ii=0;ii<phi.sectors();ii++)
 			PsimagLite::diag(T[ii],eigs[ii],'V');
 
-		calcTargetVectors(indices, phi, T, V, Eg, eigs, steps);
+		calcTargetVectors(indices, phi, T, V, ab, Eg, eigs, steps);
 
 		//checkNorms();
 		if (extra.isLastCall) timeHasAdvanced_ = false;
@@ -233,6 +239,7 @@ private:
 	                       const VectorWithOffsetType& phi,
 	                       const VectorMatrixFieldType& T,
 	                       const VectorMatrixFieldType& V,
+	                       const VectorMatrixFieldType& ab,
 	                       RealType Eg,
 	                       const VectorVectorRealType& eigs,
 	                       typename PsimagLite::Vector<SizeType>::Type steps)
@@ -241,65 +248,126 @@ private:
 			const SizeType ii = indices[i];
 			assert(ii < targetVectors_.size());
 			targetVectors_[ii] = phi;
-			// Only time differences here (i.e. times_[i] not times_[i]+currentTime_)
-			calcTargetVector(targetVectors_[ii], phi, T, V, Eg, eigs, steps, i);
 		}
-	}
 
-	void calcTargetVector(VectorWithOffsetType& v,
-	                      const VectorWithOffsetType& phi,
-	                      const VectorMatrixFieldType& T,
-	                      const VectorMatrixFieldType& V,
-	                      RealType Eg,
-	                      const VectorVectorRealType& eigs,
-	                      typename PsimagLite::Vector<SizeType>::Type steps,
-	                      SizeType timeIndex)
-	{
-		v = phi;
 		for (SizeType ii = 0;ii < phi.sectors(); ++ii) {
-			const RealType time = times_[timeIndex];
-			const RealType timeDirection = tstStruct_.timeDirection();
-			const VectorRealType& eigsii = eigs[ii];
-			auto action = [eigsii, Eg, time, timeDirection](SizeType k)
-			{
-				RealType tmp = (eigsii[k]-Eg)*time*timeDirection;
-				ComplexOrRealType c = 0.0;
-				PsimagLite::expComplexOrReal(c, -tmp);
-				return c;
-			};
-
 			SizeType i0 = phi.sector(ii);
-			VectorType r;
-			calcTargetVector(r, phi, T[ii], V[ii], action, steps[ii], i0);
-			v.setDataInSector(r, i0);
+			// <v_k|phi> does not depend on time, so Lanczos vectors that
+			// were not stored are regenerated once per sector for it
+			VectorType vTimesPhi;
+			if (V[ii].cols() == 0)
+				calcVTimesPhi(vTimesPhi, phi, ab[ii], steps[ii], i0);
+
+			// coefficients in the Lanczos basis, one per time
+			VectorVectorType xs(indices.size() - 1);
+			for (SizeType i = 1; i < indices.size(); ++i) {
+				// Only time differences here (i.e. times_[i] not times_[i]+currentTime_)
+				const RealType time = times_[i];
+				const RealType timeDirection = tstStruct_.timeDirection();
+				const VectorRealType& eigsii = eigs[ii];
+				auto action = [eigsii, Eg, time, timeDirection](SizeType k)
+				{
+					RealType tmp = (eigsii[k]-Eg)*time*timeDirection;
+					ComplexOrRealType c = 0.0;
+					PsimagLite::expComplexOrReal(c, -tmp);
+					return c;
+				};
+
+				calcKrylovCoefficients(xs[i - 1], phi, T[ii], V[ii], vTimesPhi, action, steps[ii], i0);
+			}
+
+			VectorVectorType rs;
+			lanczosVectorsTimes(rs, xs, phi, V[ii], ab[ii], i0);
+			for (SizeType i = 1; i < indices.size(); ++i)
+				targetVectors_[indices[i]].setDataInSector(rs[i - 1], i0);
 		}
 	}
 
 	template<typename SomeLambdaType>
-	void calcTargetVector(VectorType& r,
-	                      const VectorWithOffsetType& phi,
-	                      const MatrixComplexOrRealType& T,
-	                      const MatrixComplexOrRealType& V,
-	                      const SomeLambdaType& action,
-	                      SizeType steps,
-	                      SizeType i0)
+	void calcKrylovCoefficients(VectorType& tmp,
+	                            const VectorWithOffsetType& phi,
+	                            const MatrixComplexOrRealType& T,
+	                            const MatrixComplexOrRealType& V,
+	                            const VectorType& vTimesPhi,
+	                            const SomeLambdaType& action,
+	                            SizeType steps,
+	                            SizeType i0)
 	{
 		SizeType n2 = steps;
-		SizeType n = V.rows();
+		const bool twoPass = (V.cols() == 0);
 		if (T.cols()!=T.rows()) throw PsimagLite::RuntimeError("T is not square\n");
-		if (V.cols()!=T.cols()) throw PsimagLite::RuntimeError("V is not nxn2\n");
+		if (!twoPass && V.cols()!=T.cols())
+			throw PsimagLite::RuntimeError("V is not nxn2\n");
 		// for (SizeType j=0;j<v.size();j++) v[j] = 0; <-- harmful if v is sparse
 		ComplexOrRealType zone = 1.0;
 		ComplexOrRealType zzero = 0.0;
 
 		//check1(phi,i0);
 		//check2(T,V,phi,n2,i0);
-		VectorType tmp(n2);
-		r.resize(n2);
-		krylovHelper_.calcR(r, action, T, V, phi, steps, i0);
+		tmp.resize(n2);
+		VectorType r(n2);
+		if (twoPass) {
+			assert(vTimesPhi.size() == krylovHelper_.vTimesPhiSize(n2));
+			krylovHelper_.calcR(r, action, T, vTimesPhi, n2);
+		} else {
+			krylovHelper_.calcR(r, action, T, V, phi, steps, i0);
+		}
+
 		psimag::BLAS::GEMV('N',n2,n2,zone,&(T(0,0)),n2,&(r[0]),1,zzero,&(tmp[0]),1);
-		r.resize(n);
-		psimag::BLAS::GEMV('N',n,n2,zone,&(V(0,0)),n,&(tmp[0]),1,zzero,&(r[0]),1);
+	}
+
+	// <v_k|phi> for the Lanczos vectors v_k that were not stored
+	void calcVTimesPhi(VectorType& vTimesPhi,
+	                   const VectorWithOffsetType& phi,
+	                   const MatrixComplexOrRealType& ab,
+	                   SizeType steps,
+	                   SizeType i0)
+	{
+		vTimesPhi.resize(krylovHelper_.vTimesPhiSize(steps));
+		VectorVectorType none;
+		VectorVectorType noneOut;
+		ParallelTriDiagType::lanczosVectorsTimes(noneOut,
+		                                         none,
+		                                         vTimesPhi,
+		                                         ab,
+		                                         phi,
+		                                         i0,
+		                                         lrs_,
+		                                         time(),
+		                                         model_);
+	}
+
+	// rs[x] = V*xs[x], regenerating V if it was not stored
+	void lanczosVectorsTimes(VectorVectorType& rs,
+	                         const VectorVectorType& xs,
+	                         const VectorWithOffsetType& phi,
+	                         const MatrixComplexOrRealType& V,
+	                         const MatrixComplexOrRealType& ab,
+	                         SizeType i0)
+	{
+		if (V.cols() == 0) {
+			VectorType noVtimesPhi;
+			ParallelTriDiagType::lanczosVectorsTimes(rs,
+			                                         xs,
+			                                         noVtimesPhi,
+			                                         ab,
+			                                         phi,
+			                                         i0,
+			                                         lrs_,
+			                                         time(),
+			                                         model_);
+			return;
+		}
+
+		ComplexOrRealType zone = 1.0;
+		ComplexOrRealType zzero = 0.0;
+		SizeType n = V.rows();
+		rs.resize(xs.size());
+		for (SizeType x = 0; x < xs.size(); ++x) {
+			SizeType n2 = xs[x].size();
+			rs[x].resize(n);
+			psimag::BLAS::GEMV('N',n,n2,zone,&(V(0,0)),n,&(xs[x][0]),1,zzero,&(rs[x][0]),1);
+		}
 	}
 
 	void triDiag(const VectorWithOffsetType& phi,
@@ -307,12 +375,9 @@ private:
 	             VectorMatrixFieldType& V,
 	             typename PsimagLite::Vector<SizeType>::Type& steps)
 	{
-		typedef PsimagLite::NoPthreadsNg<ParallelTriDiagType> ParallelizerType;
-		ParallelizerType threadedTriDiag(PsimagLite::CodeSectionParams(1));
-
 		ParallelTriDiagType helperTriDiag(phi,T,V,steps,lrs_,time(),model_,ioIn_);
 
-		threadedTriDiag.loopCreate(helperTriDiag);
+		helperTriDiag.loopCreate();
 	}
 
 	const SizeType& currentTimeStep_;
@@ -121,6 +121,10 @@ class TimeVectorsSuzukiTrotter : public  TimeVectorsBase<
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename PsimagLite::Vector<VectorWithOffsetType>::Type
 	VectorVectorWithOffsetType;
+	typedef typename WaveFunctionTransfType::VectorVectorWithOffsetPtrType
+	VectorVectorWithOffsetPtrType;
+	typedef typename WaveFunctionTransfType::VectorConstVectorWithOffsetPtrType
+	VectorConstVectorWithOffsetPtrType;
 	typedef typename ModelType::HilbertBasisType HilbertBasisType;
 	typedef typename ModelType::HilbertBasisType::value_type HilbertStateType;
 
@@ -279,24 +283,29 @@ private:
 		return true;
 	}
 
+	// all time vectors in one call to the WFT, so that it may do them together
 	void wftAll(const VectorSizeType& block)
 	{
-		for (SizeType i=1;i<times_.size();i++)
-			wftOne(i,block);
-	}
+		if (times_.size() < 2) return;
 
-	void wftOne(SizeType i,const VectorSizeType& block)
-	{
-		VectorWithOffsetType phiNew = targetVectors_[0];
+		VectorVectorWithOffsetType phiNew(times_.size() - 1, targetVectors_[0]);
+		VectorVectorWithOffsetPtrType dest(phiNew.size());
+		VectorConstVectorWithOffsetPtrType src(phiNew.size());
+		for (SizeType i = 1; i < times_.size(); ++i) {
+			dest[i - 1] = &phiNew[i - 1];
+			src[i - 1] = &targetVectors_[i];
+		}
 
 		// OK, now that we got the partition number right, let's wft:
 		VectorSizeType nk;
 		setNk(nk,block);
 		// generalize for su(2)
-		wft_.setInitialVector(phiNew,targetVectors_[i],lrs_,nk);
-		phiNew.collapseSectors();
-		assert(norm(phiNew)>1e-6);
-		targetVectors_[i]=phiNew;
+		wft_.setInitialVectors(dest,src,lrs_,nk);
+		for (SizeType i = 1; i < times_.size(); ++i) {
+			phiNew[i - 1].collapseSectors();
+			assert(norm(phiNew[i - 1])>1e-6);
+			targetVectors_[i] = phiNew[i - 1];
+		}
 	}
 
 	void calcTargetVector(VectorWithOffsetType& target,
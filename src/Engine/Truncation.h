@@ -249,6 +249,10 @@ private:
 		bool enablePersistentSvd = (parameters_.options.find("EnablePersistentSvd") !=
 		        PsimagLite::String::npos);
 		ParamsDensityMatrixType p(useSvd, direction, debug, enablePersistentSvd);
+		p.partialSvd = (parameters_.options.find("truncationPartialSvd") !=
+		        PsimagLite::String::npos);
+		p.keptStates = keptStates;
+		p.tolerance = parameters_.truncationControl.first;
 		TruncationCache& cache = (direction == expandSys) ? leftCache_ :
 		                                                    rightCache_;
 
@@ -271,7 +275,7 @@ private:
 
 		dmS->diag(cache.eigs,'V');
 
-		updateKeptStates(keptStates, cache.eigs);
+		updateKeptStates(keptStates, cache.eigs, dmS->uncomputedWeight());
 
 		cache.transform = dmS->operator()();
 		if (parameters_.options.find("nodmrgtransform") != PsimagLite::String::npos) {
@@ -345,8 +349,11 @@ private:
 		lrs = 0;
 	}
 
+	// uncomputed is the weight of states whose eigenvalues were not
+	// computed; they are always discarded
 	void updateKeptStates(SizeType& keptStates,
-	                      const VectorRealType& eigs2)
+	                      const VectorRealType& eigs2,
+	                      RealType uncomputed)
 	{
 		VectorRealType eigs = eigs2;
 		typename PsimagLite::Vector<SizeType>::Type perm(eigs.size());
@@ -354,11 +361,11 @@ private:
 		sort.sort(eigs,perm);
 		dumpEigs(eigs);
 
-		SizeType newKeptStates = computeKeptStates(keptStates,eigs);
+		SizeType newKeptStates = computeKeptStates(keptStates,eigs,uncomputed);
 		SizeType statesToRemove = 0;
 		if (eigs.size()>=newKeptStates)
 			statesToRemove = eigs.size()-newKeptStates;
-		RealType discWeight = sumUpTo(eigs,statesToRemove);
+		RealType discWeight = sumUpTo(eigs,statesToRemove) + uncomputed;
 		PsimagLite::OstringStream msg;
 		if (newKeptStates != keptStates) {
 			// we report that the "m" value has been changed and...
@@ -438,7 +445,8 @@ private:
 		!PTEX-END */
 	//! eigenvalues are ordered in increasing order
 	SizeType computeKeptStates(SizeType& keptStates,
-	                           const VectorRealType& eigs) const
+	                           const VectorRealType& eigs,
+	                           RealType uncomputed) const
 	{
 		if (parameters_.truncationControl.first < 0) return keptStates;
 		int start = eigs.size() - keptStates;
@@ -446,7 +454,7 @@ private:
 		int maxToRemove = eigs.size()-parameters_.keptStatesInfinite;
 		if (maxToRemove<0) maxToRemove = 0;
 		SizeType total = parameters_.keptStatesInfinite;
-		RealType discWeight=sumUpTo(eigs,start);
+		RealType discWeight=sumUpTo(eigs,start) + uncomputed;
 		// maybe we should use int instead of SizeType here!!!
 
 		for (int i=start;i<maxToRemove;i++) {
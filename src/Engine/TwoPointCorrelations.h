@@ -109,7 +109,8 @@ public:
 	typedef Parallel2PointCorrelations<ThisType> Parallel2PointCorrelationsType;
 	typedef typename Parallel2PointCorrelationsType::PairType PairType;
 
-	TwoPointCorrelations(const CorrelationsSkeletonType& skeleton) : skeleton_(skeleton)
+	TwoPointCorrelations(const CorrelationsSkeletonType& skeleton, bool incremental = false)
+	    : skeleton_(skeleton), incremental_(incremental)
 	{}
 
 	void operator()(PsimagLite::Matrix<FieldType>& w,
@@ -123,7 +124,16 @@ public:
 		SizeType cols = w.n_col();
 
 		typename PsimagLite::Vector<PairType>::Type pairs;
+		typename PsimagLite::Vector<SizeType>::Type weights;
 		for (SizeType i=0;i<rows;i++) {
+			if (incremental_) {
+				// one task per row: (i, cols) means all j with i <= j < cols
+				if (i >= cols) continue;
+				pairs.push_back(PairType(i, cols));
+				weights.push_back(cols - i);
+				continue;
+			}
+
 			for (SizeType j=i;j<cols;j++) {
 				if (i>j) continue;
 				pairs.push_back(PairType(i,j));
@@ -140,9 +150,13 @@ public:
 		                                             O2,
 		                                             fermionicSign,
 		                                             bra,
-		                                             ket);
+		                                             ket,
+		                                             incremental_);
 
-		threaded2Points.loopCreate(helper2Points);
+		if (incremental_)
+			threaded2Points.loopCreate(helper2Points, weights);
+		else
+			threaded2Points.loopCreate(helper2Points);
 	}
 
 	// Return the vector: O1 * O2 |psi>
@@ -169,6 +183,42 @@ public:
 		return c;
 	}
 
+	// Fills w(i, j) for all i <= j < cols
+	// O1 is grown from site i only once, and each intermediate growth
+	// is reused for the next j, instead of growing it again for each pair.
+	void calcCorrelationRow(MatrixType& w,
+	                        SizeType i,
+	                        SizeType cols,
+	                        const SparseMatrixType& O1,
+	                        const SparseMatrixType& O2,
+	                        ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	                        PsimagLite::String bra,
+	                        PsimagLite::String ket) const
+	{
+		if (i >= cols) return;
+
+		w(i, i) = calcDiagonalCorrelation(i, O1, O2, fermionicSign, bra, ket);
+
+		SparseMatrixType O1m,O2m;
+		skeleton_.createWithModification(O1m,O1,'n');
+		skeleton_.createWithModification(O2m,O2,'n');
+
+		SparseMatrixType O1g = O1m;
+		SizeType grownTo = 0;
+		const SizeType lastSite = skeleton_.numberOfSites() - 1;
+		for (SizeType j = i + 1; j < cols; ++j) {
+			const bool isRightCorner = (j == lastSite && i == j - 1);
+			if (!isRightCorner) {
+				const SizeType ns = (j == lastSite) ? j - 2 : j - 1;
+				assert(ns >= grownTo);
+				skeleton_.growDirectlyFrom(O1g, i, fermionicSign, grownTo, ns);
+				grownTo = ns;
+			}
+
+			w(i, j) = bracketGrown_(i, j, O1g, O1m, O2m, fermionicSign, bra, ket);
+		}
+	}
+
 private:
 
 	FieldType calcDiagonalCorrelation(SizeType i,
@@ -211,11 +261,34 @@ private:
 		if (i >= j)
 			err("Observer::calcCorrelation_(...): i must be smaller than j\n");
 
-		const ObserverHelperType& helper = skeleton_.helper();
 		SparseMatrixType O1m,O2m;
 		skeleton_.createWithModification(O1m,O1,'n');
 		skeleton_.createWithModification(O2m,O2,'n');
 
+		SparseMatrixType O1g;
+		if (j == skeleton_.numberOfSites() - 1) {
+			if (i != j - 1)
+				skeleton_.growDirectly(O1g,O1m,i,fermionicSign,j-2,true);
+		} else {
+			skeleton_.growDirectly(O1g,O1m,i,fermionicSign,j-1,true);
+		}
+
+		return bracketGrown_(i, j, O1g, O1m, O2m, fermionicSign, bra, ket);
+	}
+
+	// O1g is O1m grown from site i to j - 2 if j is the last site, or to j - 1 otherwise
+	// O1g is not used if i == j - 1 and j is the last site
+	FieldType bracketGrown_(SizeType i,
+	                        SizeType j,
+	                        const SparseMatrixType& O1g,
+	                        const SparseMatrixType& O1m,
+	                        const SparseMatrixType& O2m,
+	                        ProgramGlobals::FermionOrBosonEnum fermionicSign,
+	                        PsimagLite::String bra,
+	                        PsimagLite::String ket) const
+	{
+		const ObserverHelperType& helper = skeleton_.helper();
+
 		if (j == skeleton_.numberOfSites() - 1) {
 			if (i == j - 1) {
 				const SizeType ptr = j - 2;
@@ -234,16 +307,13 @@ private:
 				                                    ket);
 			}
 
-			SparseMatrixType O1g;
-			skeleton_.growDirectly(O1g,O1m,i,fermionicSign,j-2,true);
 			// j - 2 below is the pointer
 			return skeleton_.bracketRightCorner(O1g, O2m, fermionicSign, j - 2, bra, ket);
 		}
 
-		SparseMatrixType O1g,O2g;
+		SparseMatrixType O2g;
 		SizeType ns = j-1;
 
-		skeleton_.growDirectly(O1g,O1m,i,fermionicSign,ns,true);
 		const SizeType ptr = skeleton_.dmrgMultiply(O2g,O1g,O2m,fermionicSign,ns);
 
 		return skeleton_.bracket(O2g,
@@ -261,6 +331,7 @@ private:
 	}
 
 	const CorrelationsSkeletonType& skeleton_;
+	bool incremental_;
 };  //class TwoPointCorrelations
 } // namespace Dmrg
 
@@ -28,27 +28,41 @@ class BlockDiagWf {
 	typedef PsimagLite::PackIndices PackIndicesType;
 	typedef typename PsimagLite::Vector<MatrixType*>::Type VectorMatrixType;
 
+public:
+
+	typedef typename PsimagLite::Vector<const VectorWithOffsetType*>::Type
+	VectorConstVectorWithOffsetPtrType;
+
+private:
+
 	class ParallelBlockCtor {
 
 	public:
 
+		// the vectors in srcs go one after the other, as columns
 		ParallelBlockCtor(const VectorSizeType& patcheLeft,
 		                  const VectorSizeType& patchesRight,
 		                  const LeftRightSuperType& lrs,
-		                  const VectorWithOffsetType& src,
-		                  SizeType iSrc,
+		                  const VectorConstVectorWithOffsetPtrType& srcs,
+		                  const VectorSizeType& iSrcs,
 		                  VectorPairType& patches,
 		                  VectorMatrixType& data)
 		    : patchesLeft_(patcheLeft),
 		      patchesRight_(patchesRight),
 		      lrs_(lrs),
 		      packSuper_(lrs.left().size()),
-		      src_(src),
-		      srcIndex_(src.sector(iSrc)),
-		      offset_(src.offset(srcIndex_)),
+		      srcs_(srcs),
+		      srcIndex_(srcs.size()),
+		      offset_(srcs.size()),
 		      patches_(patches),
 		      data_(data)
-		{}
+		{
+			assert(srcs.size() == iSrcs.size());
+			for (SizeType v = 0; v < srcs.size(); ++v) {
+				srcIndex_[v] = srcs[v]->sector(iSrcs[v]);
+				offset_[v] = srcs[v]->offset(srcIndex_[v]);
+			}
+		}
 
 		SizeType tasks() const { return patchesLeft_.size(); }
 
@@ -61,7 +75,8 @@ class BlockDiagWf {
 			SizeType offsetR = lrs_.right().partition(partR);
 			patches_[ipatch] = PairType(partL, partR);
 			SizeType ctotal = lrs_.right().partition(partR + 1) - offsetR;
-			data_[ipatch] = new MatrixType(rtotal, ctotal);
+			const SizeType nvectors = srcs_.size();
+			data_[ipatch] = new MatrixType(rtotal, ctotal*nvectors);
 			MatrixType& m = *(data_[ipatch]);
 			for (SizeType r = 0; r < rtotal; ++r) {
 				SizeType row = r + offsetL;
@@ -70,8 +85,11 @@ class BlockDiagWf {
 					SizeType ind = packSuper_.pack(row,
 					                               col,
 					                               lrs_.super().permutationInverse());
-					assert(ind >= offset_);
-					m(r, c) = src_.fastAccess(srcIndex_, ind - offset_);
+					for (SizeType v = 0; v < nvectors; ++v) {
+						assert(ind >= offset_[v]);
+						m(r, c + v*ctotal) = srcs_[v]->fastAccess(srcIndex_[v],
+						                                          ind - offset_[v]);
+					}
 					//sum += PsimagLite::conj(m(r, c))*m(r, c);
 				}
 			}
@@ -83,9 +101,9 @@ class BlockDiagWf {
 		const VectorSizeType& patchesRight_;
 		const LeftRightSuperType& lrs_;
 		const PackIndicesType packSuper_;
-		const VectorWithOffsetType& src_;
-		SizeType srcIndex_;
-		SizeType offset_;
+		const VectorConstVectorWithOffsetPtrType& srcs_;
+		VectorSizeType srcIndex_;
+		VectorSizeType offset_;
 		VectorPairType& patches_;
 		VectorMatrixType& data_;
 	};
@@ -99,6 +117,7 @@ class BlockDiagWf {
 		                       char charLeft,
 		                       char charRight,
 		                       SizeType threads,
+		                       SizeType nvectors,
 		                       const VectorPairType& patches,
 		                       VectorSizeType& offsetRows,
 		                       VectorSizeType& offsetCols,
@@ -110,6 +129,7 @@ class BlockDiagWf {
 		      charLeft_(charLeft),
 		      charRight_(charRight),
 		      storage_(threads),
+		      nvectors_(nvectors),
 		      patches_(patches),
 		      offsetRows_(offsetRows),
 		      offsetCols_(offsetCols),
@@ -209,8 +229,10 @@ class BlockDiagWf {
 			};
 
 
+			// ncol_Yold is per vector; Yold has nvectors_ of them side by side
+			const int nvectors = nvectors_;
 			const int nrow_Yold = m.rows();
-			const int ncol_Yold = m.cols();
+			const int ncol_Yold = m.cols()/nvectors;
 			ComplexOrRealType *Yold = &(m(0,0));
 			const int ldYold = nrow_Yold;
 
@@ -279,18 +301,19 @@ class BlockDiagWf {
 				// ---------------------------
 				nrow_Ytemp = (charLeft_ == 'N') ? nrow_W_L : ncol_W_L;
 				ncol_Ytemp = ncol_Yold;
-				MatrixType tmp(nrow_Ytemp,ncol_Ytemp);
+				MatrixType tmp(nrow_Ytemp,ncol_Ytemp*nvectors);
 				ComplexOrRealType *Ytemp = &(tmp(0,0));
 				ldYtemp = nrow_Ytemp;
 
 				// ---------------------------
 				// (1) Ytemp = opL(W_L) * Yold
+				// for all vectors at once
 				// ---------------------------
 				{
 					const char transA = charLeft_;
 					const char transB = 'N';
 					const int mm = nrow_Ytemp;
-					const int nn = ncol_Ytemp;
+					const int nn = ncol_Ytemp*nvectors;
 					const int kk = nrow_Yold;
 					const ComplexOrRealType alpha = d_one;
 					const ComplexOrRealType beta = d_zero;
@@ -305,14 +328,15 @@ class BlockDiagWf {
 				// Note Ynew is over-written Yold
 				// ------------------------------
 				m.clear();
-				m.resize( nrow_Ynew, ncol_Ynew);
+				m.resize( nrow_Ynew, ncol_Ynew*nvectors);
 				ComplexOrRealType  *Ynew = &(m(0,0));
 
 
 				// ---------------------------
 				// (2) Ynew = Ytemp * opR(W_R)
+				// for each vector
 				// ---------------------------
-				{
+				for (int v = 0; v < nvectors; ++v) {
 					const char transA = 'N';
 					const char transB = charRight_;
 					const int mm = nrow_Ynew;
@@ -323,8 +347,9 @@ class BlockDiagWf {
 
 					psimag::BLAS::GEMM( transA, transB,
 					                    mm, nn, kk,
-					                    alpha, Ytemp, ldYtemp, W_R, ldW_R,
-					                    beta, Ynew, ldYnew );
+					                    alpha, Ytemp + v*ldYtemp*ncol_Ytemp, ldYtemp,
+					                    W_R, ldW_R,
+					                    beta, Ynew + v*ldYnew*ncol_Ynew, ldYnew );
 				}
 			}
 			else {
@@ -336,14 +361,15 @@ class BlockDiagWf {
 
 				nrow_Ytemp = nrow_Yold;
 				ncol_Ytemp = (charRight_ == 'N') ? ncol_W_R : nrow_W_R;
-				MatrixType tmp(nrow_Ytemp,ncol_Ytemp);
+				MatrixType tmp(nrow_Ytemp,ncol_Ytemp*nvectors);
 				ComplexOrRealType *Ytemp = &(tmp(0,0));
 				ldYtemp = nrow_Ytemp;
 
 				// ------------------------------
 				// (1) Ytemp = Yold * opR( W_R )
+				// for each vector
 				// ------------------------------
-				{
+				for (int v = 0; v < nvectors; ++v) {
 					const char transA = 'N';
 					const char transB = charRight_;
 					const int mm = nrow_Ytemp;
@@ -354,8 +380,9 @@ class BlockDiagWf {
 
 					psimag::BLAS::GEMM( transA, transB,
 					                    mm, nn, kk,
-					                    alpha, Yold, ldYold, W_R, ldW_R,
-					                    beta,  Ytemp, ldYtemp );
+					                    alpha, Yold + v*ldYold*ncol_Yold, ldYold,
+					                    W_R, ldW_R,
+					                    beta,  Ytemp + v*ldYtemp*ncol_Ytemp, ldYtemp );
 
 				}
 
@@ -363,17 +390,18 @@ class BlockDiagWf {
 				// Note Ynew over-written by Yold
 				// ------------------------------
 				m.clear();
-				m.resize( nrow_Ynew, ncol_Ynew );
+				m.resize( nrow_Ynew, ncol_Ynew*nvectors );
 				ComplexOrRealType *Ynew = &(m(0,0));
 
 				// ---------------------------
 				// (2) Ynew = opL(W_L) * Ytemp
+				// for all vectors at once
 				// ---------------------------
 				{
 					const char transA = charLeft_;
 					const char transB = 'N';
 					const int mm = nrow_Ynew;
-					const int nn = ncol_Ynew;
+					const int nn = ncol_Ynew*nvectors;
 					const int kk = nrow_Ytemp;
 					const ComplexOrRealType alpha = d_one;
 					const ComplexOrRealType beta = d_zero;
@@ -443,6 +471,7 @@ class BlockDiagWf {
 		char charLeft_;
 		char charRight_;
 		typename PsimagLite::Vector<MatrixType>::Type storage_;
+		SizeType nvectors_;
 		const VectorPairType& patches_;
 		VectorSizeType& offsetRows_;
 		VectorSizeType& offsetCols_;
@@ -456,25 +485,25 @@ public:
 	            const LeftRightSuperType& lrs)
 	    : lrs_(lrs),
 	      rows_(lrs.left().size()),
-	      cols_(lrs.right().size())
+	      cols_(lrs.right().size()),
+	      nvectors_(1)
 	{
-		GenIjPatchType genIjPatch(lrs, src.qn(iSrc));
-		const VectorSizeType& patchesLeft = genIjPatch(GenIjPatchType::LEFT);
-		const VectorSizeType& patchesRight = genIjPatch(GenIjPatchType::RIGHT);
-		SizeType npatches = patchesLeft.size();
-		assert(npatches == patchesRight.size());
-
-		data_.resize(npatches, 0);
-		patches_.resize(npatches);
-
-		SizeType threads = std::min(npatches, PsimagLite::Concurrency::codeSectionParams.npthreads);
-		typedef PsimagLite::Parallelizer<ParallelBlockCtor> ParallelizerType;
-		PsimagLite::CodeSectionParams codeSectionParams(threads);
-		ParallelizerType threadedCtor(codeSectionParams);
-
-		ParallelBlockCtor helper(patchesLeft, patchesRight, lrs, src, iSrc, patches_, data_);
+		VectorConstVectorWithOffsetPtrType srcs(1, &src);
+		VectorSizeType iSrcs(1, iSrc);
+		init(srcs, iSrcs);
+	}
 
-		threadedCtor.loopCreate(helper);
+	// Sector iSrcs[v] of *srcs[v] for each v, all with the same quantum
+	// numbers; each transform() then does them all with the same GEMMs
+	BlockDiagWf(const VectorConstVectorWithOffsetPtrType& srcs,
+	            const VectorSizeType& iSrcs,
+	            const LeftRightSuperType& lrs)
+	    : lrs_(lrs),
+	      rows_(lrs.left().size()),
+	      cols_(lrs.right().size()),
+	      nvectors_(srcs.size())
+	{
+		init(srcs, iSrcs);
 	}
 
 	~BlockDiagWf()
@@ -502,6 +531,7 @@ public:
 		                              charLeft,
 		                              charRight,
 		                              threads,
+		                              nvectors_,
 		                              patches_,
 		                              offsetRows_,
 		                              offsetCols_,
@@ -514,17 +544,20 @@ public:
 		//std::cout<<"sum transform "<<sum<<" rowsum="<<rowsum<<" colsum="<<colsum<<"\n";
 	}
 
+	// which is the vector, in the order of srcs, for the batched ctor
 	void toVectorWithOffsets(VectorWithOffsetType& dest,
 	                         SizeType iNew,
 	                         const LeftRightSuperType& lrs,
 	                         const VectorSizeType& nk,
-	                         typename ProgramGlobals::DirectionEnum dir) const
+	                         typename ProgramGlobals::DirectionEnum dir,
+	                         SizeType which = 0) const
 	{
+		assert(which < nvectors_);
 		SizeType destIndex = dest.sector(iNew);
 		if (dir == ProgramGlobals::DirectionEnum::EXPAND_SYSTEM)
-			return toVectorExpandSys(dest, destIndex, lrs, nk);
+			return toVectorExpandSys(dest, destIndex, lrs, nk, which);
 
-		toVectorExpandEnviron(dest, destIndex, lrs, nk);
+		toVectorExpandEnviron(dest, destIndex, lrs, nk, which);
 	}
 
 	SizeType rows() const
@@ -539,10 +572,33 @@ public:
 
 private:
 
+	void init(const VectorConstVectorWithOffsetPtrType& srcs, const VectorSizeType& iSrcs)
+	{
+		assert(srcs.size() > 0 && srcs.size() == iSrcs.size());
+		GenIjPatchType genIjPatch(lrs_, srcs[0]->qn(iSrcs[0]));
+		const VectorSizeType& patchesLeft = genIjPatch(GenIjPatchType::LEFT);
+		const VectorSizeType& patchesRight = genIjPatch(GenIjPatchType::RIGHT);
+		SizeType npatches = patchesLeft.size();
+		assert(npatches == patchesRight.size());
+
+		data_.resize(npatches, 0);
+		patches_.resize(npatches);
+
+		SizeType threads = std::min(npatches, PsimagLite::Concurrency::codeSectionParams.npthreads);
+		typedef PsimagLite::Parallelizer<ParallelBlockCtor> ParallelizerType;
+		PsimagLite::CodeSectionParams codeSectionParams(threads);
+		ParallelizerType threadedCtor(codeSectionParams);
+
+		ParallelBlockCtor helper(patchesLeft, patchesRight, lrs_, srcs, iSrcs, patches_, data_);
+
+		threadedCtor.loopCreate(helper);
+	}
+
 	void toVectorExpandSys(VectorWithOffsetType& dest,
 	                       SizeType destIndex,
 	                       const LeftRightSuperType& lrs,
-	                       const VectorSizeType& nk) const
+	                       const VectorSizeType& nk,
+	                       SizeType which) const
 	{
 		assert(nk.size() > 0);
 		SizeType hilbert = nk[0];
@@ -563,10 +619,11 @@ private:
 			const MatrixType& m = *mptr;
 			SizeType offsetL = offsetRows_[ipatch];
 			SizeType offsetR = offsetCols_[ipatch];
+			SizeType cols = m.cols()/nvectors_;
 
 			for (SizeType r = 0; r < m.rows(); ++r) {
 				SizeType row = r + offsetL;
-				for (SizeType c = 0; c < m.cols(); ++c) {
+				for (SizeType c = 0; c < cols; ++c) {
 					SizeType col = c + offsetR;
 					SizeType k = 0;
 					SizeType rind = 0;
@@ -577,7 +634,7 @@ private:
 					SizeType ind = packSuper.pack(lind,
 					                              rind,
 					                              lrs.super().permutationInverse());
-					const ComplexOrRealType& value = m(r, c);
+					const ComplexOrRealType& value = m(r, c + which*cols);
 					//sum += PsimagLite::conj(value)*value;
 					//if (ind < offset || ind >= lrs.super().partition(destIndex + 1))
 					//	sumBad += PsimagLite::conj(value)*value;
@@ -593,7 +650,8 @@ private:
 	void toVectorExpandEnviron(VectorWithOffsetType& dest,
 	                           SizeType destIndex,
 	                           const LeftRightSuperType& lrs,
-	                           const VectorSizeType& nk) const
+	                           const VectorSizeType& nk,
+	                           SizeType which) const
 	{
 		assert(nk.size() > 0);
 		SizeType hilbert = nk[0];
@@ -614,10 +672,11 @@ private:
 			const MatrixType& m = *mptr;
 			SizeType offsetL = offsetRows_[ipatch];
 			SizeType offsetR = offsetCols_[ipatch];
+			SizeType cols = m.cols()/nvectors_;
 
 			for (SizeType r = 0; r < m.rows(); ++r) {
 				SizeType row = r + offsetL;
-				for (SizeType c = 0; c < m.cols(); ++c) {
+				for (SizeType c = 0; c < cols; ++c) {
 					SizeType col = c + offsetR;
 					SizeType k = 0;
 					SizeType lind = 0;
@@ -628,7 +687,7 @@ private:
 					SizeType ind = packSuper.pack(lind,
 					                              rind,
 					                              lrs.super().permutationInverse());
-					const ComplexOrRealType& value = m(r, c);
+					const ComplexOrRealType& value = m(r, c + which*cols);
 					//sum += PsimagLite::conj(value)*value;
 					//if (ind < offset || ind >= lrs.super().partition(destIndex + 1))
 					//	sumBad += PsimagLite::conj(value)*value;
@@ -644,6 +703,7 @@ private:
 	const LeftRightSuperType& lrs_;
 	SizeType rows_;
 	SizeType cols_;
+	SizeType nvectors_;
 	VectorSizeType offsetRows_;
 	VectorSizeType offsetCols_;
 	VectorPairType patches_;
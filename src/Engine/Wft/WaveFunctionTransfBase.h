@@ -98,12 +98,28 @@ public:
 	typedef typename BasisWithOperatorsType::BasisType BasisType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef WftOptions<VectorWithOffsetType_>WftOptionsType;
+	typedef typename PsimagLite::Vector<VectorWithOffsetType*>::Type
+	VectorVectorWithOffsetPtrType;
+	typedef typename PsimagLite::Vector<const VectorWithOffsetType*>::Type
+	VectorConstVectorWithOffsetPtrType;
 
 	virtual void transformVector(VectorWithOffsetType& psiDest,
 	                             const VectorWithOffsetType& psiSrc,
 	                             const LeftRightSuperType& lrs,
 	                             const VectorSizeType& nk) const = 0;
 
+	// *psiSrc[i] into *psiDest[i] for each i; implementations may do
+	// them together
+	virtual void transformVectors(const VectorVectorWithOffsetPtrType& psiDest,
+	                              const VectorConstVectorWithOffsetPtrType& psiSrc,
+	                              const LeftRightSuperType& lrs,
+	                              const VectorSizeType& nk) const
+	{
+		assert(psiDest.size() == psiSrc.size());
+		for (SizeType i = 0; i < psiDest.size(); ++i)
+			transformVector(*psiDest[i], *psiSrc[i], lrs, nk);
+	}
+
 	virtual ~WaveFunctionTransfBase() {}
 
 protected:
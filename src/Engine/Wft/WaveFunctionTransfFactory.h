@@ -87,6 +87,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "WaveFunctionTransfSu2.h"
 #include "WaveStructCombined.h"
 #include "Io/IoSelector.h"
+#include "BlockRecords.h"
 #include "Random48.h"
 
 namespace Dmrg {
@@ -106,6 +107,7 @@ public:
 	typedef typename SparseMatrixType::value_type SparseElementType;
 	typedef typename PsimagLite::Vector<SparseElementType>::Type VectorType;
 	typedef typename BasisWithOperatorsType::RealType RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef typename BasisType::FactorsType FactorsType;
 	typedef WaveStructCombined<LeftRightSuperType> WaveStructCombinedType;
 	typedef typename WaveStructCombinedType::VectorVectorRealType VectorVectorRealType;
@@ -119,7 +121,14 @@ public:
 	typedef WaveFunctionTransfSu2<WaveStructCombinedType,VectorWithOffsetType>
 	WaveFunctionTransfSu2Type;
 	typedef typename WaveFunctionTransfBaseType::WftOptionsType WftOptionsType;
+	typedef typename WaveFunctionTransfBaseType::VectorVectorWithOffsetPtrType
+	VectorVectorWithOffsetPtrType;
+	typedef typename WaveFunctionTransfBaseType::VectorConstVectorWithOffsetPtrType
+	VectorConstVectorWithOffsetPtrType;
 	typedef typename WaveStructCombinedType::WaveStructSvdType WaveStructSvdType;
+	typedef typename WaveStructSvdType::SparseElementType SparseElementType;
+	typedef BlockRecordsOut<SparseElementType> BlockRecordsOutType;
+	typedef BlockRecordsIn<SparseElementType> BlockRecordsInType;
 
 	template<typename SomeParametersType>
 	WaveFunctionTransfFactory(SomeParametersType& params)
@@ -135,7 +144,11 @@ public:
 	      wftImpl_(0),
 	      rng_(3433117),
 	      noLoad_(false),
-	      save_(params.options.find("noSaveWft") == PsimagLite::String::npos)
+	      save_(params.options.find("noSaveWft") == PsimagLite::String::npos),
+	      transformsInFloat_(params.options.find("transformsInFloat") !=
+	        PsimagLite::String::npos),
+	      transformsBinary_(transformsInFloat_ ||
+	                        params.options.find("transformsBinary") != PsimagLite::String::npos)
 	{
 		if (!isEnabled_) return;
 
@@ -210,24 +223,7 @@ public:
 	                      const LeftRightSuperType& lrs,
 	                      const VectorSizeType& nk) const
 	{
-		bool allow=false;
-		switch (wftOptions_.dir) {
-		case ProgramGlobals::DirectionEnum::INFINITE:
-			allow=false;
-			break;
-		case ProgramGlobals::DirectionEnum::EXPAND_SYSTEM:
-			allow=true;
-
-		case ProgramGlobals::DirectionEnum::EXPAND_ENVIRON:
-			allow=true;
-		}
-
-		// FIXME: Must check the below change when using SU(2)!!
-		//if (m<0) allow = false; // isEnabled_=false;
-
-		if (noLoad_) allow = false;
-
-		if (isEnabled_ && allow) {
+		if (isAllowed()) {
 #ifndef NDEBUG
 			RealType eps = 1e-12;
 			RealType x = norm(src);
@@ -241,6 +237,43 @@ public:
 		}
 	}
 
+	// As setInitialVector for each *src[i] and *dest[i], but the WFT may
+	// transform vectors with sectors of the same quantum numbers together
+	void setInitialVectors(const VectorVectorWithOffsetPtrType& dest,
+	                       const VectorConstVectorWithOffsetPtrType& src,
+	                       const LeftRightSuperType& lrs,
+	                       const VectorSizeType& nk) const
+	{
+		assert(dest.size() == src.size());
+		if (!isAllowed()) {
+			for (SizeType i = 0; i < dest.size(); ++i)
+				createRandomVector(*dest[i]);
+			return;
+		}
+
+		VectorRealType norm1(src.size());
+		for (SizeType i = 0; i < src.size(); ++i) {
+			norm1[i] = norm(*src[i]);
+			if (norm1[i] < 1e-5)
+				std::cerr<<"WFT Factory: norm1 = " << norm1[i] << " < 1e-5\n";
+		}
+
+		wftImpl_->transformVectors(dest, src, lrs, nk);
+
+		PsimagLite::OstringStream msg;
+		msg<<"Transformation of "<<dest.size()<<" vectors completed ";
+		for (SizeType i = 0; i < dest.size(); ++i) {
+			RealType norm2 = norm(*dest[i]);
+			if (fabs(norm1[i]-norm2)>1e-5)
+				msg<<"WARNING: vector "<<i<<" orig. norm= "<<norm1[i]<<" resulting norm= "<<norm2<<" ";
+
+			if (norm2 < 1e-5)
+				std::cerr << "WFT Factory: norm2 = " << norm2 << " < 1e-5\n";
+		}
+
+		progress_.printline(msg,std::cout);
+	}
+
 	void triggerOff(const LeftRightSuperType& lrs)
 	{
 		bool allow=false;
@@ -340,6 +373,12 @@ public:
 
 		PsimagLite::String label = "Wft";
 		writePartial(ioMain, label);
+		if (transformsBinary_) {
+			BlockRecordsOutType records(filenameOut_ + ".wft", transformsInFloat_);
+			waveStructCombined_.write(ioMain, label + "/WaveStructCombined", records);
+			return;
+		}
+
 		waveStructCombined_.write(ioMain, label + "/WaveStructCombined");
 	}
 
@@ -350,6 +389,12 @@ public:
 
 		PsimagLite::String label = "Wft";
 		writePartial(ioMain, label);
+		if (transformsBinary_) {
+			BlockRecordsOutType records(filenameOut_ + ".wft", transformsInFloat_);
+			waveStructCombined_.write(ioMain, label + "/WaveStructCombined", records);
+			return;
+		}
+
 		waveStructCombined_.write(ioMain, label + "/WaveStructCombined");
 	}
 
@@ -375,7 +420,14 @@ private:
 		PsimagLite::String label = "Wft";
 		ioMain.read(isEnabled_, label + "/isEnabled");
 		wftOptions_.read(ioMain, label + "/WftOptions");
-		waveStructCombined_.read(ioMain, label + "/WaveStructCombined");
+		PsimagLite::String records = blockRecordsFilename(ioMain,
+		                                                  label + "/WaveStructCombined");
+		if (records == "")
+			waveStructCombined_.read(ioMain, label + "/WaveStructCombined");
+		else
+			waveStructCombined_.read(ioMain,
+			                         label + "/WaveStructCombined",
+			                         BlockRecordsInType(records));
 		ioMain.close();
 	}
 
@@ -397,6 +449,28 @@ private:
 		wftOptions_.bounce = false;
 	}
 
+	bool isAllowed() const
+	{
+		bool allow=false;
+		switch (wftOptions_.dir) {
+		case ProgramGlobals::DirectionEnum::INFINITE:
+			allow=false;
+			break;
+		case ProgramGlobals::DirectionEnum::EXPAND_SYSTEM:
+			allow=true;
+
+		case ProgramGlobals::DirectionEnum::EXPAND_ENVIRON:
+			allow=true;
+		}
+
+		// FIXME: Must check the below change when using SU(2)!!
+		//if (m<0) allow = false; // isEnabled_=false;
+
+		if (noLoad_) allow = false;
+
+		return (isEnabled_ && allow);
+	}
+
 	void createVector(VectorWithOffsetType& psiDest,
 	                  const VectorWithOffsetType& psiSrc,
 	                  const LeftRightSuperType& lrs,
@@ -470,6 +544,8 @@ private:
 	PsimagLite::Random48<RealType> rng_;
 	bool noLoad_;
 	const bool save_;
+	const bool transformsInFloat_;
+	const bool transformsBinary_;
 	VectorSizeType sitesSeen_;
 }; // class WaveFunctionTransformation
 } // namespace Dmrg
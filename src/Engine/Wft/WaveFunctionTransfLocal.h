@@ -104,6 +104,10 @@ class WaveFunctionTransfLocal : public
 	typedef WaveFunctionTransfBase<DmrgWaveStructType,VectorWithOffsetType> BaseType;
 	typedef typename BaseType::VectorSizeType VectorSizeType;
 	typedef typename BaseType::PackIndicesType PackIndicesType;
+	typedef typename BaseType::VectorVectorWithOffsetPtrType VectorVectorWithOffsetPtrType;
+	typedef typename BaseType::VectorConstVectorWithOffsetPtrType
+	VectorConstVectorWithOffsetPtrType;
+	typedef typename PsimagLite::Vector<bool>::Type VectorBoolType;
 
 public:
 
@@ -168,6 +172,54 @@ public:
 		err("WFT Local: Stage is not EXPAND_ENVIRON or EXPAND_SYSTEM\n");
 	}
 
+	// With wftAccelPatches, past the first call and not bouncing, the
+	// sectors of all vectors with the same quantum numbers are transformed
+	// together, as columns of the same GEMMs. Else one vector at a time
+	virtual void transformVectors(const VectorVectorWithOffsetPtrType& psiDest,
+	                              const VectorConstVectorWithOffsetPtrType& psiSrc,
+	                              const LeftRightSuperType& lrs,
+	                              const VectorSizeType& nk) const
+	{
+		const bool batched = (wftOptions_.accel == WftOptionsType::ACCEL_PATCHES &&
+		                      !wftOptions_.firstCall &&
+		                      !wftOptions_.bounce &&
+		                      !wftOptions_.twoSiteDmrg &&
+		                      wftOptions_.dir != ProgramGlobals::DirectionEnum::INFINITE);
+		if (!batched || psiDest.size() < 2)
+			return BaseType::transformVectors(psiDest, psiSrc, lrs, nk);
+
+		PsimagLite::Profiling profiling("WFT", std::cout);
+
+		const SizeType nvectors = psiDest.size();
+		assert(psiSrc.size() == nvectors);
+		typename PsimagLite::Vector<VectorBoolType>::Type done(nvectors);
+		for (SizeType v = 0; v < nvectors; ++v)
+			done[v].resize(psiDest[v]->sectors(), false);
+
+		for (SizeType v = 0; v < nvectors; ++v) {
+			for (SizeType ii = 0; ii < psiDest[v]->sectors(); ++ii) {
+				if (done[v][ii]) continue;
+
+				const QnType& qn = psiDest[v]->qn(ii);
+				VectorVectorWithOffsetPtrType dests;
+				VectorSizeType iNew;
+				VectorConstVectorWithOffsetPtrType srcs;
+				VectorSizeType iOld;
+				for (SizeType w = v; w < nvectors; ++w) {
+					const SizeType jj = findSector(*psiDest[w], qn);
+					if (jj == psiDest[w]->sectors()) continue;
+					done[w][jj] = true;
+					dests.push_back(psiDest[w]);
+					iNew.push_back(jj);
+					srcs.push_back(psiSrc[w]);
+					iOld.push_back(findIold(*psiSrc[w], qn));
+				}
+
+				wftAccelPatches_(dests, iNew, srcs, iOld, lrs, nk, wftOptions_.dir);
+			}
+		}
+	}
+
 private:
 
 	void transformVector1(VectorWithOffsetType& psiDest,
@@ -454,6 +506,17 @@ private:
 		throw PsimagLite::RuntimeError("UNREACHABLE\n");
 	}
 
+	// index of the sector of v with quantum numbers qn, or v.sectors()
+	static SizeType findSector(const VectorWithOffsetType& v, const QnType& qn)
+	{
+		SizeType sectors = v.sectors();
+		for (SizeType i = 0; i < sectors; ++i)
+			if (v.qn(i) == qn)
+				return i;
+
+		return sectors;
+	}
+
 	const DmrgWaveStructType& dmrgWaveStruct_;
 	const WftOptionsType& wftOptions_;
 	WftAccelBlocksType wftAccelBlocks_;
@@ -33,6 +33,17 @@ public:
 		io.read(weStack_, prefix + "/weStack");
 	}
 
+	// Reads what write(io, prefix, records) wrote
+	template<typename BlockRecordsInType>
+	void read(PsimagLite::IoNg::In& io,
+	          PsimagLite::String prefix,
+	          const BlockRecordsInType& records)
+	{
+		lrs_.read(io, prefix);
+		readStack(wsStack_, io, prefix + "/wsStack", records);
+		readStack(weStack_, io, prefix + "/weStack", records);
+	}
+
 	void write(PsimagLite::IoNg::Out& io, PsimagLite::String prefix) const
 	{
 		writePartial(io, prefix);
@@ -49,6 +60,18 @@ public:
 		io.write(weStack_, prefix + "/weStack");
 	}
 
+	// The transforms go to records, see BlockRecords.h
+	template<typename BlockRecordsOutType>
+	void write(PsimagLite::IoNg::Out& io,
+	           PsimagLite::String prefix,
+	           BlockRecordsOutType& records) const
+	{
+		writePartial(io, prefix);
+		io.write(records.filename(), prefix + "/records");
+		writeStack(io, prefix + "/wsStack", wsStack_, records);
+		writeStack(io, prefix + "/weStack", weStack_, records);
+	}
+
 	void beforeWft(ProgramGlobals::DirectionEnum dir,
 	               bool twoSiteDmrg,
 	               bool bounce)
@@ -163,6 +186,38 @@ private:
 		lrs_.write(io, prefix, BasisWithOperatorsType::SaveEnum::ALL, false);
 	}
 
+	// bottom of the stack is 0, so that reading pushes in order
+	template<typename BlockRecordsOutType>
+	static void writeStack(PsimagLite::IoNg::Out& io,
+	                       PsimagLite::String label,
+	                       WftStackType stack,
+	                       BlockRecordsOutType& records)
+	{
+		const SizeType n = stack.size();
+		io.createGroup(label);
+		io.write(n, label + "/Size");
+		for (SizeType i = n; i > 0; --i) {
+			stack.top().write(io, label + "/" + ttos(i - 1), records);
+			stack.pop();
+		}
+	}
+
+	template<typename BlockRecordsInType>
+	static void readStack(WftStackType& stack,
+	                      PsimagLite::IoNg::In& io,
+	                      PsimagLite::String label,
+	                      const BlockRecordsInType& records)
+	{
+		SizeType n = 0;
+		io.read(n, label + "/Size");
+		while (stack.size() > 0) stack.pop();
+		for (SizeType i = 0; i < n; ++i) {
+			WaveStructSvdType wave;
+			wave.read(io, label + "/" + ttos(i), records);
+			stack.push(wave);
+		}
+	}
+
 	LeftRightSuperType lrs_;
 	WftStackType wsStack_;
 	WftStackType weStack_;
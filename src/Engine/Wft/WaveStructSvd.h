@@ -135,6 +135,20 @@ struct WaveStructSvd {
 		QnType::readVector(qns_, prefix + "/qns", io);
 	}
 
+	// Reads what write(io, prefix, records) wrote
+	template<typename BlockRecordsInType>
+	void read(PsimagLite::IoNg::In& io,
+	          PsimagLite::String prefix,
+	          const BlockRecordsInType& records)
+	{
+		SizeType record = 0;
+		u_.read(io, prefix + "/u", records, record, true);
+		io.read(record, prefix + "/vtsRecord");
+		records.read(vts_, record);
+		io.read(s_, prefix + "/s");
+		QnType::readVector(qns_, prefix + "/qns", io);
+	}
+
 	void write(PsimagLite::IoNg::Out& io, PsimagLite::String prefix) const
 	{
 		io.createGroup(prefix);
@@ -144,6 +158,20 @@ struct WaveStructSvd {
 		io.write(qns_, prefix + "/qns");
 	}
 
+	// u and vts go to records, see BlockRecords.h
+	template<typename BlockRecordsOutType>
+	void write(PsimagLite::IoNg::Out& io,
+	           PsimagLite::String prefix,
+	           BlockRecordsOutType& records) const
+	{
+		io.createGroup(prefix);
+		u_.write(prefix + "/u", io, records);
+		SizeType record = records.write(vts_);
+		io.write(record, prefix + "/vtsRecord");
+		io.write(s_, prefix + "/s");
+		io.write(qns_, prefix + "/qns");
+	}
+
 	void write(PsimagLite::String prefix, PsimagLite::IoNgSerializer& io) const
 	{
 		io.createGroup(prefix);
@@ -25,6 +25,10 @@ class WftAccelPatches {
 	typedef typename BlockDiagonalMatrixType::BuildingBlockType MatrixType;
 	typedef GenIjPatch<LeftRightSuperType> GenIjPatchType;
 	typedef BlockDiagWf<GenIjPatchType, VectorWithOffsetType> BlockDiagWfType;
+	typedef typename WaveFunctionTransfBaseType::VectorVectorWithOffsetPtrType
+	VectorVectorWithOffsetPtrType;
+	typedef typename WaveFunctionTransfBaseType::VectorConstVectorWithOffsetPtrType
+	VectorConstVectorWithOffsetPtrType;
 
 public:
 
@@ -54,6 +58,33 @@ public:
 		psi.toVectorWithOffsets(psiDest, iNew, lrs, nk, dir);
 	}
 
+	// Sector iOld[v] of *psiSrc[v] into sector iNew[v] of *psiDest[v], for
+	// all v at once; all sectors must have the same quantum numbers
+	void operator()(const VectorVectorWithOffsetPtrType& psiDest,
+	                const VectorSizeType& iNew,
+	                const VectorConstVectorWithOffsetPtrType& psiSrc,
+	                const VectorSizeType& iOld,
+	                const LeftRightSuperType& lrs,
+	                const VectorSizeType& nk,
+	                typename ProgramGlobals::DirectionEnum dir) const
+	{
+		char charLeft = (dir == ProgramGlobals::DirectionEnum::EXPAND_SYSTEM) ? 'C' : 'N';
+		char charRight = (dir == ProgramGlobals::DirectionEnum::EXPAND_SYSTEM) ? 'T' : 'N';
+		BlockDiagWfType psi(psiSrc,
+		                    iOld,
+		                    dmrgWaveStruct_.lrs());
+
+		psi.transform(charLeft,
+		              charRight,
+		              dmrgWaveStruct_.getTransform(ProgramGlobals::SysOrEnvEnum::SYSTEM),
+		              dmrgWaveStruct_.getTransform(ProgramGlobals::SysOrEnvEnum::ENVIRON));
+
+		const SizeType nvectors = psiDest.size();
+		assert(iNew.size() == nvectors);
+		for (SizeType v = 0; v < nvectors; ++v)
+			psi.toVectorWithOffsets(*psiDest[v], iNew[v], lrs, nk, dir, v);
+	}
+
 private:
 
 	const DmrgWaveStructType& dmrgWaveStruct_;
@@ -13,6 +13,10 @@ public:
 	typedef typename ModelType::ModelHelperType ModelHelperType;
 	typedef typename ModelHelperType::LeftRightSuperType LeftRightSuperType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename WaveFunctionTransfType::VectorVectorWithOffsetPtrType
+	VectorVectorWithOffsetPtrType;
+	typedef typename WaveFunctionTransfType::VectorConstVectorWithOffsetPtrType
+	VectorConstVectorWithOffsetPtrType;
 
 	WftHelper(const ModelType& model,
 	                const LeftRightSuperType& lrs,
@@ -20,19 +24,32 @@ public:
 	    : model_(model), lrs_(lrs), wft_(wft)
 	{}
 
+	// all in one call to the WFT, see WaveFunctionTransfBase::transformVectors
 	void wftSome(VectorVectorWithOffsetType& tvs,
 	             SizeType site,
 	             SizeType begin,
 	             SizeType end) const
 	{
-		for (SizeType index = begin; index < end; ++index) {
-			assert(index < tvs.size());
-			const VectorWithOffsetType& src = tvs[index];
-			if (src.size() == 0) continue;
-			VectorWithOffsetType phiNew;
-			wftOneVector(phiNew, src, site);
-			tvs[index] = phiNew;
+		assert(end <= tvs.size());
+		VectorVectorWithOffsetType phiNew(end - begin);
+		VectorVectorWithOffsetPtrType dest;
+		VectorConstVectorWithOffsetPtrType src;
+		VectorSizeType index;
+		for (SizeType i = begin; i < end; ++i) {
+			if (tvs[i].size() == 0) continue;
+			phiNew[i - begin].populateFromQns(tvs[i], lrs_.super());
+			dest.push_back(&phiNew[i - begin]);
+			src.push_back(&tvs[i]);
+			index.push_back(i);
 		}
+
+		if (dest.size() == 0) return;
+
+		VectorSizeType nk(1, model_.hilbertSize(site));
+		wft_.setInitialVectors(dest, src, lrs_, nk);
+
+		for (SizeType j = 0; j < index.size(); ++j)
+			tvs[index[j]] = phiNew[index[j] - begin];
 	}
 
 	void wftOneVector(VectorWithOffsetType& phiNew,
@@ -2,7 +2,7 @@
 #include "den_csr_kron_mult.cpp"
 #include "den_kron_mult.cpp"
 #include "csr_den_kron_mult.cpp"
-#ifndef USE_FLOAT
+#if !defined(USE_FLOAT) && !defined(KRON_UTIL_FLOAT)
 typedef double RealType;
 #else
 typedef float RealType;
@@ -54,5 +54,65 @@ void csr_den_kron_mult( const char transA,
 	                    typename PsimagLite::Vector<ComplexOrRealType>::Type& xout,
 	                    SizeType offsetX,
                         const typename PsimagLite::Real<ComplexOrRealType>::Type);
-#endif
 
+//-----------------------------------------------------------------------------------
+
+template<typename ComplexOrRealType>
+void estimate_kron_cost(const int nrow_A,
+                        const int ncol_A,
+                        const int nnz_A,
+                        const int nrow_B,
+                        const int ncol_B,
+                        const int nnz_B,
+                        ComplexOrRealType *p_kron_nnz,
+                        ComplexOrRealType *p_kron_flops,
+                        int *p_imethod,
+                        const typename PsimagLite::Real<ComplexOrRealType>::Type);
+
+//-----------------------------------------------------------------------------------
+
+// As the kernels above, but with the method of estimate_kron_cost given
+template<typename ComplexOrRealType>
+void csr_kron_mult_method(const int imethod,
+                          const char transA,
+                          const char transB,
+                          const PsimagLite::CrsMatrix<ComplexOrRealType>& a,
+                          const PsimagLite::CrsMatrix<ComplexOrRealType>& b,
+                          const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin,
+                          SizeType offsetY,
+                          typename PsimagLite::Vector<ComplexOrRealType>::Type& xout,
+                          SizeType offsetX);
+
+template<typename ComplexOrRealType>
+void den_csr_kron_mult_method(const int imethod,
+                              const char transA,
+                              const char transB,
+                              const PsimagLite::Matrix<ComplexOrRealType>& a_,
+                              const PsimagLite::CrsMatrix<ComplexOrRealType>& b,
+                              const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin,
+                              SizeType offsetY,
+                              typename PsimagLite::Vector<ComplexOrRealType>::Type& xout_,
+                              SizeType offsetX);
+
+template<typename ComplexOrRealType>
+void den_kron_mult_method(const int imethod,
+                          const char transA,
+                          const char transB,
+                          const PsimagLite::Matrix<ComplexOrRealType>& a_,
+                          const PsimagLite::Matrix<ComplexOrRealType>& b_,
+                          const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin,
+                          SizeType offsetY ,
+                          typename PsimagLite::Vector<ComplexOrRealType>::Type& xout,
+                          SizeType offsetX);
+
+template<typename ComplexOrRealType>
+void csr_den_kron_mult_method(const int imethod,
+                              const char transA,
+                              const char transB,
+                              const PsimagLite::CrsMatrix<ComplexOrRealType>& a_,
+                              const PsimagLite::Matrix<ComplexOrRealType>& b_,
+                              const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin_,
+                              SizeType offsetY ,
+                              typename PsimagLite::Vector<ComplexOrRealType>::Type& xout_,
+                              SizeType offsetX);
+#endif
@@ -0,0 +1,6 @@
+// Single precision instantiations of KronUtil.cpp, for the operators
+// of SolverOptions=KronSinglePrecision. With USE_FLOAT KronUtil.cpp has them
+#ifndef USE_FLOAT
+#define KRON_UTIL_FLOAT
+#include "KronUtil.cpp"
+#endif
@@ -68,6 +68,87 @@ void den_kron_mult(const char transA,
 	throw PsimagLite::RuntimeError(msg);
 }
 
+template<typename ComplexOrRealType>
+void estimate_kron_cost(const int,
+                        const int,
+                        const int,
+                        const int,
+                        const int,
+                        const int,
+                        ComplexOrRealType*,
+                        ComplexOrRealType*,
+                        int*,
+                        const typename PsimagLite::Real<ComplexOrRealType>::Type)
+{
+	PsimagLite::String msg("estimate_kron_cost: please #undefine DO_NOT_USE_KRON_UTIL");
+	msg += " and link against libkronutil\n";
+	throw PsimagLite::RuntimeError(msg);
+}
+
+template<typename ComplexOrRealType>
+void csr_kron_mult_method(const int,
+                          const char,
+                          const char,
+                          const PsimagLite::CrsMatrix<ComplexOrRealType>&,
+                          const PsimagLite::CrsMatrix<ComplexOrRealType>&,
+                          const typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                          SizeType,
+                          typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                          SizeType)
+{
+	PsimagLite::String msg("csr_kron_mult_method: please #undefine DO_NOT_USE_KRON_UTIL");
+	msg += " and link against libkronutil\n";
+	throw PsimagLite::RuntimeError(msg);
+}
+
+template<typename ComplexOrRealType>
+void den_csr_kron_mult_method(const int,
+                              const char,
+                              const char,
+                              const PsimagLite::Matrix<ComplexOrRealType>&,
+                              const PsimagLite::CrsMatrix<ComplexOrRealType>&,
+                              const typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                              SizeType,
+                              typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                              SizeType)
+{
+	PsimagLite::String msg("den_csr_kron_mult_method: please #undefine DO_NOT_USE_KRON_UTIL");
+	msg += " and link against libkronutil\n";
+	throw PsimagLite::RuntimeError(msg);
+}
+
+template<typename ComplexOrRealType>
+void den_kron_mult_method(const int,
+                          const char,
+                          const char,
+                          const PsimagLite::Matrix<ComplexOrRealType>&,
+                          const PsimagLite::Matrix<ComplexOrRealType>&,
+                          const typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                          SizeType,
+                          typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                          SizeType)
+{
+	PsimagLite::String msg("den_kron_mult_method: please #undefine DO_NOT_USE_KRON_UTIL");
+	msg += " and link against libkronutil\n";
+	throw PsimagLite::RuntimeError(msg);
+}
+
+template<typename ComplexOrRealType>
+void csr_den_kron_mult_method(const int,
+                              const char,
+                              const char,
+                              const PsimagLite::CrsMatrix<ComplexOrRealType>&,
+                              const PsimagLite::Matrix<ComplexOrRealType>&,
+                              const typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                              SizeType,
+                              typename PsimagLite::Vector<ComplexOrRealType>::Type&,
+                              SizeType)
+{
+	PsimagLite::String msg("csr_den_kron_mult_method: please #undefine DO_NOT_USE_KRON_UTIL");
+	msg += " and link against libkronutil\n";
+	throw PsimagLite::RuntimeError(msg);
+}
+
 #endif
 
 #endif // KRON_UTIL_WRAPPER_H
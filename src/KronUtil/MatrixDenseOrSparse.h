@@ -4,9 +4,26 @@
 #include "KronUtilWrapper.h"
 #include "Matrix.h"
 #include "CrsMatrix.h"
+#include "BLAS.h"
 
 namespace Dmrg {
 
+// Scalar type used for the operators with KronSinglePrecision
+template<typename T>
+struct LowerPrecision {
+	typedef T Type;
+};
+
+template<>
+struct LowerPrecision<double> {
+	typedef float Type;
+};
+
+template<>
+struct LowerPrecision<std::complex<double> > {
+	typedef std::complex<float> Type;
+};
+
 template<typename SparseMatrixType>
 class MatrixDenseOrSparse {
 
@@ -17,13 +34,17 @@ public:
 	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
 	typedef PsimagLite::Vector<int>::Type VectorIntType;
+	typedef typename LowerPrecision<ComplexOrRealType>::Type LowComplexOrRealType;
+	typedef MatrixDenseOrSparse<PsimagLite::CrsMatrix<LowComplexOrRealType> >
+	LowPrecisionType;
 
 	explicit MatrixDenseOrSparse(const SparseMatrixType& sparse,
 	                             const RealType& threshold)
 	    : isDense_(sparse.nonZeros() > static_cast<SizeType>(threshold*
 	                                                         sparse.rows()*
 	                                                         sparse.cols())),
-	      sparseMatrix_(sparse)
+	      sparseMatrix_(sparse),
+	      low_(0)
 	{
 		sparseMatrix_.checkValidity();
 
@@ -34,7 +55,7 @@ public:
 	explicit MatrixDenseOrSparse(const SizeType nrows,
 	                             const SizeType ncols,
 	                             bool  isDense_in )
-	    : isDense_( isDense_in ), sparseMatrix_(nrows,ncols), denseMatrix_(0,0)
+	    : isDense_( isDense_in ), sparseMatrix_(nrows,ncols), denseMatrix_(0,0), low_(0)
 	{
 		if (isDense_) {
 			denseMatrix_.clear();
@@ -45,6 +66,12 @@ public:
 		};
 	}
 
+	~MatrixDenseOrSparse()
+	{
+		delete low_;
+		low_ = 0;
+	}
+
 
 	void conjugate()
 	{
@@ -68,6 +95,8 @@ public:
 
 	const PsimagLite::Matrix<ComplexOrRealType>& dense() const
 	{
+		if (low_)
+			throw PsimagLite::RuntimeError("FATAL: Matrix is in lower precision\n");
 		if (!isDense_)
 			throw PsimagLite::RuntimeError("FATAL: Matrix isn't dense\n");
 		return denseMatrix_;
@@ -75,6 +104,8 @@ public:
 
 	const SparseMatrixType& sparse() const
 	{
+		if (low_)
+			throw PsimagLite::RuntimeError("FATAL: Matrix is in lower precision\n");
 		if (isDense_)
 			throw PsimagLite::RuntimeError("FATAL: Matrix isn't sparse\n");
 
@@ -117,12 +148,109 @@ public:
 		return( denseMatrix_ );
 	}
 
+	// Moves the values to dense storage if dense is true, and else to sparse
+	void setDense(bool dense)
+	{
+		if (low_)
+			throw PsimagLite::RuntimeError("FATAL: Matrix is in lower precision\n");
+		if (dense == isDense_) return;
+
+		const SizeType nrows = rows();
+		const SizeType ncols = cols();
+		if (dense) {
+			crsMatrixToFullMatrix(denseMatrix_, sparseMatrix_);
+			sparseMatrix_.resize(nrows, ncols);
+		} else {
+			sparseMatrix_ = SparseMatrixType(denseMatrix_);
+			denseMatrix_.clear();
+		}
+
+		isDense_ = dense;
+	}
+
+
+	// Moves the values to LowComplexOrRealType, keeping dense or sparse,
+	// and frees the ComplexOrRealType storage; rows() and cols() still work,
+	// but dense() and sparse() throw, use lowPrecision() instead
+	void toLowPrecision()
+	{
+		if (low_) return;
+
+		const SizeType nrows = rows();
+		const SizeType ncols = cols();
+		low_ = new LowPrecisionType(nrows, ncols, isDense_);
+		if (isDense_) {
+			PsimagLite::Matrix<LowComplexOrRealType>& m = low_->getDense();
+			for (SizeType j = 0; j < ncols; ++j)
+				for (SizeType i = 0; i < nrows; ++i)
+					m(i, j) = LowComplexOrRealType(denseMatrix_(i, j));
+
+			denseMatrix_.clear();
+			sparseMatrix_.resize(nrows, ncols);
+			return;
+		}
+
+		PsimagLite::CrsMatrix<LowComplexOrRealType>& m = low_->getSparse();
+		const SizeType nnz = sparseMatrix_.nonZeros();
+		m.resize(nrows, ncols, nnz);
+		for (SizeType i = 0; i < nrows; ++i)
+			m.setRow(i, sparseMatrix_.getRowPtr(i));
+		m.setRow(nrows, nnz);
+		for (SizeType k = 0; k < nnz; ++k) {
+			m.setCol(k, sparseMatrix_.getCol(k));
+			m.setValues(k, LowComplexOrRealType(sparseMatrix_.getValue(k)));
+		}
+
+		sparseMatrix_.resize(nrows, ncols);
+	}
+
+	bool isLowPrecision() const { return (low_ != 0); }
+
+	const LowPrecisionType& lowPrecision() const
+	{
+		assert(low_);
+		return *low_;
+	}
+
+	// d[i] = M(i, i), for square M, in either precision
+	void getDiagonal(VectorType& d) const
+	{
+		const SizeType n = rows();
+		d.resize(n);
+		if (low_) {
+			typename LowPrecisionType::VectorType dlow;
+			low_->getDiagonal(dlow);
+			for (SizeType i = 0; i < n; ++i)
+				d[i] = dlow[i];
+			return;
+		}
+
+		if (isDense_) {
+			for (SizeType i = 0; i < n; ++i)
+				d[i] = denseMatrix_(i, i);
+			return;
+		}
+
+		for (SizeType i = 0; i < n; ++i) {
+			d[i] = 0.0;
+			for (int k = sparseMatrix_.getRowPtr(i); k < sparseMatrix_.getRowPtr(i + 1); ++k) {
+				if (static_cast<SizeType>(sparseMatrix_.getCol(k)) != i) continue;
+				d[i] = sparseMatrix_.getValue(k);
+				break;
+			}
+		}
+	}
 
 private:
 
+	MatrixDenseOrSparse(const MatrixDenseOrSparse&);
+
+	MatrixDenseOrSparse& operator=(const MatrixDenseOrSparse&);
+
 	bool isDense_;
 	PsimagLite::CrsMatrix<ComplexOrRealType> sparseMatrix_;
 	PsimagLite::Matrix<ComplexOrRealType> denseMatrix_;
+	LowPrecisionType* low_;
 }; // class MatrixDenseOrSparse
 
 template<typename SparseMatrixType>
@@ -190,5 +318,129 @@ void kronMult(typename PsimagLite::Vector<typename SparseMatrixType::value_type>
 	};
 } // kron_mult
 
+// As kronMult, but with the method of estimate_kron_cost given;
+// imethod == 0 is kronMult
+template<typename SparseMatrixType>
+void kronMultMethod(int imethod,
+                    typename PsimagLite::Vector<typename SparseMatrixType::value_type>::Type& xout,
+                    SizeType offsetX,
+                    const typename PsimagLite::Vector<typename SparseMatrixType::value_type>::Type& yin,
+                    SizeType offsetY,
+                    char transA,
+                    char transB,
+                    const MatrixDenseOrSparse<SparseMatrixType>& A,
+                    const MatrixDenseOrSparse<SparseMatrixType>& B,
+                    const typename PsimagLite::Real<typename SparseMatrixType::value_type>::Type
+                    denseFlopDiscount)
+{
+	if (imethod == 0)
+		return kronMult(xout, offsetX, yin, offsetY, transA, transB, A, B, denseFlopDiscount);
+
+	if (A.isDense()) {
+		if (B.isDense())
+			den_kron_mult_method(imethod, transA, transB, A.dense(), B.dense(),
+			                     yin, offsetY, xout, offsetX);
+		else
+			den_csr_kron_mult_method(imethod, transA, transB, A.dense(), B.sparse(),
+			                         yin, offsetY, xout, offsetX);
+	} else {
+		if (B.isDense())
+			csr_den_kron_mult_method(imethod, transA, transB, A.sparse(), B.dense(),
+			                         yin, offsetY, xout, offsetX);
+		else
+			csr_kron_mult_method(imethod, transA, transB, A.sparse(), B.sparse(),
+			                     yin, offsetY, xout, offsetX);
+	}
+}
+
+// X_v += kron(op(A), op(B)) * Y_v for v = 0, ..., k - 1, where the k vectors
+// of a patch are contiguous: X_v at offsetX + v*size(X_v), and Y_v at
+// offsetY + v*size(Y_v). If A and B are dense, A and B are each used by one
+// GEMM that covers all k vectors; otherwise this is k calls to kronMult
+template<typename SparseMatrixType>
+void kronMultMulti(typename PsimagLite::Vector<typename SparseMatrixType::value_type>::Type& xout,
+                   SizeType offsetX,
+                   const typename PsimagLite::Vector<typename SparseMatrixType::value_type>::Type& yin,
+                   SizeType offsetY,
+                   SizeType k,
+                   char transA,
+                   char transB,
+                   const MatrixDenseOrSparse<SparseMatrixType>& A,
+                   const MatrixDenseOrSparse<SparseMatrixType>& B,
+                   const typename PsimagLite::Real<typename SparseMatrixType::value_type>::Type
+                   denseFlopDiscount)
+{
+	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+
+	const bool isComplex = PsimagLite::IsComplexNumber<ComplexOrRealType>::True;
+	const bool noTransA = (transA == 'n' || transA == 'N');
+	const bool noTransB = (transB == 'n' || transB == 'N');
+	const SizeType rA = (noTransA) ? A.rows() : A.cols();
+	const SizeType cA = (noTransA) ? A.cols() : A.rows();
+	const SizeType rB = (noTransB) ? B.rows() : B.cols();
+	const SizeType cB = (noTransB) ? B.cols() : B.rows();
+
+	// GEMM has no conjugate without transpose, needed for op(A)^T
+	const bool gemm = (k > 1 && A.isDense() && B.isDense() &&
+	                   (noTransA || !isComplex) &&
+	                   rA*cA*rB*cB > 0);
+
+	if (!gemm) {
+		for (SizeType v = 0; v < k; ++v)
+			kronMult(xout,
+			         offsetX + v*rA*rB,
+			         yin,
+			         offsetY + v*cA*cB,
+			         transA,
+			         transB,
+			         A,
+			         B,
+			         denseFlopDiscount);
+		return;
+	}
+
+	const PsimagLite::Matrix<ComplexOrRealType>& a = A.dense();
+	const PsimagLite::Matrix<ComplexOrRealType>& b = B.dense();
+	const char opA = (noTransA) ? 'T' : 'N'; // GEMM op for op(A)^T
+	const char opB = (noTransB) ? 'N' : ((transB == 'c' || transB == 'C') ? 'C' : 'T');
+	const ComplexOrRealType one = 1.0;
+	const ComplexOrRealType zero = 0.0;
+
+	// same choice as estimate_kron_cost between op(B)*Y first or Y*op(A)^T first
+	const long double flopsBY = static_cast<long double>(rB)*cB*cA*k +
+	        static_cast<long double>(rB)*cA*rA*k;
+	const long double flopsYAt = static_cast<long double>(cB)*cA*rA*k +
+	        static_cast<long double>(rB)*cB*rA*k;
+
+	if (flopsBY <= flopsYAt) {
+		// [BY_1 ... BY_k] = op(B)*[Y_1 ... Y_k], then X_v += BY_v*op(A)^T
+		VectorType by(rB*cA*k);
+		psimag::BLAS::GEMM(opB, 'N', rB, cA*k, cB, one,
+		                   &(b(0, 0)), b.rows(),
+		                   &(yin[offsetY]), cB,
+		                   zero, &(by[0]), rB);
+		for (SizeType v = 0; v < k; ++v)
+			psimag::BLAS::GEMM('N', opA, rB, rA, cA, one,
+			                   &(by[v*rB*cA]), rB,
+			                   &(a(0, 0)), a.rows(),
+			                   one, &(xout[offsetX + v*rA*rB]), rB);
+		return;
+	}
+
+	// YAt_v = Y_v*op(A)^T, then [X_1 ... X_k] += op(B)*[YAt_1 ... YAt_k]
+	VectorType yat(cB*rA*k);
+	for (SizeType v = 0; v < k; ++v)
+		psimag::BLAS::GEMM('N', opA, cB, rA, cA, one,
+		                   &(yin[offsetY + v*cA*cB]), cB,
+		                   &(a(0, 0)), a.rows(),
+		                   zero, &(yat[v*cB*rA]), cB);
+
+	psimag::BLAS::GEMM(opB, 'N', rB, rA*k, cB, one,
+	                   &(b(0, 0)), b.rows(),
+	                   &(yat[0]), cB,
+	                   one, &(xout[offsetX]), rB);
+} // kronMultMulti
+
 } // namespace Dmrg
 #endif // MATRIXDENSEORSPARSE_H
@@ -28,7 +28,7 @@
 #include "den_kron_form.cpp"
 #include "den_kron_form_general.cpp"
 
-#ifndef USE_FLOAT
+#if !defined(USE_FLOAT) && !defined(KRON_UTIL_FLOAT)
 typedef double RealType;
 #else
 typedef float RealType;
@@ -84,6 +84,17 @@ void csr_kron_mult_method<RealType>(const int imethod,
                           const PsimagLite::MatrixNonOwned<const RealType>& yin,
                           PsimagLite::MatrixNonOwned<RealType>& xout);
 
+template
+void csr_kron_mult_method<RealType>(const int imethod,
+                          const char transA,
+                          const char transB,
+                          const PsimagLite::CrsMatrix<RealType>& a,
+                          const PsimagLite::CrsMatrix<RealType>& b,
+                          const PsimagLite::Vector<RealType>::Type& yin,
+                          SizeType offsetY,
+                          PsimagLite::Vector<RealType>::Type& xout,
+                          SizeType offsetX);
+
 
 
 template
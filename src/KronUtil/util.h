@@ -20,19 +20,6 @@ void estimate_kron_cost( const int nrow_A,
                          int *p_imethod,
                          const typename PsimagLite::Real<ComplexOrRealType>::Type);
 
-template<typename ComplexOrRealType>
-void csr_den_kron_mult_method(const int imethod,
-                              const char transA,
-                              const char transB,
-
-                              const PsimagLite::CrsMatrix<ComplexOrRealType>& a_,
-                              const PsimagLite::Matrix<ComplexOrRealType>& b_,
-
-                              const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin_,
-                              SizeType offsetY ,
-                              typename PsimagLite::Vector<ComplexOrRealType>::Type& xout_,
-                              SizeType offsetX);
-
 template<typename ComplexOrRealType>
 bool csr_is_eye(const PsimagLite::CrsMatrix<ComplexOrRealType>&);
 
@@ -180,17 +167,6 @@ void coord2csr(const int nrow_A,
                int acol[],
                ComplexOrRealType aval[] );
 
-template<typename ComplexOrRealType>
-void den_csr_kron_mult_method(const int imethod,
-                              const char transA,
-                              const char transB,
-                              const PsimagLite::Matrix<ComplexOrRealType>& a_,
-                              const PsimagLite::CrsMatrix<ComplexOrRealType>& b,
-                              const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin,
-                              SizeType offsetY,
-                              typename PsimagLite::Vector<ComplexOrRealType>::Type& xout_,
-                              SizeType offsetX);
-
 void den_copymat( const int nrow, 
                   const int ncol,
                   const int asrc_[],
@@ -251,17 +227,6 @@ void den_kron_submatrix(
         const PsimagLite::Vector<int>::Type& cindex,
         PsimagLite::Matrix<ComplexOrRealType>& c_ );
 
-template<typename ComplexOrRealType>
-void den_kron_mult_method(const int imethod,
-                          const char transA,
-                          const char transB,
-                          const PsimagLite::Matrix<ComplexOrRealType>& a_,
-                          const PsimagLite::Matrix<ComplexOrRealType>& b_,
-                          const typename PsimagLite::Vector<ComplexOrRealType>::Type& yin,
-                          SizeType offsetY ,
-                          typename PsimagLite::Vector<ComplexOrRealType>::Type& xout,
-                          SizeType offsetX);
-
 template<typename ComplexOrRealType>
 int den_nnz(const PsimagLite::Matrix<ComplexOrRealType>&);
 
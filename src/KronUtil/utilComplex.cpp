@@ -29,7 +29,7 @@
 #include "den_kron_form.cpp"
 #include "den_kron_form_general.cpp"
 
-#ifndef USE_FLOAT
+#if !defined(USE_FLOAT) && !defined(KRON_UTIL_FLOAT)
 typedef double RealType;
 #else
 typedef float RealType;
@@ -85,6 +85,17 @@ void csr_kron_mult_method<std::complex<RealType> >(const int imethod,
                           const PsimagLite::MatrixNonOwned<const std::complex<RealType> >& yin,
                           PsimagLite::MatrixNonOwned<std::complex<RealType> >& xout);
 
+template
+void csr_kron_mult_method<std::complex<RealType> >(const int imethod,
+                          const char transA,
+                          const char transB,
+                          const PsimagLite::CrsMatrix<std::complex<RealType> >& a,
+                          const PsimagLite::CrsMatrix<std::complex<RealType> >& b,
+                          const PsimagLite::Vector<std::complex<RealType> >::Type& yin,
+                          SizeType offsetY,
+                          PsimagLite::Vector<std::complex<RealType> >::Type& xout,
+                          SizeType offsetX);
+
 
 
 template
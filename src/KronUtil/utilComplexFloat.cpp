@@ -0,0 +1,6 @@
+// Single precision instantiations of utilComplex.cpp, for the operators
+// of SolverOptions=KronSinglePrecision. With USE_FLOAT utilComplex.cpp has them
+#ifndef USE_FLOAT
+#define KRON_UTIL_FLOAT
+#include "utilComplex.cpp"
+#endif
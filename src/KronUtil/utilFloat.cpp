@@ -0,0 +1,6 @@
+// Single precision instantiations of util.cpp, for the operators
+// of SolverOptions=KronSinglePrecision. With USE_FLOAT util.cpp has them
+#ifndef USE_FLOAT
+#define KRON_UTIL_FLOAT
+#include "util.cpp"
+#endif
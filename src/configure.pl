@@ -64,11 +64,14 @@ my %observeDriver = (name => 'observe', dotos => $dotos);
 my %observeDriver0 = (name => 'ObserveDriver0', aux => 1);
 my %observeDriver1 = (name => 'ObserveDriver1', aux => 1);
 my %observeDriver2 = (name => 'ObserveDriver2', aux => 1);
+my %kronReplayDriver = (name => 'kronReplay',
+                        dotos => 'kronReplay.o ProgramGlobals.o Provenance.o Utils.o Su2Related.o Qn.o',
+                        libs => "kronutil");
 
 my @drivers = (\%provenanceDriver,\%su2RelatedDriver,
 \%progGlobalsDriver,\%finiteLoopDriver,\%utilsDriver,
 \%qnDriver, \%observeDriver,\%toolboxDriver,
-\%observeDriver0,\%observeDriver1,\%observeDriver2);
+\%observeDriver0,\%observeDriver1,\%observeDriver2,\%kronReplayDriver);
 
 $dotos = "dmrg.o Provenance.o FiniteLoop.o Utils.o Qn.o ";
 $dotos .= " ProgramGlobals.o Su2Related.o";
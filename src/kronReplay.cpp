@@ -0,0 +1,292 @@
+#include <iostream>
+#include <unistd.h>
+#define USE_PTHREADS_OR_NOT_NG
+#include "PsimagLite.h"
+#include "ProgressIndicator.h"
+#include "Io/IoNg.h"
+#include "InputNg.h"
+#include "InputCheck.h"
+#include "ParametersDmrgSolver.h"
+#include "Geometry/Geometry.h"
+#include "ModelSelector.h"
+#include "ModelBase.h"
+#include "ModelHelperLocal.h"
+#include "BasisWithOperators.h"
+#include "LeftRightSuper.h"
+#include "Operators.h"
+#include "CrsMatrix.h"
+#include "MatrixVectorStored.h"
+#include "MatrixVectorOnTheFly.h"
+#include "MatrixVectorKron/MatrixVectorKron.h"
+
+#ifndef USE_FLOAT
+typedef double RealType;
+#else
+typedef float RealType;
+#endif
+typedef PsimagLite::Concurrency ConcurrencyType;
+typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+typedef PsimagLite::InputNg<Dmrg::InputCheck> InputNgType;
+typedef Dmrg::ParametersDmrgSolver<RealType,
+InputNgType::Readable,
+Dmrg::Qn> ParametersDmrgSolverType;
+
+void usage(const PsimagLite::String& name)
+{
+	std::cerr<<"USAGE is "<<name<<" -f input.inp -k kroneckerDumperN.hd5";
+	std::cerr<<" [-t threads] [-r repetitions] [-e tolerance] [-p precision]\n";
+}
+
+struct ReplayOptions {
+
+	ReplayOptions()
+	    : repetitions(10), tolerance(1e-8)
+	{}
+
+	PsimagLite::String inputfile;
+	PsimagLite::String dumpfile;
+	VectorSizeType threads;
+	SizeType repetitions;
+	RealType tolerance;
+};
+
+// 1,2,4 to a vector
+void readThreads(VectorSizeType& threads, PsimagLite::String str)
+{
+	threads.clear();
+	PsimagLite::String::size_type begin = 0;
+	while (begin < str.length()) {
+		PsimagLite::String::size_type end = str.find(',', begin);
+		if (end == PsimagLite::String::npos) end = str.length();
+		const int n = atoi(str.substr(begin, end - begin).c_str());
+		if (n <= 0) err("kronReplay: threads must be positive, not " + str + "\n");
+		threads.push_back(n);
+		begin = end + 1;
+	}
+}
+
+// the dumped vector if there is one, else a fixed one
+template<typename VectorType>
+void initialVector(VectorType& y, const VectorType& dumped, SizeType n)
+{
+	if (dumped.size() == n) {
+		y = dumped;
+		return;
+	}
+
+	y.resize(n);
+	for (SizeType i = 0; i < n; ++i)
+		y[i] = 1.0/(1.0 + (i % 7));
+}
+
+template<typename VectorType>
+typename PsimagLite::Real<typename VectorType::value_type>::Type
+maxDifference(const VectorType& a, const VectorType& b)
+{
+	typedef typename PsimagLite::Real<typename VectorType::value_type>::Type RealType1;
+	RealType1 maxDiff = 0;
+	RealType1 maxA = 0;
+	for (SizeType i = 0; i < a.size(); ++i) {
+		maxDiff = std::max(maxDiff, static_cast<RealType1>(std::abs(a[i] - b[i])));
+		maxA = std::max(maxA, static_cast<RealType1>(std::abs(a[i])));
+	}
+
+	return (maxA > 0) ? maxDiff/maxA : maxDiff;
+}
+
+// x = H*y once, for the check, and then seconds per product
+template<typename MatrixVectorType, typename VectorType>
+RealType timeProducts(VectorType& x,
+                      const MatrixVectorType& matrix,
+                      const VectorType& y,
+                      SizeType repetitions)
+{
+	x.resize(y.size());
+	std::fill(x.begin(), x.end(), 0.0);
+	matrix.matrixVectorProduct(x, y);
+
+	VectorType tmp(y.size(), 0.0);
+	const PsimagLite::MemoryUsage::TimeHandle time1 = PsimagLite::ProgressIndicator::time();
+	for (SizeType r = 0; r < repetitions; ++r)
+		matrix.matrixVectorProduct(tmp, y);
+	const PsimagLite::MemoryUsage::TimeHandle time2 = PsimagLite::ProgressIndicator::time();
+	const PsimagLite::MemoryUsage::TimeHandle deltaTime = time2 - time1;
+
+	return 1e-3*deltaTime.millis()/repetitions;
+}
+
+template<typename MySparseMatrix>
+int main1(InputNgType::Readable& io,
+          const ParametersDmrgSolverType& params,
+          const ReplayOptions& options)
+{
+	typedef typename MySparseMatrix::value_type ComplexOrRealType;
+	typedef PsimagLite::Geometry<ComplexOrRealType,
+	        InputNgType::Readable,
+	        Dmrg::ProgramGlobals> GeometryType;
+	typedef Dmrg::Basis<MySparseMatrix> BasisType;
+	typedef Dmrg::Operators<BasisType> OperatorsType;
+	typedef Dmrg::BasisWithOperators<OperatorsType> BasisWithOperatorsType;
+	typedef Dmrg::LeftRightSuper<BasisWithOperatorsType,BasisType> LeftRightSuperType;
+	typedef Dmrg::ModelHelperLocal<LeftRightSuperType> ModelHelperType;
+	typedef Dmrg::ModelBase<ModelHelperType,
+	        ParametersDmrgSolverType,
+	        InputNgType::Readable,
+	        GeometryType> ModelBaseType;
+	typedef typename ModelBaseType::HamiltonianConnectionType HamiltonianConnectionType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+
+	GeometryType geometry(io);
+	Dmrg::ModelSelector<ModelBaseType> modelSelector(params.model);
+	const ModelBaseType& model = modelSelector(params, io, geometry);
+
+	PsimagLite::IoNg::In ioDump(options.dumpfile);
+	SizeType partition = 0;
+	RealType targetTime = 0;
+	VectorType dumped;
+	ioDump.read(partition, "KroneckerDumper/Partition");
+	ioDump.read(targetTime, "KroneckerDumper/TargetTime");
+	ioDump.read(dumped, "KroneckerDumper/Vector");
+	LeftRightSuperType lrs("pSprime", "pEprime", "pSE");
+	lrs.read(ioDump, "KroneckerDumper");
+
+	HamiltonianConnectionType hc(partition,
+	                             lrs,
+	                             geometry,
+	                             model.modelLinks(),
+	                             targetTime,
+	                             0);
+
+	// the engine classes, as the ground state solver builds them
+	PsimagLite::ProgressIndicator progress("kronReplay");
+	Dmrg::MatrixVectorStored<ModelBaseType> stored(model, hc);
+	Dmrg::MatrixVectorOnTheFly<ModelBaseType> onTheFly(model, hc);
+	Dmrg::MatrixVectorKron<ModelBaseType> kron(model, hc);
+
+	const SizeType n = hc.modelHelper().size();
+	PsimagLite::OstringStream msg;
+	msg<<options.dumpfile<<": partition="<<partition<<" size="<<n;
+	msg<<" connections="<<hc.tasks();
+	progress.printline(msg, std::cout);
+
+	VectorType y;
+	initialVector(y, dumped, n);
+
+	// results with the most threads, Stored is the reference
+	const SizeType nmethods = 3;
+	const char* names[] = {"Stored", "OnTheFly", "Kron"};
+	typename PsimagLite::Vector<VectorType>::Type x(nmethods);
+	typename PsimagLite::Vector<RealType>::Type firstTime(nmethods, 0);
+
+	std::cout<<"Method Threads Seconds Speedup\n";
+	for (SizeType t = 0; t < options.threads.size(); ++t) {
+		ConcurrencyType::codeSectionParams.npthreads = options.threads[t];
+		for (SizeType m = 0; m < nmethods; ++m) {
+			RealType seconds = 0;
+			if (m == 0)
+				seconds = timeProducts(x[m], stored, y, options.repetitions);
+			else if (m == 1)
+				seconds = timeProducts(x[m], onTheFly, y, options.repetitions);
+			else
+				seconds = timeProducts(x[m], kron, y, options.repetitions);
+
+			if (t == 0) firstTime[m] = seconds;
+			const RealType speedup = (seconds > 0) ? firstTime[m]/seconds : 0;
+			std::cout<<names[m]<<" "<<options.threads[t]<<" ";
+			std::cout<<seconds<<" "<<speedup<<"\n";
+		}
+	}
+
+	int status = 0;
+	for (SizeType m = 1; m < nmethods; ++m) {
+		const RealType diff = maxDifference(x[0], x[m]);
+		const bool ok = (diff <= options.tolerance);
+		std::cout<<"Check "<<names[m]<<" against "<<names[0]<<": relative difference ";
+		std::cout<<diff<<((ok) ? " OK" : " FAILED")<<"\n";
+		if (!ok) status = 1;
+	}
+
+	return status;
+}
+
+/* PSIDOC KronReplayDriver
+ kronReplay times the superblock matrix vector product on the binary file
+ kroneckerDumperN.hd5 that SolverOptions=KroneckerDumper writes together
+ with kroneckerDumperN.txt. It builds the model from the input file of the
+ run that wrote the dump, and the superblock and symmetry sector from the
+ dump, and then does the product with MatrixVectorStored,
+ MatrixVectorOnTheFly and MatrixVectorKron, as the ground state solver
+ would. MaxMatrixRankStored is ignored, so that the last two do not store
+ the matrix. For each class and each number of threads it prints the seconds
+ per product and the speedup over the first number of threads, and checks
+ the three results against each other.
+ The command line arguments of kronReplay are the following.
+  \begin{itemize}
+  \item[-f] {[}Mandatory, String{]} The input file of the run that wrote
+  the dump.
+  \item[-k] {[}Mandatory, String{]} The kroneckerDumperN.hd5 file.
+  \item[-t] {[}Optional, String{]} Comma separated numbers of threads,
+  default 1.
+  \item[-r] {[}Optional, Integer{]} Products timed, default 10.
+  \item[-e] {[}Optional, Real{]} Largest relative difference allowed between
+  results, default 1e-8; larger ones make the exit status 1.
+  \item[-p] [Optional, Integer] Digits of precision for printing.
+  \end{itemize}
+*/
+int main(int argc, char **argv)
+{
+	PsimagLite::PsiApp application("kronReplay", &argc, &argv, 1);
+	ReplayOptions options;
+	options.threads.push_back(1);
+	int opt = 0;
+	while ((opt = getopt(argc, argv,"f:k:t:r:e:p:")) != -1) {
+		switch (opt) {
+		case 'f':
+			options.inputfile = optarg;
+			break;
+		case 'k':
+			options.dumpfile = optarg;
+			break;
+		case 't':
+			readThreads(options.threads, optarg);
+			break;
+		case 'r':
+			options.repetitions = atoi(optarg);
+			break;
+		case 'e':
+			options.tolerance = atof(optarg);
+			break;
+		case 'p':
+			std::cout.precision(atoi(optarg));
+			break;
+		default:
+			usage(application.name());
+			return 1;
+		}
+	}
+
+	if (options.inputfile == "" || options.dumpfile == "" || options.repetitions == 0) {
+		usage(application.name());
+		return 1;
+	}
+
+	Dmrg::InputCheck inputCheck;
+	InputNgType::Writeable ioWriteable(options.inputfile, inputCheck);
+	InputNgType::Readable io(ioWriteable);
+	ParametersDmrgSolverType params(io, "", false);
+	params.maxMatrixRankStored = 0;
+
+	PsimagLite::CodeSectionParams codeSection(params.nthreads, false, 0);
+	ConcurrencyType::setOptions(codeSection);
+
+	SizeType isComplex = 0;
+	{
+		PsimagLite::IoNg::In ioDump(options.dumpfile);
+		ioDump.read(isComplex, "KroneckerDumper/IsComplex");
+	}
+
+	if (isComplex > 0)
+		return main1<PsimagLite::CrsMatrix<std::complex<RealType> > >(io, params, options);
+
+	return main1<PsimagLite::CrsMatrix<RealType> >(io, params, options);
+}